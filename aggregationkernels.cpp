@@ -0,0 +1,210 @@
+#include "aggregationkernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AGGREGATION_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(AGGREGATION_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define AGGREGATION_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AGGREGATION_TARGET_AVX2
+#endif
+
+/**
+ * @file aggregationkernels.cpp
+ * @brief Scalar and AVX2 implementations of the aggregation kernels plus the runtime dispatch.
+ */
+
+namespace {
+
+    /**
+     * @brief Portable version of sumByTwoCodes.
+     *
+     * Keeps two independent accumulator pairs so consecutive rows do not wait on
+     * each other's additions.
+     */
+    void sumByTwoCodesScalar(const std::uint32_t* codes, const std::int64_t* amounts, std::size_t count,
+        std::uint32_t firstCode, std::uint32_t secondCode, std::int64_t& firstSum, std::int64_t& secondSum) {
+        std::int64_t first[2] = { 0, 0 };
+        std::int64_t second[2] = { 0, 0 };
+        std::size_t row = 0;
+        for (; row + 2 <= count; row += 2) {
+            for (int lane = 0; lane < 2; ++lane) {
+                // Branch-free: the comparisons select the amount or zero
+                first[lane] += (codes[row + lane] == firstCode) ? amounts[row + lane] : 0;
+                second[lane] += (codes[row + lane] == secondCode) ? amounts[row + lane] : 0;
+            }
+        }
+        for (; row < count; ++row) {
+            first[0] += (codes[row] == firstCode) ? amounts[row] : 0;
+            second[0] += (codes[row] == secondCode) ? amounts[row] : 0;
+        }
+        firstSum = first[0] + first[1];
+        secondSum = second[0] + second[1];
+    }
+
+    /**
+     * @brief Portable version of sumByKeyWhere.
+     */
+    void sumByKeyWhereScalar(const std::uint32_t* codes, const std::uint32_t* keys, const std::int64_t* amounts,
+        std::size_t count, std::uint32_t filterCode, std::int64_t* bins, std::uint64_t* counts) {
+        for (std::size_t row = 0; row < count; ++row) {
+            if (codes[row] == filterCode) {
+                bins[keys[row]] += amounts[row];
+                counts[keys[row]]++;
+            }
+        }
+    }
+
+#if defined(AGGREGATION_KERNELS_X86)
+
+    /**
+     * @brief AVX2 version of sumByTwoCodes.
+     *
+     * Handles four rows per step: the four 32-bit codes are compared against both
+     * codes at once, widened to 64-bit lane masks and used to select the matching
+     * amounts into two 64-bit integer vector accumulators.
+     */
+    AGGREGATION_TARGET_AVX2
+    void sumByTwoCodesAvx2(const std::uint32_t* codes, const std::int64_t* amounts, std::size_t count,
+        std::uint32_t firstCode, std::uint32_t secondCode, std::int64_t& firstSum, std::int64_t& secondSum) {
+        const __m128i firstKey = _mm_set1_epi32(static_cast<int>(firstCode));
+        const __m128i secondKey = _mm_set1_epi32(static_cast<int>(secondCode));
+        __m256i firstAcc = _mm256_setzero_si256();
+        __m256i secondAcc = _mm256_setzero_si256();
+
+        std::size_t row = 0;
+        for (; row + 4 <= count; row += 4) {
+            __m128i code = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + row));
+            __m256i amount = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + row));
+            // Sign-extending the all-ones 32-bit compare result gives an all-ones 64-bit lane
+            __m256i firstMask = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(code, firstKey));
+            __m256i secondMask = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(code, secondKey));
+            firstAcc = _mm256_add_epi64(firstAcc, _mm256_and_si256(amount, firstMask));
+            secondAcc = _mm256_add_epi64(secondAcc, _mm256_and_si256(amount, secondMask));
+        }
+
+        // Reduce the four lanes of each accumulator
+        alignas(32) std::int64_t firstLanes[4];
+        alignas(32) std::int64_t secondLanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(firstLanes), firstAcc);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(secondLanes), secondAcc);
+        std::int64_t first = firstLanes[0] + firstLanes[1] + firstLanes[2] + firstLanes[3];
+        std::int64_t second = secondLanes[0] + secondLanes[1] + secondLanes[2] + secondLanes[3];
+
+        // Remaining rows that do not fill a vector
+        for (; row < count; ++row) {
+            first += (codes[row] == firstCode) ? amounts[row] : 0;
+            second += (codes[row] == secondCode) ? amounts[row] : 0;
+        }
+        firstSum = first;
+        secondSum = second;
+    }
+
+    /**
+     * @brief AVX2 version of sumByKeyWhere.
+     *
+     * Compares eight codes per step and skips the whole block when none match;
+     * matching rows are then scattered into their bins one by one, since AVX2 has
+     * no conflict-free scatter.
+     */
+    AGGREGATION_TARGET_AVX2
+    void sumByKeyWhereAvx2(const std::uint32_t* codes, const std::uint32_t* keys, const std::int64_t* amounts,
+        std::size_t count, std::uint32_t filterCode, std::int64_t* bins, std::uint64_t* counts) {
+        const __m256i filterKey = _mm256_set1_epi32(static_cast<int>(filterCode));
+
+        std::size_t row = 0;
+        for (; row + 8 <= count; row += 8) {
+            __m256i code = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes + row));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(code, filterKey))));
+            while (mask != 0) {
+                // Visit the matching lanes from lowest to highest
+                unsigned lane = 0;
+                while (((mask >> lane) & 1u) == 0) {
+                    ++lane;
+                }
+                mask &= mask - 1;
+                bins[keys[row + lane]] += amounts[row + lane];
+                counts[keys[row + lane]]++;
+            }
+        }
+        sumByKeyWhereScalar(codes + row, keys + row, amounts + row, count - row, filterCode, bins, counts);
+    }
+
+    /**
+     * @brief Checks whether the CPU and the operating system support AVX2.
+     */
+    bool cpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6; // OSXSAVE and YMM state enabled
+        bool hasAvx = (info[2] & (1 << 28)) != 0;
+        __cpuidex(info, 7, 0);
+        bool hasAvx2 = (info[1] & (1 << 5)) != 0;
+        return osSavesYmm && hasAvx && hasAvx2;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif // AGGREGATION_KERNELS_X86
+
+    const AggregationKernels::KernelSet ScalarKernels = { &sumByTwoCodesScalar, &sumByKeyWhereScalar, "scalar" };
+#if defined(AGGREGATION_KERNELS_X86)
+    const AggregationKernels::KernelSet Avx2Kernels = { &sumByTwoCodesAvx2, &sumByKeyWhereAvx2, "avx2" };
+#endif
+
+    /**
+     * @brief Detects the CPU features once and returns the matching kernels.
+     */
+    const AggregationKernels::KernelSet& kernels() {
+        static const AggregationKernels::KernelSet& table = []() -> const AggregationKernels::KernelSet& {
+#if defined(AGGREGATION_KERNELS_X86)
+            if (cpuSupportsAvx2()) {
+                return Avx2Kernels;
+            }
+#endif
+            return ScalarKernels;
+        }();
+        return table;
+    }
+
+}
+
+namespace AggregationKernels {
+
+    void sumByTwoCodes(const std::uint32_t* codes, const std::int64_t* amounts, std::size_t count,
+        std::uint32_t firstCode, std::uint32_t secondCode, std::int64_t& firstSum, std::int64_t& secondSum) {
+        kernels().sumByTwoCodes(codes, amounts, count, firstCode, secondCode, firstSum, secondSum);
+    }
+
+    void sumByKeyWhere(const std::uint32_t* codes, const std::uint32_t* keys, const std::int64_t* amounts,
+        std::size_t count, std::uint32_t filterCode, std::int64_t* bins, std::uint64_t* counts) {
+        kernels().sumByKeyWhere(codes, keys, amounts, count, filterCode, bins, counts);
+    }
+
+    const char* activeKernelName() {
+        return kernels().name;
+    }
+
+    std::vector<KernelSet> supportedKernelSets() {
+        std::vector<KernelSet> sets = { ScalarKernels };
+#if defined(AGGREGATION_KERNELS_X86)
+        if (cpuSupportsAvx2()) {
+            sets.push_back(Avx2Kernels);
+        }
+#endif
+        return sets;
+    }
+
+}
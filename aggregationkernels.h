@@ -0,0 +1,81 @@
+#ifndef AGGREGATIONKERNELS_H
+#define AGGREGATIONKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file aggregationkernels.h
+ * @brief Vectorized sum-by-code kernels used by the financial report totals.
+ *
+ * The kernels work on the contiguous columns of a TransactionStore: an array of
+ * dictionary codes and a parallel array of amounts in cents. Sums are plain
+ * 64-bit integer additions, so they are exact in any order. Each kernel has a portable
+ * scalar version and, on x86, an AVX2 version. The best version supported by
+ * the running CPU is picked once, the first time any kernel is called.
+ */
+namespace AggregationKernels {
+
+    /**
+     * @brief Sums the amounts of the rows whose code matches one of two codes.
+     *
+     * Used for the income/expense totals: one pass produces both sums.
+     *
+     * @param codes Row codes (e.g. transaction type codes).
+     * @param amounts Row amounts in cents, parallel to codes.
+     * @param count Number of rows.
+     * @param firstCode Rows with this code are added to firstSum.
+     * @param secondCode Rows with this code are added to secondSum.
+     * @param firstSum Receives the sum of the rows matching firstCode.
+     * @param secondSum Receives the sum of the rows matching secondCode.
+     */
+    void sumByTwoCodes(const std::uint32_t* codes, const std::int64_t* amounts, std::size_t count,
+        std::uint32_t firstCode, std::uint32_t secondCode, std::int64_t& firstSum, std::int64_t& secondSum);
+
+    /**
+     * @brief Adds the amounts of the rows matching a code into per-key bins.
+     *
+     * Used for the expense breakdown: rows whose code equals filterCode are added
+     * to bins[keys[row]] and counted in counts[keys[row]]. The bins and counts are
+     * accumulated into, not cleared.
+     *
+     * @param codes Row codes to filter on (e.g. transaction type codes).
+     * @param keys Row keys selecting the bin (e.g. category codes).
+     * @param amounts Row amounts in cents.
+     * @param count Number of rows.
+     * @param filterCode Only rows with this code are added.
+     * @param bins Per-key sums, one entry per possible key.
+     * @param counts Per-key row counts, one entry per possible key.
+     */
+    void sumByKeyWhere(const std::uint32_t* codes, const std::uint32_t* keys, const std::int64_t* amounts,
+        std::size_t count, std::uint32_t filterCode, std::int64_t* bins, std::uint64_t* counts);
+
+    /**
+     * @brief Gets the name of the kernel set chosen for this CPU.
+     * @return "avx2" or "scalar".
+     */
+    const char* activeKernelName();
+
+    /**
+     * @brief One implementation of every kernel, e.g. the scalar or the AVX2 one.
+     */
+    struct KernelSet {
+        decltype(&AggregationKernels::sumByTwoCodes) sumByTwoCodes; ///< This set's sumByTwoCodes.
+        decltype(&AggregationKernels::sumByKeyWhere) sumByKeyWhere; ///< This set's sumByKeyWhere.
+        const char* name;                       ///< "scalar" or "avx2".
+    };
+
+    /**
+     * @brief Gets every kernel set the running CPU can execute, so they can be compared.
+     *
+     * The application always goes through the dispatching functions above; this
+     * is for benchmarks that time each implementation on its own.
+     *
+     * @return The scalar set first, then the vectorized sets that are supported.
+     */
+    std::vector<KernelSet> supportedKernelSets();
+
+}
+
+#endif // AGGREGATIONKERNELS_H
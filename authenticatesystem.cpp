@@ -10,16 +10,19 @@
 */
 #include "authenticatesystem.h"
 #include <iostream> 
-#include <QDialog>
-#include <QVBoxLayout>
-#include <QLabel>
-#include <QTimer>
+#include <chrono>
 #include <QString>
 #include <QObject>
 #include <QFile>
 #include <QTextStream>
+#include <QSet>
+#include <QMutexLocker>
+#include <QDebug>
+#include "csvreader.h"
+#include "storageengine.h"
 
 const QString USERS = "users.txt";
+const QString USERS_TABLE = "users"; // StorageEngine table: user ID -> role
 
 /**
  * @class AuthenticateSystem
@@ -47,105 +50,152 @@ AuthenticateSystem::AuthenticateSystem() {
  * authentication if the credentials are valid. If authentication fails, it
  * increments the failure count and locks the account if necessary.
  *
+ * The lock check, the failure count and the lock decision are a single
+ * LoginState::recordAttempt() call, so concurrent logins of the same ID cannot
+ * race between them.
+ *
  * @param userID The ID of the user attempting to log in.
  * @return true if authentication is successful, false otherwise.
  *
  */
 bool AuthenticateSystem::authenticateUser(const QString& userID) {
-    // Display current login attempt information including the number of previous failures
-    std::cout << "Checking login for " << userID.toStdString()
-        << ". Failed attempts: " << failedAttempts[userID] << "/5" << std::endl;
+    // Check the credentials first; the login state then decides in one lookup what the attempt counts as
+    bool credentialsValid = checkCredentials(userID);
+    LoginState::Attempt attempt = loginState.recordAttempt(userID, credentialsValid);
 
     // Check if the account is locked due to previous failed attempts
-    if (isAccountLocked(userID)) {
+    if (attempt.wasLocked) {
         // If account is locked, notify user and prevent further login attempts
-        std::cout << "⚠ Account " << userID.toStdString() << " is LOCKED! Try again later." << std::endl;
+        if (attemptLogAllowed()) {
+            std::cout << "⚠ Account " << userID.toStdString() << " is LOCKED! Try again later." << std::endl;
+        }
         return false; // Authentication fails for locked accounts
     }
 
-    // Verify if the user exists in the system
-    if (!userExists(userID)) {
-        std::cout << "Invalid ID: No user found with ID " << userID.toStdString() << std::endl;   // Log the failed attempt with detailed error message
-        failedAttempts[userID]++;   // Increment failed attempt counter even for non-existent accounts
-
-        // Lock the account if too many failed attempts occur
-        if (failedAttempts[userID] >= 5) {
-            // After 5 failures, lock the non-existent userID to slow down brute force attempts
-            lockAccount(userID);
+    if (attempt.rateLimited) {
+        // Too many IDs are locked right now to lock this one too; refuse it rather than free a lock
+        if (attemptLogAllowed()) {
+            std::cout << "⚠ Too many failed logins right now. Try again later." << std::endl;
         }
-        return false; // Authentication fails for non-existent users
+        return false;
     }
 
-    // Attempt user login
-    if (users[userID]->login()) {
-        // Authentication successful - log the event
-        std::cout << "Successful login for " << userID.toStdString() << std::endl;
-        // Reset the failed attempt counter upon successful authentication
-        failedAttempts[userID] = 0;
+    if (attempt.succeeded) {
+        // Authentication successful - log the event; the failure count was reset
+        if (attemptLogAllowed()) {
+            std::cout << "Successful login for " << userID.toStdString() << std::endl;
+        }
         return true; // Authentication succeeded
     }
-    // Increment the failed attempt counter for this specific userID
-    failedAttempts[userID]++;
 
-    // Log the failed attempt with the updated counter
-    std::cout << "Failed login attempt " << failedAttempts[userID] << "/5 for "
-        << userID.toStdString() << std::endl;
+    // Failed attempts count even for non-existent IDs, to slow down brute force attempts
+    if (!attemptLogAllowed()) {
+        return false; // Counted and, if it reached the limit, locked; only not printed
+    }
+    std::cout << "Failed login attempt " << (attempt.lockedNow ? LoginState::MaxFailedAttempts : attempt.failedAttempts)
+        << "/" << LoginState::MaxFailedAttempts << " for " << userID.toStdString() << std::endl;
 
-    // Lock the account if too many failed attempts occur
-    if (failedAttempts[userID] >= 5) {
-        // After 5 failures, lock the non-existent userID to slow down brute force attempts
-        lockAccount(userID);
+    // The attempt that reached the limit has already locked the ID, until its deadline
+    if (attempt.lockedNow) {
+        std::cout << "⚠ Account " << userID.toStdString() << " is now LOCKED for "
+            << LoginState::LockDurationMs / 1000 << " seconds." << std::endl;
     }
 
     return false; // Authentication failed
 }
 
 /**
- * @brief Locks a user account for a specified duration.
- *
- * This function marks a user account as locked due to excessive failed login attempts.
- * A timer is set to automatically unlock the account after a 60-second timeout period.
+ * @brief Takes one line of this second's login attempt messages.
  *
- * @param userID The ID of the user whose account should be locked.
+ * A flood of attempts would otherwise spend its time writing and flushing the
+ * console, one line per attempt. Once the second's lines are used up, the check
+ * is a single atomic load.
  *
- */void AuthenticateSystem::lockAccount(const QString& userID) {
-     lockedAccounts[userID] = true;
-     failedAttempts[userID] = 0;
-
-     // Create the lockout popup dialog
-     QDialog* lockDialog = new QDialog();
-     lockDialog->setWindowTitle("Account Locked");
-     lockDialog->setModal(true); // Blocks interaction with other windows
-     lockDialog->setWindowFlags(lockDialog->windowFlags() & ~Qt::WindowCloseButtonHint); // Disable close button
-
-     QLabel* countdownLabel = new QLabel("ACCOUNT LOCKED\n\nTime remaining: 60 seconds");
-     countdownLabel->setAlignment(Qt::AlignCenter);
+ * @return True if the message may be printed, false if this second's lines are used up.
+ */
+bool AuthenticateSystem::attemptLogAllowed() {
+    const qint64 second = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    qint64 counted = attemptLogSecond.load(std::memory_order_relaxed);
+    if (counted != second && attemptLogSecond.compare_exchange_strong(counted, second, std::memory_order_relaxed)) {
+        attemptLogLines.store(0, std::memory_order_relaxed); // The thread that starts a second resets its count
+    }
+    if (attemptLogLines.load(std::memory_order_relaxed) >= AttemptLogLinesPerSecond) {
+        return false;
+    }
+    return attemptLogLines.fetch_add(1, std::memory_order_relaxed) < AttemptLogLinesPerSecond;
+}
 
-     QVBoxLayout* layout = new QVBoxLayout(lockDialog);
-     layout->addWidget(countdownLabel);
-     lockDialog->setLayout(layout);
-     lockDialog->resize(300, 150);
+/**
+ * @brief Authenticates a user and starts a session for them.
+ *
+ * Every successful login gets its own session, so the same user can be logged
+ * in from several clients at once.
+ *
+ * @param userID The ID of the user to log in.
+ * @return The token of the new session, or an empty string if authentication failed.
+ */
+QString AuthenticateSystem::loginUser(const QString& userID) {
+    if (!authenticateUser(userID)) {
+        return QString();
+    }
+    return sessions.createSession(userID);
+}
 
-     int* remainingTime = new int(60);
-     QTimer* timer = new QTimer(lockDialog);
-     timer->setInterval(1000); // 1 second
+/**
+ * @brief Checks a session token and keeps the session alive.
+ * @param token The token returned by loginUser().
+ * @param userID Receives the user of the session, if not null.
+ * @return True if the session is valid.
+ */
+bool AuthenticateSystem::validateSession(const QString& token, QString* userID) {
+    return sessions.validate(token, userID);
+}
 
-     QObject::connect(timer, &QTimer::timeout, [=]() mutable {
-         (*remainingTime)--;
+/**
+ * @brief Ends one session, leaving the user's other sessions valid.
+ * @param token The token returned by loginUser().
+ */
+void AuthenticateSystem::logoutSession(const QString& token) {
+    if (sessions.endSession(token)) {
+        std::cout << "Session ended." << std::endl;
+    }
+}
 
-         countdownLabel->setText(QString("ACCOUNT LOCKED\n\nTime remaining: %1 seconds").arg(*remainingTime));
+/**
+ * @brief Checks whether a user exists and may log in.
+ * @param userID The ID of the user.
+ * @return True if the credentials are valid.
+ */
+bool AuthenticateSystem::checkCredentials(const QString& userID) {
+    QString role;
+    return findUser(userID, &role) && User(userID, role).login();
+}
 
-         if (*remainingTime <= 0) {
-             timer->stop();
-             lockedAccounts[userID] = false;
-             delete remainingTime;
-             lockDialog->accept(); // Closes the dialog
-         }
-         });
+/**
+ * @brief Locks a user account for a specified duration.
+ *
+ * This function marks a user account as locked due to excessive failed login attempts.
+ * The lock ends by itself after LoginState::LockDurationMs; nothing here waits for it
+ * or shows any UI, the login page observes the lock through lockRemainingMs().
+ *
+ * @param userID The ID of the user whose account should be locked.
+ *
+ */
+void AuthenticateSystem::lockAccount(const QString& userID) {
+    if (!loginState.lock(userID)) {
+        std::cout << "⚠ Unable to lock " << userID.toStdString() << ": too many accounts are locked already." << std::endl;
+    }
+}
 
-     timer->start();
-     lockDialog->exec(); // Show and block until finished
- }
+/**
+ * @brief Gets how long a user account stays locked.
+ * @param userID The ID of the user to check.
+ * @return Milliseconds until the lock ends, 0 if the account is not locked.
+ */
+qint64 AuthenticateSystem::lockRemainingMs(const QString& userID) const {
+    return loginState.lockRemainingMs(userID);
+}
 
 
 /**
@@ -158,48 +208,164 @@ bool AuthenticateSystem::authenticateUser(const QString& userID) {
  * @return true if the account is locked, false otherwise.
  */
 bool AuthenticateSystem::isAccountLocked(const QString& userID) {
-    // Check if the userID exists in the lockedAccounts map AND if its value is true
-    return lockedAccounts.find(userID) != lockedAccounts.end() && lockedAccounts[userID];
+    return loginState.isLocked(userID);
 }
 
 /**
  * @brief Logs out a user from the system.
  *
- * This function handles the logout process for a specified user, calling the
- * logout method of the corresponding User object if it exists.
+ * This function ends every session of the specified user. The User record is
+ * left as it is, so the user can log in again right away.
  *
  * @param userID The ID of the user to log out.
  */
 void AuthenticateSystem::logoutUser(const QString& userID) {
-    // Check if the user exists in our system before attempting logout
-    if (users.find(userID) != users.end()) {
-        // User exists, so we can safely call the logout method
-        users[userID]->logout();
-    }
+    const qsizetype ended = sessions.endSessions(userID);
+    std::cout << "Logged out " << userID.toStdString() << " from " << ended << " session(s)." << std::endl;
 }
 
 /**
  * @brief Adds a new user to the authentication system.
  *
  * This function creates a new user account with the specified ID and role,
- * but only if the user ID is not already registered in the system.
+ * but only if the user ID is not already registered in the system. The user
+ * only appears in memory once the database has it, so a failed write leaves
+ * nothing behind that would vanish on the next start.
  *
  * @param userID The ID for the new user account.
  * @param role The role or permission level for the new user.
+ * @return True if the user was added, false otherwise.
  */
-void AuthenticateSystem::addUser(const QString& userID, const QString& role) {
-    // Check if a user with this ID already exists in the system
-    if (users.find(userID) != users.end()) {
+bool AuthenticateSystem::addUser(const QString& userID, const QString& role) {
+    // Check, write and insert under the lock of the ID's shard, so two signups of the same ID cannot both pass.
+    // Logins of IDs in the other shards go on while the new user is written
+    UserShard& shard = userShardFor(userID);
+    QMutexLocker locker(&shard.mutex);
+    if (shard.users.contains(userID) || StorageEngine::instance().contains(USERS_TABLE, userID.toUtf8())) {
         // User already exists - notify and abort the registration process
         std::cout << "User " << userID.toStdString() << " is already signed up. Please log in :)" << std::endl;
-        return; // return to prevent creating duplicate users
+        return false; // return to prevent creating duplicate users
+    }
+    // Only the new user is written, the other accounts stay where they are in the database. It is an insert,
+    // so a bulk provisioning that stored the ID since the check above is not overwritten
+    StorageEngine::Transaction transaction;
+    transaction.insert(USERS_TABLE, userID.toUtf8(), role.toUtf8());
+    QVector<qsizetype> skipped;
+    if (!StorageEngine::instance().commit(transaction, &skipped)) {
+        std::cout << "Error: Unable to save the account of " << userID.toStdString() << ". Please try again." << std::endl;
+        return false;
     }
-    // Create a new User object with the provided ID and role
-    users[userID] = new User(userID, role);
+    if (!skipped.isEmpty()) {
+        std::cout << "User " << userID.toStdString() << " is already signed up. Please log in :)" << std::endl;
+        return false;
+    }
+    // The new user takes one slot of the flat table, no separate allocation per account
+    shard.users.insert(userID, role);
     // Notify through console that the user creation was successful
     std::cout << "New account created for " << userID.toStdString() << ". You can now log in!" << std::endl;
-    saveUsersToFile();
+    return true;
+}
+
+/**
+ * @brief Adds many users at once.
+ *
+ * Each record costs one hash lookup against the batch and one against the
+ * registered users, and the whole batch is committed as one StorageEngine
+ * transaction, so importing n users takes O(n) time and a single disk write.
+ * The new users are not loaded into memory; findUser() reads them when they
+ * first log in, like every other account.
+ *
+ * No shard lock is held between that check and the commit, so every user is
+ * written as an insert: an ID that addUser() stored in between is left out by
+ * the commit and reported as AlreadyExists instead of being overwritten.
+ *
+ * @param records The (ID, role) pairs, surrounding whitespace is ignored.
+ * @return The outcome of every record.
+ */
+AuthenticateSystem::ProvisionResult AuthenticateSystem::provisionUsers(const QVector<ProvisionRecord>& records) {
+    ProvisionResult result;
+    result.outcomes.reserve(records.size());
+
+    QSet<QString> seen; // IDs of this batch handled so far
+    seen.reserve(records.size());
+    StorageEngine::Transaction transaction;
+    QVector<qsizetype> recordOfInsert; // Position in records of every queued insert
+
+    for (const ProvisionRecord& record : records) {
+        const QString id = record.userID.trimmed();
+        const QString role = record.role.trimmed();
+        if (id.isEmpty() || role.isEmpty()) {
+            result.outcomes.append(ProvisionOutcome::Invalid);
+            continue;
+        }
+        if (seen.contains(id)) {
+            result.outcomes.append(ProvisionOutcome::Duplicate);
+            continue;
+        }
+        seen.insert(id);
 
+        if (userExists(id)) {
+            result.outcomes.append(ProvisionOutcome::AlreadyExists);
+            continue;
+        }
+        transaction.insert(USERS_TABLE, id.toUtf8(), role.toUtf8());
+        recordOfInsert.append(result.outcomes.size());
+        result.outcomes.append(ProvisionOutcome::Created);
+        result.created++;
+    }
+
+    QVector<qsizetype> skipped;
+    result.committed = StorageEngine::instance().commit(transaction, &skipped);
+    for (qsizetype insert : skipped) {
+        // Signed up by someone else since the check above; the stored role stays
+        result.outcomes[recordOfInsert[insert]] = ProvisionOutcome::AlreadyExists;
+        result.created--;
+    }
+    if (!result.committed) {
+        // None of the batch was written, so none of it was created
+        for (ProvisionOutcome& outcome : result.outcomes) {
+            if (outcome == ProvisionOutcome::Created) {
+                outcome = ProvisionOutcome::NotSaved;
+            }
+        }
+        result.created = 0;
+        result.error = "Unable to save the new users";
+    }
+
+    qDebug() << "Provisioned" << result.created << "of" << records.size() << "users";
+    return result;
+}
+
+/**
+ * @brief Adds the users listed in a file, one "id,role" record per line.
+ * @param filePath The file to import.
+ * @return The outcome of every non-blank line, or an error if the file could not be read.
+ */
+AuthenticateSystem::ProvisionResult AuthenticateSystem::provisionUsersFromFile(const QString& filePath) {
+    CsvReader reader;
+    if (!reader.open(filePath)) {
+        ProvisionResult result;
+        result.error = reader.errorString();
+        return result;
+    }
+
+    // Rows are tokenized in place; only the two fields of each record are copied
+    QVector<ProvisionRecord> records;
+    QVector<QByteArrayView> fields;
+    while (reader.readRow(fields)) {
+        if (fields.size() == 1 && CsvReader::trimmed(fields[0]).isEmpty()) {
+            continue; // Blank line
+        }
+        ProvisionRecord record;
+        if (fields.size() == 2) {
+            record.userID = QString::fromUtf8(fields[0]);
+            record.role = QString::fromUtf8(fields[1]);
+        }
+        records.append(record); // An empty record is reported as Invalid
+    }
+    reader.close();
+
+    return provisionUsers(records);
 }
 
 /**
@@ -212,23 +378,89 @@ void AuthenticateSystem::addUser(const QString& userID, const QString& role) {
  * @return true if the user exists, false otherwise.
  */
 bool AuthenticateSystem::userExists(const QString& userID) {
-    // Check if the userID exists in the 'users' container by searching for it.
-    // If the userID is found, return true; otherwise, return false.
-    return users.find(userID) != users.end();
+    // Loaded users are checked first; the database only looks at its key index, no value is read
+    {
+        UserShard& shard = userShardFor(userID);
+        QMutexLocker locker(&shard.mutex);
+        if (shard.users.contains(userID)) {
+            return true;
+        }
+    }
+    return StorageEngine::instance().contains(USERS_TABLE, userID.toUtf8());
 }
 
-void AuthenticateSystem::saveUsersToFile() {
-    QFile file(USERS);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        for (const auto& pair : users) {
-            out << pair.first << "," << pair.second->getRole() << "\n";
+/**
+ * @brief Picks the shard a user belongs to.
+ * @param userID The ID of the user.
+ * @return The shard.
+ */
+AuthenticateSystem::UserShard& AuthenticateSystem::userShardFor(const QString& userID) {
+    return userShards[qHash(userID) & (UserShardCount - 1)];
+}
+
+/**
+ * @brief Finds a user, reading it from the database on first use.
+ *
+ * Looking a user up costs one probe of the flat table of its shard; only the
+ * first lookup of an account reads its role from the database. The shard lock
+ * is released for that read, so a slow disk only delays this one login. Two
+ * first lookups of the same ID may both read it; the second insert is then a
+ * no-op, since accounts never change once stored.
+ *
+ * @param userID The ID of the user.
+ * @param role Receives the role of the user, if not null.
+ * @return True if the user is registered.
+ */
+bool AuthenticateSystem::findUser(const QString& userID, QString* role) {
+    UserShard& shard = userShardFor(userID);
+    {
+        QMutexLocker locker(&shard.mutex);
+        if (shard.users.find(userID, role)) {
+            return true;
         }
-        file.close();
     }
+
+    QByteArray storedRole;
+    if (!StorageEngine::instance().get(USERS_TABLE, userID.toUtf8(), storedRole)) {
+        return false;
+    }
+
+    QMutexLocker locker(&shard.mutex);
+    shard.users.insert(userID, QString::fromUtf8(storedRole));
+    return shard.users.find(userID, role); // The role comes back interned
 }
 
+/**
+ * @brief Writes every user to the database in one transaction.
+ *
+ * Single signups do not need this, addUser() stores just the new user. Used to
+ * move the accounts of an old users.txt into the database.
+ */
+void AuthenticateSystem::saveUsersToFile() {
+    StorageEngine::Transaction transaction;
+    for (UserShard& shard : userShards) {
+        QMutexLocker locker(&shard.mutex); // One shard at a time, logins in the others go on
+        shard.users.forEach([&transaction](const QString& userID, const QString& role) {
+            transaction.put(USERS_TABLE, userID.toUtf8(), role.toUtf8());
+        });
+    }
+    StorageEngine::instance().commit(transaction);
+}
+
+/**
+ * @brief Moves the accounts of an old users.txt into the database, once.
+ *
+ * Nothing is read here when the database already has users: accounts are loaded
+ * one by one by findUser() when they are first needed. Opening the database does
+ * read the key of every account, from its key checkpoint, but no role, so
+ * startup grows with the number of IDs and not with the size of the stored
+ * records. The text file is left as it was.
+ */
 void AuthenticateSystem::loadUsersFromFile() {
+    if (StorageEngine::instance().count(USERS_TABLE) > 0) {
+        return;
+    }
+
     QFile file(USERS);
     if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QTextStream in(&file);
@@ -238,10 +470,13 @@ void AuthenticateSystem::loadUsersFromFile() {
             if (parts.size() == 2) {
                 QString id = parts[0];
                 QString role = parts[1];
-                users[id] = new User(id, role);
+                UserShard& shard = userShardFor(id);
+                QMutexLocker locker(&shard.mutex);
+                shard.users.insert(id, role);
             }
         }
         file.close();
+        saveUsersToFile(); // From now on the database is used
     }
 }
 
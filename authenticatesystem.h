@@ -1,10 +1,17 @@
 #ifndef AUTHENTICATESYSTEM_H
 #define AUTHENTICATESYSTEM_H
 
-#include <unordered_map>
+#include <QHash>
+#include <QMutex>
 #include <QString>
 #include <QTimer>
+#include <QVector>
+#include <array>
+#include <atomic>
+#include "loginstate.h"
+#include "sessionmanager.h"
 #include "user.h"
+#include "usertable.h"
 
 
 /**
@@ -15,6 +22,28 @@
  * and user management. It tracks failed login attempts, locks accounts after
  * too many failures, and provides methods to add, authenticate, and log out users.
  *
+ * Accounts are stored in the "users" table of the StorageEngine, one row per
+ * user, so a signup appends one record instead of rewriting every account. They
+ * are loaded lazily: a user's role is only read from the database the first time
+ * it is needed, and then kept in a compact UserTable. Opening the database still
+ * loads the key of every account from its key checkpoint.
+ *
+ * Logins may be checked from several threads at once: failed attempts and locks
+ * live in the sharded LoginState, and the loaded users are split the same way over
+ * UserShardCount shards, each with its own mutex and UserTable. A login holds one
+ * shard lock for one probe, and never while the database is read, so logins of
+ * other users neither wait for it nor for each other's first lookups. An ID that
+ * is not registered is turned down by the database's key index under a shared
+ * lock, without waiting for its mutex.
+ *
+ * The console messages of login attempts are limited to AttemptLogLinesPerSecond
+ * lines per second across all threads; the rest of each second's attempts are
+ * still counted and locked, only not printed.
+ *
+ * A successful loginUser() starts a session with an opaque token. A user may hold
+ * many sessions at once, one per client, and logging one of them out leaves the
+ * others and the User record untouched.
+ *
  * @author Simran Kullar
  */
 class AuthenticateSystem {
@@ -23,12 +52,82 @@ private slots:
 
 
 private:
-    std::unordered_map<QString, User*> users;          // Stores user IDs mapped to their User objects.
-    std::unordered_map<QString, int> failedAttempts;   // Tracks the number of failed login attempts per user.
-    std::unordered_map<QString, bool> lockedAccounts;  // Tracks whether a user's account is locked.
+    static constexpr int UserShardCount = 16;          // Independently locked parts of the loaded users, a power of two.
+    static constexpr int AttemptLogLinesPerSecond = 20; // Login attempt messages printed per second at most.
+
+    /**
+     * @brief One independently locked part of the loaded users.
+     */
+    struct UserShard {
+        QMutex mutex;       // Guards users.
+        UserTable users;    // Users of this shard read from the database so far, by ID.
+    };
+
+    std::array<UserShard, UserShardCount> userShards;  // Loaded users, split by ID hash.
+    LoginState loginState;                             // Failed attempts and locks of every ID.
+    SessionManager sessions;                           // Sessions of logged in clients, by token.
+    std::atomic<qint64> attemptLogSecond{0};           // Second of the steady clock the attempt messages are counted for.
+    std::atomic<int> attemptLogLines{0};               // Attempt messages printed in that second.
     const QString USERS = "users.txt";
 
+    /**
+     * @brief Picks the shard a user belongs to.
+     * @param userID The ID of the user.
+     * @return The shard.
+     */
+    UserShard& userShardFor(const QString& userID);
+
+    /**
+     * @brief Finds a user, reading it from the database on first use. Takes the shard lock itself.
+     * @param userID The ID of the user.
+     * @param role Receives the role of the user, if not null.
+     * @return True if the user is registered.
+     */
+    bool findUser(const QString& userID, QString* role = nullptr);
+
+    /**
+     * @brief Checks whether a user exists and may log in.
+     * @param userID The ID of the user.
+     * @return True if the credentials are valid.
+     */
+    bool checkCredentials(const QString& userID);
+
+    /**
+     * @brief Takes one line of this second's login attempt messages.
+     * @return True if the message may be printed, false if this second's lines are used up.
+     */
+    bool attemptLogAllowed();
+
 public:
+    /**
+     * @brief What happened to one record of a bulk provisioning.
+     */
+    enum class ProvisionOutcome {
+        Created,        ///< The user was added.
+        AlreadyExists,  ///< A user with this ID was already registered.
+        Duplicate,      ///< The ID came earlier in the same batch; only its first record counts.
+        Invalid,        ///< The record has no ID or no role.
+        NotSaved        ///< The user was valid, but the batch could not be written.
+    };
+
+    /**
+     * @brief One (ID, role) pair to provision.
+     */
+    struct ProvisionRecord {
+        QString userID; ///< The ID of the new user.
+        QString role;   ///< The role of the new user.
+    };
+
+    /**
+     * @brief Outcome of a bulk provisioning.
+     */
+    struct ProvisionResult {
+        QVector<ProvisionOutcome> outcomes; ///< One outcome per record, in input order.
+        qsizetype created = 0;              ///< Number of users added.
+        bool committed = false;             ///< The new users reached the disk, or there were none.
+        QString error;                      ///< Why the input could not be read, empty otherwise.
+    };
+
     /**
      * @brief Default constructor for AuthenticateSystem.
      *
@@ -47,19 +146,50 @@ public:
      */
     bool authenticateUser(const QString& userID);
 
+    /**
+     * @brief Authenticates a user and starts a session for them.
+     *
+     * The attempt counts towards the account lock exactly like authenticateUser().
+     *
+     * @param userID The ID of the user to log in.
+     * @return The token of the new session, or an empty string if authentication failed.
+     */
+    QString loginUser(const QString& userID);
+
+    /**
+     * @brief Checks a session token and keeps the session alive.
+     * @param token The token returned by loginUser().
+     * @param userID Receives the user of the session, if not null.
+     * @return True if the session is valid.
+     */
+    bool validateSession(const QString& token, QString* userID = nullptr);
+
+    /**
+     * @brief Ends one session, leaving the user's other sessions valid.
+     * @param token The token returned by loginUser().
+     */
+    void logoutSession(const QString& token);
+
     /**
      * @brief Locks a user's account after too many failed login attempts.
      *
-     * This method locks the user's account by setting their entry in the lockedAccounts map to true.
+     * This method marks the ID as locked in the login state until its lock deadline.
      *
      * @param userID The ID of the user whose account will be locked.
      */
     void lockAccount(const QString& userID);
 
     /**
-     * @brief Logs out a user by removing them from the active users list.
+     * @brief Gets how long a user account stays locked.
+     * @param userID The ID of the user to check.
+     * @return Milliseconds until the lock ends, 0 if the account is not locked.
+     */
+    qint64 lockRemainingMs(const QString& userID) const;
+
+    /**
+     * @brief Logs a user out of every client.
      *
-     * This method removes the user from the users map, effectively logging them out.
+     * This method ends all sessions of the user. The user can log in again right away.
      *
      * @param userID The ID of the user to log out.
      */
@@ -68,13 +198,37 @@ public:
     /**
      * @brief Adds a new user to the system.
      *
-     * This method creates a new User object and adds it to the users map with the provided user ID.
-     * It also initializes the failed attempts and locked status for the new user.
+     * This method stores the new user in the database and then in the loaded users.
+     * If the database write fails, the user is not added at all.
      *
      * @param userID The ID of the user to add.
      * @param role The role of the user (e.g., admin, user).
+     * @return True if the user was added, false if it already existed or could not be saved.
      */
-    void addUser(const QString& userID, const QString& role);
+    bool addUser(const QString& userID, const QString& role);
+
+    /**
+     * @brief Adds many users at once.
+     *
+     * The records are checked against the registered users and against each other
+     * in one pass, and every new user is written in a single transaction. Nothing
+     * is printed per user; the result tells what happened to each record.
+     *
+     * @param records The (ID, role) pairs, surrounding whitespace is ignored.
+     * @return The outcome of every record.
+     */
+    ProvisionResult provisionUsers(const QVector<ProvisionRecord>& records);
+
+    /**
+     * @brief Adds the users listed in a file, one "id,role" record per line.
+     *
+     * The format is the one users.txt always had. Lines without exactly two
+     * fields are reported as Invalid.
+     *
+     * @param filePath The file to import.
+     * @return The outcome of every non-blank line, or an error if the file could not be read.
+     */
+    ProvisionResult provisionUsersFromFile(const QString& filePath);
 
     /**
      * @brief Checks if a user exists in the system.
@@ -89,14 +243,21 @@ public:
     /**
      * @brief Checks if a user's account is locked.
      *
-     * This method checks if the provided user ID is marked as locked in the lockedAccounts map.
+     * This method checks if the provided user ID is marked as locked in the login state.
      *
      * @param userID The ID of the user to check.
      * @return True if the account is locked, false otherwise.
      */
     bool isAccountLocked(const QString& userID);
 
+    /**
+     * @brief Writes every loaded user to the database in one transaction.
+     */
     void saveUsersToFile();
+
+    /**
+     * @brief Moves the accounts of an old users.txt into the database, once.
+     */
     void loadUsersFromFile();
 };
 
@@ -0,0 +1,111 @@
+/**
+ * @file aggregation_bench.cpp
+ * @brief Measures the rows/s of every aggregation kernel set the CPU supports.
+ *
+ * Fills a TransactionStore with generated transactions, then times the scalar
+ * and the AVX2 versions of sumByTwoCodes and sumByKeyWhere on its columns. Each
+ * kernel runs several times and the fastest run is reported. The sums of every
+ * set are compared with the scalar ones, so a wrong vector kernel fails the run.
+ *
+ * Usage: aggregation_bench [rows]   (default 4000000)
+ */
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+#include "aggregationkernels.h"
+#include "transactionstore.h"
+
+namespace {
+
+    const int Repetitions = 7;  // Runs per kernel; the fastest counts.
+
+    /**
+     * @brief Computes the throughput of one run.
+     */
+    double rowsPerSecond(qsizetype rows, qint64 nanoseconds) {
+        return rows * 1e9 / qMax<qint64>(nanoseconds, 1);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const qsizetype rows = argc > 1 ? std::atoll(argv[1]) : 4000000;
+    if (rows <= 0) {
+        std::fprintf(stderr, "Usage: %s [rows]\n", argv[0]);
+        return 1;
+    }
+
+    // Generated data with the shape of a real ledger: a few types, a few dozen categories
+    const char* types[] = { "Income", "Expense", "Expense", "Transfer" };
+    const char* paymentMethods[] = { "Cash", "Card", "Bank Transfer", "Cheque" };
+    QRandomGenerator random(42);
+    TransactionStore store;
+    store.reserve(rows);
+    for (qsizetype row = 0; row < rows; ++row) {
+        const QByteArray category = "Category " + QByteArray::number(random.bounded(40));
+        const QByteArray id = "T" + QByteArray::number(row);
+        store.append("2024-03-15", id, types[random.bounded(4)], "Generated", Money::fromCents(random.bounded(1, 500000)),
+            paymentMethods[random.bounded(4)], category);
+    }
+
+    const quint32 incomeCode = store.types().find("Income");
+    const quint32 expenseCode = store.types().find("Expense");
+    const std::size_t count = static_cast<std::size_t>(store.size());
+    const int categoryCount = store.categories().size();
+    std::printf("%lld rows, %d categories\n\n", static_cast<long long>(rows), categoryCount);
+    std::printf("%-8s %-15s %14s %12s\n", "set", "kernel", "rows/s", "best ms");
+
+    std::int64_t expectedIncome = 0;
+    std::int64_t expectedExpenses = 0;
+    std::vector<std::int64_t> expectedBins;
+    bool allMatch = true;
+
+    for (const AggregationKernels::KernelSet& set : AggregationKernels::supportedKernelSets()) {
+        // sumByTwoCodes: the income and expense totals
+        std::int64_t income = 0;
+        std::int64_t expenses = 0;
+        qint64 best = std::numeric_limits<qint64>::max();
+        for (int run = 0; run < Repetitions; ++run) {
+            QElapsedTimer timer;
+            timer.start();
+            set.sumByTwoCodes(store.typeColumn().constData(), store.amountColumn().constData(), count,
+                incomeCode, expenseCode, income, expenses);
+            best = qMin(best, timer.nsecsElapsed());
+        }
+        std::printf("%-8s %-15s %14.0f %12.3f\n", set.name, "sumByTwoCodes", rowsPerSecond(rows, best), best / 1e6);
+
+        // sumByKeyWhere: the expense breakdown by category
+        std::vector<std::int64_t> bins(categoryCount);
+        std::vector<std::uint64_t> counts(categoryCount);
+        best = std::numeric_limits<qint64>::max();
+        for (int run = 0; run < Repetitions; ++run) {
+            std::fill(bins.begin(), bins.end(), 0);
+            std::fill(counts.begin(), counts.end(), 0);
+            QElapsedTimer timer;
+            timer.start();
+            set.sumByKeyWhere(store.typeColumn().constData(), store.categoryColumn().constData(),
+                store.amountColumn().constData(), count, expenseCode, bins.data(), counts.data());
+            best = qMin(best, timer.nsecsElapsed());
+        }
+        std::printf("%-8s %-15s %14.0f %12.3f\n", set.name, "sumByKeyWhere", rowsPerSecond(rows, best), best / 1e6);
+
+        // The scalar set comes first and is the reference for the others
+        if (expectedBins.empty()) {
+            expectedIncome = income;
+            expectedExpenses = expenses;
+            expectedBins = bins;
+        }
+        else if (income != expectedIncome || expenses != expectedExpenses || bins != expectedBins) {
+            std::printf("%-8s MISMATCH with the scalar results\n", set.name);
+            allMatch = false;
+        }
+    }
+
+    std::printf("\nactive set: %s\n", AggregationKernels::activeKernelName());
+    return allMatch ? 0 : 2;
+}
@@ -0,0 +1,60 @@
+#ifndef BENCHSUPPORT_H
+#define BENCHSUPPORT_H
+
+/**
+ * @file benchsupport.h
+ * @brief Small helpers shared by the benchmark programs.
+ */
+#include <QtGlobal>
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace BenchSupport {
+
+    /**
+     * @brief Gets the resident set size of this process.
+     * @return The RSS in KiB, or 0 where the platform gives no way to read it.
+     */
+    inline qint64 residentKiB() {
+#if defined(Q_OS_LINUX)
+        // VmRSS is the current resident size, which is what a long running server cares about
+        std::FILE* status = std::fopen("/proc/self/status", "r");
+        if (!status) {
+            return 0;
+        }
+        char line[256];
+        long long kib = 0;
+        while (std::fgets(line, sizeof(line), status)) {
+            if (std::strncmp(line, "VmRSS:", 6) == 0) {
+                std::sscanf(line + 6, "%lld", &kib);
+                break;
+            }
+        }
+        std::fclose(status);
+        return kib;
+#elif defined(Q_OS_WIN)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return 0;
+        }
+        return static_cast<qint64>(counters.WorkingSetSize / 1024);
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Formats a size in KiB as MiB with one decimal.
+     */
+    inline double toMiB(qint64 kib) {
+        return kib / 1024.0;
+    }
+
+}
+
+#endif // BENCHSUPPORT_H
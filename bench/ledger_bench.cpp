@@ -0,0 +1,110 @@
+/**
+ * @file ledger_bench.cpp
+ * @brief Measures the per-call cost of reading the whole ledger.
+ *
+ * Fills a CashflowTracking with generated transactions, then times three ways
+ * of reading all of them, as the table refresh, the report and the save do:
+ *
+ * - copy:     a std::vector<DataEntry> copied from getAllDataEntries(), which is
+ *             what every reader paid when the ledger was returned by value.
+ * - view:     a walk over the vector getAllDataEntries() now returns by reference.
+ * - visitor:  forEachDataEntry() with a category filter, as the report uses it.
+ *
+ * Each reader runs several times and the fastest run is reported.
+ *
+ * Usage: ledger_bench [entries]   (default 1000000)
+ */
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+#include "benchsupport.h"
+#include "cashflowtracking.h"
+
+namespace {
+
+    const int Repetitions = 5;  // Runs per reader; the fastest counts.
+
+    /**
+     * @brief Times the fastest of several runs of a reader.
+     * @param read The reader, returning a checksum so its work is not optimized away.
+     * @param checksum Receives the checksum of the last run.
+     * @return The fastest run in nanoseconds.
+     */
+    template <typename Reader>
+    qint64 bestOf(Reader&& read, long long& checksum) {
+        qint64 best = std::numeric_limits<qint64>::max();
+        for (int run = 0; run < Repetitions; ++run) {
+            QElapsedTimer timer;
+            timer.start();
+            checksum = read();
+            best = qMin(best, timer.nsecsElapsed());
+        }
+        return best;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const long long count = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    if (count <= 0) {
+        std::fprintf(stderr, "Usage: %s [entries]\n", argv[0]);
+        return 1;
+    }
+
+    // Generated entries with realistic string lengths; most fit no small-string buffer
+    QRandomGenerator random(42);
+    CashflowTracking tracking;
+    for (long long i = 0; i < count; ++i) {
+        const int day = 1 + random.bounded(28);
+        const std::string date = "2024-03-" + std::string(day < 10 ? "0" : "") + std::to_string(day) + ", 12:00";
+        tracking.addData(date, "Seller number " + std::to_string(random.bounded(1000)),
+            "Buyer number " + std::to_string(random.bounded(1000)), "Generated merchandise description",
+            Money::fromCents(random.bounded(1, 500000)), "Category " + std::to_string(random.bounded(40)));
+    }
+    std::printf("%lld entries, RSS %.1f MiB\n\n", count, BenchSupport::toMiB(BenchSupport::residentKiB()));
+    std::printf("%-8s %14s %14s\n", "reader", "best ms", "ns/entry");
+
+    long long copySum = 0;
+    const qint64 copyTime = bestOf([&tracking]() {
+        const std::vector<DataEntry> entries = tracking.getAllDataEntries(); // The old by-value return
+        long long sum = 0;
+        for (const DataEntry& data : entries) {
+            sum += data.cost.cents();
+        }
+        return sum;
+    }, copySum);
+
+    long long viewSum = 0;
+    const qint64 viewTime = bestOf([&tracking]() {
+        const std::vector<DataEntry>& entries = tracking.getAllDataEntries();
+        long long sum = 0;
+        for (const DataEntry& data : entries) {
+            sum += data.cost.cents();
+        }
+        return sum;
+    }, viewSum);
+
+    long long visitorSum = 0;
+    const std::string category = "Category 7";
+    const qint64 visitorTime = bestOf([&tracking, &category]() {
+        long long sum = 0;
+        tracking.forEachDataEntry([&category](const DataEntry& data) { return data.category == category; },
+            [&sum](const DataEntry& data) { sum += data.cost.cents(); });
+        return sum;
+    }, visitorSum);
+
+    std::printf("%-8s %14.3f %14.1f\n", "copy", copyTime / 1e6, static_cast<double>(copyTime) / count);
+    std::printf("%-8s %14.3f %14.1f\n", "view", viewTime / 1e6, static_cast<double>(viewTime) / count);
+    std::printf("%-8s %14.3f %14.1f\n", "visitor", visitorTime / 1e6, static_cast<double>(visitorTime) / count);
+    std::printf("\nview is %.0fx faster than copy\n", static_cast<double>(copyTime) / qMax<qint64>(viewTime, 1));
+
+    if (copySum != viewSum || visitorSum > viewSum) {
+        std::printf("MISMATCH between the readers\n");
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file login_bench.cpp
+ * @brief Measures the login throughput of AuthenticateSystem across threads.
+ *
+ * Provisions the requested number of users, logs each one in once so every
+ * account is loaded, then runs authenticateUser() on random registered IDs
+ * from 1, 2, 4, ... threads up to the number of cores. Each login is the full
+ * path: the credential lookup in the user shards plus the attempt recorded in
+ * the LoginState shards, and the console message it prints, which is rate
+ * limited as in production. A second pass logs in IDs that are not registered,
+ * which go to the database's key index on every attempt.
+ *
+ * Everything happens in a temporary directory, which becomes the working
+ * directory so StorageEngine::instance() opens a fresh data/noomyplan.db there.
+ *
+ * Usage: login_bench [users] [logins per thread]   (default 100000 200000)
+ */
+#include <QDir>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThread>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "authenticatesystem.h"
+#include "benchsupport.h"
+
+int main(int argc, char* argv[]) {
+    const long long users = argc > 1 ? std::atoll(argv[1]) : 100000;
+    const long long loginsPerThread = argc > 2 ? std::atoll(argv[2]) : 200000;
+    if (users <= 0 || loginsPerThread <= 0) {
+        std::fprintf(stderr, "Usage: %s [users] [logins per thread]\n", argv[0]);
+        return 1;
+    }
+
+    QTemporaryDir directory;
+    if (!directory.isValid() || !QDir::setCurrent(directory.path())) {
+        std::fprintf(stderr, "Unable to create a temporary directory\n");
+        return 1;
+    }
+
+    AuthenticateSystem auth;
+    QVector<AuthenticateSystem::ProvisionRecord> records;
+    records.reserve(users);
+    std::vector<QString> ids;
+    ids.reserve(static_cast<std::size_t>(users));
+    for (long long i = 0; i < users; ++i) {
+        ids.push_back("user" + QString::number(i));
+        records.append({ ids.back(), "User" });
+    }
+    if (!auth.provisionUsers(records).committed) {
+        std::fprintf(stderr, "Unable to provision the users\n");
+        return 1;
+    }
+
+    for (const QString& id : ids) {
+        auth.authenticateUser(id); // Loads every account, the timed runs only see warm lookups
+    }
+
+    std::printf("%lld users, %lld logins per thread, RSS %.1f MiB\n\n", users, loginsPerThread,
+        BenchSupport::toMiB(BenchSupport::residentKiB()));
+
+    const int maxThreads = qMax(1, QThread::idealThreadCount());
+    std::atomic<long long> failures{ 0 };
+    std::atomic<long long> unknownAccepted{ 0 };
+    for (bool unknown : { false, true }) {
+        std::printf("%s\n%8s %14s %12s\n", unknown ? "\nUnknown IDs" : "Registered IDs", "threads", "logins/s", "ms");
+        for (int threads = 1; ; threads = qMin(threads * 2, maxThreads)) {
+            QElapsedTimer timer;
+            timer.start();
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&auth, &ids, &failures, &unknownAccepted, loginsPerThread, unknown, t]() {
+                    QRandomGenerator random(42 + t);
+                    const quint32 count = static_cast<quint32>(ids.size());
+                    for (long long i = 0; i < loginsPerThread; ++i) {
+                        if (unknown) {
+                            // Every such attempt fails; it is the lookup of a missing key that is measured
+                            if (auth.authenticateUser("nobody" + QString::number(random.bounded(count)))) {
+                                unknownAccepted++;
+                            }
+                        }
+                        else if (!auth.authenticateUser(ids[random.bounded(count)])) {
+                            failures++;
+                        }
+                    }
+                });
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            const qint64 elapsed = timer.nsecsElapsed();
+            std::printf("%8d %14.0f %12.1f\n", threads, threads * loginsPerThread * 1e9 / qMax<qint64>(elapsed, 1), elapsed / 1e6);
+            if (threads == maxThreads) {
+                break;
+            }
+        }
+    }
+
+    if (failures > 0 || unknownAccepted > 0) {
+        std::printf("\n%lld logins of registered users FAILED, %lld logins of unknown IDs SUCCEEDED\n",
+            failures.load(), unknownAccepted.load());
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file loginstate_stress.cpp
+ * @brief Floods LoginState with failed attempts of distinct made-up IDs.
+ *
+ * A real ID first fails a few times. Then the requested number of random,
+ * never repeated IDs each fail once, as an attacker cycling IDs would do, and
+ * every tenth of the way the tracked and locked ID counts and the resident set
+ * size are printed: all must level off instead of growing with the flood. Finally the
+ * real ID fails again and has to be stopped within MaxFailedAttempts failures
+ * in total, since its count survived the flood in the sketch.
+ *
+ * Usage: loginstate_stress [ids] [max tracked ids]   (default 10000000 and LoginState's default cap)
+ */
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QString>
+#include <cstdio>
+#include <cstdlib>
+#include "benchsupport.h"
+#include "loginstate.h"
+
+int main(int argc, char* argv[]) {
+    const long long ids = argc > 1 ? std::atoll(argv[1]) : 10000000;
+    const long long cap = argc > 2 ? std::atoll(argv[2]) : LoginState::DefaultMaxTrackedIds;
+    if (ids <= 0 || cap <= 0) {
+        std::fprintf(stderr, "Usage: %s [ids] [max tracked ids]\n", argv[0]);
+        return 1;
+    }
+
+    LoginState state(cap);
+    const QString target = "real.user";
+    const int targetFailuresBefore = LoginState::MaxFailedAttempts - 2;
+    for (int i = 0; i < targetFailuresBefore; ++i) {
+        state.recordAttempt(target, false);
+    }
+
+    std::printf("%lld made-up IDs, cap %lld tracked IDs, %lld locked IDs\n\n", ids,
+        static_cast<long long>(state.maxTrackedIds()), static_cast<long long>(state.maxLockedIds()));
+    std::printf("%12s %10s %10s %10s %12s %10s\n", "attempts", "tracked", "locked", "RSS MiB", "rate limited", "s");
+    const qint64 startRss = BenchSupport::residentKiB();
+
+    QRandomGenerator random(42);
+    QElapsedTimer timer;
+    timer.start();
+    long long rateLimited = 0;
+    qint64 peakRss = startRss;
+    const long long step = qMax(1LL, ids / 10);
+    for (long long i = 1; i <= ids; ++i) {
+        // The counter makes every ID distinct, the random part keeps the hashes apart
+        const QString id = QString::number(random.generate64(), 36) + QLatin1Char('.') + QString::number(i, 36);
+        if (state.recordAttempt(id, false).rateLimited) {
+            rateLimited++;
+        }
+        if (i % step == 0 || i == ids) {
+            const qint64 rss = BenchSupport::residentKiB();
+            peakRss = qMax(peakRss, rss);
+            std::printf("%12lld %10lld %10lld %10.1f %12lld %10.1f\n", i, static_cast<long long>(state.trackedCount()),
+                static_cast<long long>(state.lockedCount()), BenchSupport::toMiB(rss), rateLimited, timer.elapsed() / 1000.0);
+        }
+    }
+
+    // The real ID has to be stopped by the failures it has left, not get a fresh count
+    int failuresToStop = 0;
+    bool stopped = false;
+    while (!stopped && failuresToStop < LoginState::MaxFailedAttempts) {
+        const LoginState::Attempt attempt = state.recordAttempt(target, false);
+        failuresToStop++;
+        stopped = attempt.lockedNow || attempt.wasLocked || attempt.rateLimited;
+    }
+
+    const bool capped = state.trackedCount() <= state.maxTrackedIds() && state.lockedCount() <= state.maxLockedIds();
+    const bool countKept = stopped && targetFailuresBefore + failuresToStop <= LoginState::MaxFailedAttempts;
+    std::printf("\npeak RSS %.1f MiB (%.1f MiB over the start)\n", BenchSupport::toMiB(peakRss),
+        BenchSupport::toMiB(peakRss - startRss));
+    std::printf("tracked and locked IDs within their caps: %s\n", capped ? "yes" : "NO");
+    std::printf("real ID stopped after %d more failures: %s\n", failuresToStop, countKept ? "yes" : "NO");
+    return capped && countKept ? 0 : 2;
+}
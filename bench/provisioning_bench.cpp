@@ -0,0 +1,100 @@
+/**
+ * @file provisioning_bench.cpp
+ * @brief Measures a bulk import of generated users through AuthenticateSystem.
+ *
+ * Writes an "id,role" file with the requested number of users, then imports it
+ * twice with provisionUsersFromFile(): once into an empty database, where every
+ * record is created, and once more, where every record is found to exist
+ * already. For each run it reports the time, the records per second and how
+ * many bytes the single commit added to the database file.
+ *
+ * Everything happens in a temporary directory, which becomes the working
+ * directory so StorageEngine::instance() opens a fresh data/noomyplan.db there.
+ *
+ * Usage: provisioning_bench [users]   (default 1000000)
+ */
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <cstdlib>
+#include "authenticatesystem.h"
+#include "benchsupport.h"
+
+namespace {
+
+    const char* const DatabasePath = "data/noomyplan.db"; // Where StorageEngine::instance() keeps its file.
+
+    /**
+     * @brief Gets the size of the database file.
+     */
+    qint64 databaseBytes() {
+        return QFileInfo(DatabasePath).size();
+    }
+
+    /**
+     * @brief Imports a file once and prints what it took.
+     * @return True if every record ended up with the expected outcome.
+     */
+    bool importOnce(AuthenticateSystem& auth, const QString& path, const char* label, long long users,
+        AuthenticateSystem::ProvisionOutcome expected) {
+        const qint64 before = databaseBytes();
+        QElapsedTimer timer;
+        timer.start();
+        const AuthenticateSystem::ProvisionResult result = auth.provisionUsersFromFile(path);
+        const qint64 elapsed = timer.nsecsElapsed();
+        const qint64 written = databaseBytes() - before;
+
+        qsizetype matching = 0;
+        for (AuthenticateSystem::ProvisionOutcome outcome : result.outcomes) {
+            matching += outcome == expected ? 1 : 0;
+        }
+        std::printf("%-10s %12.1f %14.0f %14lld %10lld %8.1f\n", label, elapsed / 1e6, users * 1e9 / qMax<qint64>(elapsed, 1),
+            static_cast<long long>(written), static_cast<long long>(result.created),
+            BenchSupport::toMiB(BenchSupport::residentKiB()));
+        return result.error.isEmpty() && result.committed && matching == users;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const long long users = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    if (users <= 0) {
+        std::fprintf(stderr, "Usage: %s [users]\n", argv[0]);
+        return 1;
+    }
+
+    QTemporaryDir directory;
+    if (!directory.isValid() || !QDir::setCurrent(directory.path())) {
+        std::fprintf(stderr, "Unable to create a temporary directory\n");
+        return 1;
+    }
+
+    // IDs of the shape the signup page allows, and a handful of roles
+    const char* roles[] = { "User", "User", "User", "Admin", "Auditor" };
+    QRandomGenerator random(42);
+    QFile input("users.csv");
+    if (!input.open(QIODevice::WriteOnly)) {
+        std::fprintf(stderr, "Unable to write users.csv\n");
+        return 1;
+    }
+    for (long long i = 0; i < users; ++i) {
+        input.write("user" + QByteArray::number(i) + "," + roles[random.bounded(5)] + "\n");
+    }
+    input.close();
+    std::printf("%lld users, input %lld bytes\n\n", users, static_cast<long long>(QFileInfo("users.csv").size()));
+
+    AuthenticateSystem auth;
+    std::printf("%-10s %12s %14s %14s %10s %8s\n", "run", "ms", "records/s", "commit bytes", "created", "RSS MiB");
+    bool ok = importOnce(auth, "users.csv", "fresh", users, AuthenticateSystem::ProvisionOutcome::Created);
+    ok = importOnce(auth, "users.csv", "existing", users, AuthenticateSystem::ProvisionOutcome::AlreadyExists) && ok;
+
+    if (!ok) {
+        std::printf("\nUNEXPECTED outcomes, see above\n");
+        return 2;
+    }
+    return 0;
+}
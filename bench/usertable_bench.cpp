@@ -0,0 +1,116 @@
+/**
+ * @file usertable_bench.cpp
+ * @brief Compares the user map AuthenticateSystem used to have with UserTable.
+ *
+ * Builds both structures with the same generated users and reports, for each,
+ * how long building took, how much the resident set size grew and the average
+ * latency of lookups of random registered IDs:
+ *
+ * - before: QHash<QString, User*>, one heap-allocated User per account,
+ * - after:  UserTable, one 32-byte slot per account and interned roles.
+ *
+ * UserTable is measured first. It frees its memory in large blocks, so the
+ * growth measured for the QHash afterwards is not hidden by reused heap.
+ *
+ * Usage: usertable_bench [users] [lookups]   (default 1000000 4000000)
+ */
+#include <QElapsedTimer>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QString>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "benchsupport.h"
+#include "user.h"
+#include "usertable.h"
+
+namespace {
+
+    /**
+     * @brief Prints one line of results.
+     */
+    void report(const char* name, qint64 buildNs, qint64 rssKiB, qint64 lookupNs, long long lookups, long long users) {
+        std::printf("%-8s %12.1f %12.1f %14.1f %12.1f\n", name, buildNs / 1e6, BenchSupport::toMiB(rssKiB),
+            rssKiB * 1024.0 / users, static_cast<double>(lookupNs) / lookups);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const long long users = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    const long long lookups = argc > 2 ? std::atoll(argv[2]) : 4000000;
+    if (users <= 0 || lookups <= 0) {
+        std::fprintf(stderr, "Usage: %s [users] [lookups]\n", argv[0]);
+        return 1;
+    }
+
+    // IDs and the order they are looked up in are made before anything is measured
+    const QString roles[] = { "User", "User", "User", "Admin", "Auditor" };
+    QRandomGenerator random(42);
+    std::vector<QString> ids;
+    std::vector<int> roleOf;
+    ids.reserve(static_cast<std::size_t>(users));
+    roleOf.reserve(static_cast<std::size_t>(users));
+    for (long long i = 0; i < users; ++i) {
+        ids.push_back("user." + QString::number(i));
+        roleOf.push_back(static_cast<int>(random.bounded(5)));
+    }
+    std::vector<quint32> order(static_cast<std::size_t>(lookups));
+    for (quint32& index : order) {
+        index = random.bounded(static_cast<quint32>(users));
+    }
+
+    std::printf("%lld users, %lld lookups\n\n", users, lookups);
+    std::printf("%-8s %12s %12s %14s %12s\n", "map", "build ms", "RSS MiB", "bytes/user", "ns/lookup");
+    long long found = 0;
+
+    {
+        const qint64 rssBefore = BenchSupport::residentKiB();
+        QElapsedTimer timer;
+        timer.start();
+        UserTable table;
+        for (long long i = 0; i < users; ++i) {
+            table.insert(ids[i], roles[roleOf[i]]);
+        }
+        const qint64 buildNs = timer.nsecsElapsed();
+        const qint64 rss = BenchSupport::residentKiB() - rssBefore;
+
+        QString role;
+        timer.restart();
+        for (quint32 index : order) {
+            found += table.find(ids[index], &role) ? 1 : 0;
+        }
+        report("after", buildNs, rss, timer.nsecsElapsed(), lookups, users);
+    }
+
+    {
+        const qint64 rssBefore = BenchSupport::residentKiB();
+        QElapsedTimer timer;
+        timer.start();
+        QHash<QString, User*> map;
+        for (long long i = 0; i < users; ++i) {
+            map.insert(ids[i], new User(ids[i], roles[roleOf[i]]));
+        }
+        const qint64 buildNs = timer.nsecsElapsed();
+        const qint64 rss = BenchSupport::residentKiB() - rssBefore;
+
+        QString role;
+        timer.restart();
+        for (quint32 index : order) {
+            User* user = map.value(ids[index]);
+            if (user) {
+                role = user->getRole();
+                found++;
+            }
+        }
+        report("before", buildNs, rss, timer.nsecsElapsed(), lookups, users);
+        qDeleteAll(map);
+    }
+
+    if (found != 2 * lookups) {
+        std::printf("\nLOOKUPS MISSED registered users\n");
+        return 2;
+    }
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "budgetpage.h"
+#include "csvreader.h"
 
 
 /**
@@ -111,7 +112,7 @@ void BudgetPage::getJSONBudget(const QJsonObject &budget) {
  * @author - Katherine R
  */
 void BudgetPage::onBudgetChangeSlot(double budget) {
-    this->budgets[budgetPeriodIndex]->setBudget( budget );
+    this->budgets[budgetPeriodIndex]->setBudget( Money::fromDouble( budget ) );
     if ( SHOW_DEBUG_LOGS ) {
         qDebug( ) << "Changed Budget - " << budget;
     }
@@ -125,7 +126,7 @@ void BudgetPage::onBudgetChangeSlot(double budget) {
  * @author - Katherine R
  */
 void BudgetPage::onBudgetGoalChangedSlot(double goal) {
-    this->budgets[budgetPeriodIndex]->setBudgetGoal( goal );
+    this->budgets[budgetPeriodIndex]->setBudgetGoal( Money::fromDouble( goal ) );
     if ( SHOW_DEBUG_LOGS ) {
         qDebug( ) << "Changed Budget goal - " << goal;
     }
@@ -141,14 +142,14 @@ void BudgetPage::onBudgetGoalChangedSlot(double goal) {
  * @param delta - change in expense
  * @author - Katherine R
  */
-void BudgetPage::onExpenseChangedSlot(double delta) {
+void BudgetPage::onExpenseChangedSlot(Money delta) {
     budgets[budgetPeriodIndex]->changeTotalExpenses( delta );
     //changes the expense for the budget object by adding the change
     if ( SHOW_DEBUG_LOGS ) {
-        qDebug( ) << "new delta in expense " << delta;
+        qDebug( ) << "new delta in expense " << delta.toQString( );
     }
     expenses_totalExpensesLabel->setText(
-            "Total Expenses: $0" + QString::number( budgets.at( budgetPeriodIndex )->getTotalExpenses( ) ) );
+            "Total Expenses: $" + budgets.at( budgetPeriodIndex )->getTotalExpenses( ).toQString( ) );
     //updates the total expense text
     calculateRemainingBudget( );
 }
@@ -274,7 +275,7 @@ void BudgetPage::calculateRemainingBudget() {
                                                                     getTotalExpenses( ) );
     //updates remaining budget text
     expenses_remainingBudgetLabel->setText(
-            "Remaining Budget: $" + QString::number( budgets.at( budgetPeriodIndex )->getRemainingBudget( ) ) );
+            "Remaining Budget: $" + budgets.at( budgetPeriodIndex )->getRemainingBudget( ).toQString( ) );
     //changes text color to red to notify user of negative budget
     if ( budgets.at( budgetPeriodIndex )->getRemainingBudget( ) < budgets.at( budgetPeriodIndex )->
                                                                           getBudgetGoal( ) ) {
@@ -295,7 +296,7 @@ void BudgetPage::calculateRemainingBudget() {
         expenses_remainingBudgetLabel->setStyleSheet( "Color: auto" ); //default color if it's not negative
     }
     if ( SHOW_DEBUG_LOGS ) {
-        qDebug( ) << "Remaining Budget - " << budgets.at( budgetPeriodIndex )->getRemainingBudget( );
+        qDebug( ) << "Remaining Budget - " << budgets.at( budgetPeriodIndex )->getRemainingBudget( ).toQString( );
     }
 }
 
@@ -468,26 +469,26 @@ void BudgetPage::createExpensesSubPage() {
 
 /**
  * @brief getter for the set budget at the current period
- * @return the budgeted amount, double
+ * @return the budgeted amount
  */
-double BudgetPage::getBudget() const {
-    return this->budgetSelector_SpinBox->value( );
+Money BudgetPage::getBudget() const {
+    return Money::fromDouble( this->budgetSelector_SpinBox->value( ) );
 }
 
 /**
  * @brief getter for the total expense for the budget period
- * @return the total expense, double
+ * @return the total expense
  */
-double BudgetPage::getTotalExpenses() {
+Money BudgetPage::getTotalExpenses() {
     return this->budgets[budgetPeriodIndex]->getTotalExpenses( );
 }
 
 /**
  * @brief getter for the budget surplus goal at the current period
- * @return the surplus goal, double
+ * @return the surplus goal
  */
-double BudgetPage::getSurplusGoal() const {
-    return this->budgetSelector_goalSpinBox->value( );
+Money BudgetPage::getSurplusGoal() const {
+    return Money::fromDouble( this->budgetSelector_goalSpinBox->value( ) );
 }
 
 /**
@@ -620,12 +621,12 @@ void BudgetPage::changeBudgetPage() {
     if ( this->budgetPeriodIndex >= 0 && this->budgetPeriodIndex <= 17 ) {
         qDebug( ) << "Changed budget page";
         //changes budget setter spinbox to the value of the changed page
-        budgetSelector_SpinBox->setValue( budgets[budgetPeriodIndex]->getBudget( ) );
+        budgetSelector_SpinBox->setValue( budgets[budgetPeriodIndex]->getBudget( ).toDouble( ) );
         //changes budget goal setter spinbox to the value of the changed page
-        budgetSelector_goalSpinBox->setValue( budgets.at( budgetPeriodIndex )->getBudgetGoal( ) );
+        budgetSelector_goalSpinBox->setValue( budgets.at( budgetPeriodIndex )->getBudgetGoal( ).toDouble( ) );
         //changes the total expenses text to the value of the changed page
         expenses_totalExpensesLabel->setText(
-                "Total Expenses: $0" + QString::number( budgets.at( budgetPeriodIndex )->getTotalExpenses( ) ) );
+                "Total Expenses: $" + budgets.at( budgetPeriodIndex )->getTotalExpenses( ).toQString( ) );
         //shows and enables new expense area
         budgets[budgetPeriodIndex]->getExpensescrollarea( expenses_categoriesComboBox_index )->show( );
         budgets[budgetPeriodIndex]->getExpensescrollarea( expenses_categoriesComboBox_index )->setDisabled( false );
@@ -672,7 +673,7 @@ void BudgetPage::deleteExpense(BudgetPageExpenses * toDelete) {
     //gets index of expense to delete
     long long index = budgets[budgetPeriodIndex]->getExpenses( )->indexOf( toDelete );
     //gets the the expense value of the object to be deleted
-    double tempExpenseTotal = budgets[budgetPeriodIndex]->getExpenses( )->at( index )->getExpense( );
+    Money tempExpenseTotal = budgets[budgetPeriodIndex]->getExpenses( )->at( index )->getExpense( );
     //deletes object, then removes it from the budget page's QVector
     budgets[budgetPeriodIndex]->getExpenses( )->at( index )->deleteLater( );
     budgets[budgetPeriodIndex]->getExpenses( )->removeAt( index );
@@ -724,14 +725,14 @@ void BudgetPage::updateBarGraph() {
     }
     //adds values from budgets to graph QBarset
     for ( int i = rangelow ; i <= rangehigh ; i++ ) {
-        barChart_goalLine->append( i - rangelow , budgets.at( i )->getBudgetGoal( ) );
-        if ( budgets.at( i )->getRemainingBudget( ) < 0 ) {
+        barChart_goalLine->append( i - rangelow , budgets.at( i )->getBudgetGoal( ).toDouble( ) );
+        if ( budgets.at( i )->getRemainingBudget( ) < Money( ) ) {
             // if the remaining budget is negative
-            barChart_Neg->append( (qreal) budgets.at( i )->getRemainingBudget( ) ); //adds value to negative chart
+            barChart_Neg->append( budgets.at( i )->getRemainingBudget( ).toDouble( ) ); //adds value to negative chart
             barChart_Value->append( (qreal) 0 );                                    //adds 0 to the positive chart
         } else {
             barChart_Neg->append( (qreal) 0 ); //adds 0 to the negative chart
-            barChart_Value->append( (qreal) budgets.at( i )->getRemainingBudget( ) );
+            barChart_Value->append( budgets.at( i )->getRemainingBudget( ).toDouble( ) );
             //adds value to the positive chart
         }
     }
@@ -846,22 +847,22 @@ void BudgetPage::importCSV() {
                                                                      QMessageBox::Ok );
         return;
     }
-    //opens the file
-    QFile file( filepath );
-    if ( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    //maps the file, fields are read as views without copying each line
+    CsvReader reader;
+    if ( !reader.open( filepath ) )
         //breaks if the file is readonly or gives some other error
         return;
-    QTextStream in( & file ); //creates a textstream from file
-    in.readLine( ); //skips first line - the one outlining the budget variable defitinitions
-    QString     valueRow  = in.readLine( ); //reads the 2nd line (the one w the var values)
-    QStringList valueList = valueRow.split( ',' ); //splits the line by commas to each value
+    QVector<QByteArrayView> valueList; //reused for every row
+    reader.readRow( valueList ); //skips first line - the one outlining the budget variable defitinitions
+    reader.readRow( valueList ); //reads the 2nd line (the one w the var values), already split by commas
     if ( valueList.size( ) == 6 ) {
         //if the csv line is the expected format
         //gets the values from the csv file
-        double budget          = valueList.at( 0 ).toDouble( );
-        double totalExpenses   = valueList.at( 1 ).toDouble( );
-        double remainingBudget = valueList.at( 2 ).toDouble( );
-        double budgetGoal      = valueList.at( 3 ).toDouble( );
+        //amounts are parsed straight into cents
+        Money budget          = Money::parse( std::string_view( valueList.at( 0 ).data( ) , valueList.at( 0 ).size( ) ) );
+        Money totalExpenses   = Money::parse( std::string_view( valueList.at( 1 ).data( ) , valueList.at( 1 ).size( ) ) );
+        Money remainingBudget = Money::parse( std::string_view( valueList.at( 2 ).data( ) , valueList.at( 2 ).size( ) ) );
+        Money budgetGoal      = Money::parse( std::string_view( valueList.at( 3 ).data( ) , valueList.at( 3 ).size( ) ) );
         int    budgetIndex     = valueList.at( 4 ).toInt( );
         if ( budgetIndex <= 17 && budgetIndex >= 0 ) {
             //sets variables to new ones
@@ -871,16 +872,15 @@ void BudgetPage::importCSV() {
             budgets[budgetIndex]->setBudgetGoal( budgetGoal );
             //if the current selected budgetpage is the one imported - changes the variables
             if ( budgetPeriodIndex == budgetIndex ) {
-                budgetSelector_SpinBox->setValue( budget );
-                budgetSelector_goalSpinBox->setValue( budgetGoal );
+                budgetSelector_SpinBox->setValue( budget.toDouble( ) );
+                budgetSelector_goalSpinBox->setValue( budgetGoal.toDouble( ) );
             }
 
             //reads category names and desc, creates categories for them
-            QString     line         = in.readLine( );
-            QStringList categoryList = line.split( ',' );
-            for ( const QString &category: categoryList ) {
-                if ( !category.isNull( ) || !category.isEmpty( ) ) {
-                    QStringList temp = category.split( '_' );
+            reader.readRow( valueList );
+            for ( QByteArrayView category: valueList ) {
+                if ( !category.isEmpty( ) ) {
+                    QStringList temp = CsvReader::toString( category ).split( '_' );
                     //splits the category name and description by the '_' separation
                     if ( !temp.isEmpty( ) && temp.size( ) == 2 ) {
                         newExpenseCategory( temp.at( 0 ) , temp.at( 1 ) );
@@ -889,12 +889,11 @@ void BudgetPage::importCSV() {
             }
 
             budgets[budgetIndex]->getExpenses( )->clear( );                  //removes prev expenses
-            in.readLine( );                                                  //skips the line explaining expenses
+            reader.readRow( valueList );                                     //skips the line explaining expenses
             int oldIndex                = budgetPeriodIndex;                 //saves the old index
             int oldExpenseCategoryIndex = expenses_categoriesComboBox_index; //saves the old index
-            while ( !in.atEnd( ) ) {
-                QString     line      = in.readLine( ); //reads a line, then splits it by commas
-                QStringList valueList = line.split( ',' );
+            while ( reader.readRow( valueList ) ) {
+                //reads a row, already split by commas
                 if ( valueList.size( ) == 5 ) {
                     //if the csv follows the expected format
                     if ( valueList.at( 4 ).toInt( ) < budgets.at( budgetIndex )->getCategoriesCount( ) ) {
@@ -910,13 +909,13 @@ void BudgetPage::importCSV() {
                     }
                     //sets the expense variables
                     budgets[budgetIndex]->getExpenses( )->last( )->setExpenseName(
-                            QString( valueList.at( 0 ) ) );
+                            CsvReader::toString( valueList.at( 0 ) ) );
                     budgets[budgetIndex]->getExpenses( )->last( )->setExpenseDescription(
-                            QString( valueList.at( 1 ) ) );
+                            CsvReader::toString( valueList.at( 1 ) ) );
                     budgets[budgetIndex]->getExpenses( )->last( )->setExpenseQuantity(
                             valueList.at( 2 ).toDouble( ) );
                     budgets[budgetIndex]->getExpenses( )->last( )->setExpensePrice(
-                            valueList.at( 3 ).toDouble( ) );
+                            Money::parse( std::string_view( valueList.at( 3 ).data( ) , valueList.at( 3 ).size( ) ) ) );
                     budgets[budgetIndex]->getExpenses( )->last( )->setCategoryindex(
                             valueList.at( 4 ).toInt( ) );
                 }
@@ -76,21 +76,21 @@ public:
 
     /**
      * @brief getter for the set budget at the current period
-     * @return the budgeted amount, double
+     * @return the budgeted amount
      */
-    double getBudget() const;
+    Money getBudget() const;
 
     /**
      * @brief getter for the total expense for the budget period
-     * @return the total expense, double
+     * @return the total expense
      */
-    double getTotalExpenses();
+    Money getTotalExpenses();
 
     /**
      * @brief getter for the budget surplus goal at the current period
-     * @return the surplus goal, double
+     * @return the surplus goal
      */
-    double getSurplusGoal() const;
+    Money getSurplusGoal() const;
 
     /**
      * @brief setter for user id
@@ -122,7 +122,7 @@ public slots:
      * @param delta - change in expense
      * @author - Katherine R
      */
-    void onExpenseChangedSlot(double delta);
+    void onExpenseChangedSlot(Money delta);
 
     /**
      * @brief Slot for when the user changes the budget period type (monthly , quarterly, yearly)
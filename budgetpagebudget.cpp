@@ -13,11 +13,11 @@
  */
 BudgetPageBudget::BudgetPageBudget(QObject *parent)
     : QObject{parent} {
-    this->budget = 0;
-    this->totalExpenses = 0;
-    this->remainingBudget = 0;
+    this->budget = Money();
+    this->totalExpenses = Money();
+    this->remainingBudget = Money();
     this->budgetIndex = 0;
-    this->budgetGoal = 0;
+    this->budgetGoal = Money();
     this->budgetCategoryNames=new QStringList("Default Category");
     this->budgetCategoryDescriptions=new QStringList("Default Description");
     //creates area for expenses
@@ -33,11 +33,11 @@ BudgetPageBudget::BudgetPageBudget(QObject *parent)
  */
 BudgetPageBudget::BudgetPageBudget(QObject *parent, int budgetindex)
     : QObject{parent} {
-    this->budget = 0;
-    this->totalExpenses = 0;
-    this->remainingBudget = 0;
+    this->budget = Money();
+    this->totalExpenses = Money();
+    this->remainingBudget = Money();
     this->budgetIndex = budgetindex;
-    this->budgetGoal = 0;
+    this->budgetGoal = Money();
     this->budgetCategoryNames=new QStringList("Default Category");
     this->budgetCategoryDescriptions=new QStringList("Default Description");
     newExpensescrollArea();
@@ -52,8 +52,8 @@ BudgetPageBudget::BudgetPageBudget(QObject *parent, int budgetindex)
  * @param goal budget goal
  * @param budgetindex the index for the period of the budget (0=yearly, 1-5=quarterly, 6-18=monthly)
  */
-BudgetPageBudget::BudgetPageBudget(QObject *parent, double budget, double totalexpense, double remainingbudget,
-                                   int budgetindex, double goal)
+BudgetPageBudget::BudgetPageBudget(QObject *parent, Money budget, Money totalexpense, Money remainingbudget,
+                                   int budgetindex, Money goal)
     : QObject{parent} {
     this->budget = budget;
     this->totalExpenses = totalexpense;
@@ -75,11 +75,11 @@ BudgetPageBudget::BudgetPageBudget(QObject *parent, double budget, double totale
  */
 BudgetPageBudget::BudgetPageBudget(QObject *parent, const QJsonObject &json) : QObject{parent} {
     if (!json.isEmpty()) {
-        this->budget = json.value("Budget").toDouble();
-        this->totalExpenses = json.value("Total Expenses").toDouble();
-        this->remainingBudget = json.value("Remaining Budget").toDouble();
+        this->budget = Money::fromJson(json.value("Budget"));
+        this->totalExpenses = Money::fromJson(json.value("Total Expenses"));
+        this->remainingBudget = Money::fromJson(json.value("Remaining Budget"));
         this->budgetIndex = json.value("Index").toInt();
-        this->budgetGoal = json.value("Goal").toDouble();
+        this->budgetGoal = Money::fromJson(json.value("Goal"));
         this->budgetCategoryNames=new QStringList("Default Category");
         this->budgetCategoryDescriptions=new QStringList("Default Description");
         //splits Expenses into JSON array, then adds them
@@ -98,7 +98,7 @@ BudgetPageBudget::BudgetPageBudget(QObject *parent, const QJsonObject &json) : Q
  * @return budget
   * @author Katherine R
  */
-double BudgetPageBudget::getBudget() const {
+Money BudgetPageBudget::getBudget() const {
     return budget;
 }
 
@@ -107,7 +107,7 @@ double BudgetPageBudget::getBudget() const {
  * @return total expenses
   * @author Katherine R
  */
-double BudgetPageBudget::getTotalExpenses() const {
+Money BudgetPageBudget::getTotalExpenses() const {
     return totalExpenses;
 }
 
@@ -116,7 +116,7 @@ double BudgetPageBudget::getTotalExpenses() const {
  * @return remaining budget
   * @author Katherine R
  */
-double BudgetPageBudget::getRemainingBudget() const {
+Money BudgetPageBudget::getRemainingBudget() const {
     return remainingBudget;
 }
 
@@ -134,7 +134,7 @@ QVector<BudgetPageExpenses *> *BudgetPageBudget::getExpenses() {
  * @param newbudget new budget
   * @author Katherine R
  */
-void BudgetPageBudget::setBudget(double newbudget) {
+void BudgetPageBudget::setBudget(Money newbudget) {
     this->budget = newbudget;
 }
 
@@ -143,7 +143,7 @@ void BudgetPageBudget::setBudget(double newbudget) {
  * @param newtotalexpense
   * @author Katherine R
  */
-void BudgetPageBudget::setTotalExpenses(double newtotalexpense) {
+void BudgetPageBudget::setTotalExpenses(Money newtotalexpense) {
     totalExpenses = newtotalexpense;
 }
 
@@ -152,7 +152,7 @@ void BudgetPageBudget::setTotalExpenses(double newtotalexpense) {
  * @param newremainingbudget
   * @author Katherine R
  */
-void BudgetPageBudget::setRemainingBudget(double newremainingbudget) {
+void BudgetPageBudget::setRemainingBudget(Money newremainingbudget) {
     remainingBudget = newremainingbudget;
 }
 
@@ -171,7 +171,7 @@ void BudgetPageBudget::setIndex(int index) {
  * @param delta the change
   * @author Katherine R
  */
-void BudgetPageBudget::changeTotalExpenses(double delta) {
+void BudgetPageBudget::changeTotalExpenses(Money delta) {
     this->totalExpenses += delta;
 }
 
@@ -182,7 +182,7 @@ void BudgetPageBudget::changeTotalExpenses(double delta) {
             \n "Total Expenses" - the total expenses
             \n "Remaining Budget" - the remaining budget
             \n "Index" 0-18, the budget period (0-yearly) (1-5 Q1-Q4) (6-18 jan-dec)
-            \n "Goal" the goal for budget net, double
+            \n "Goal" the goal for budget net, exact decimal string
             \n "Expenses" an array with Expense::to_JSON()
 *           \n @copydoc BudgetPageExpenses::to_JSON()
   * @author Katherine R
@@ -196,12 +196,13 @@ QJsonObject BudgetPageBudget::to_JSON() {
         expensesArray.append(expense->to_JSON());
     }
     //adds the other variables
-    jsonDoc.insert("Budget", this->budget);
-    jsonDoc.insert("Total Expenses", this->totalExpenses);
-    jsonDoc.insert("Remaining Budget", this->remainingBudget);
+    //amounts are written as exact decimal strings so saving never rounds them
+    jsonDoc.insert("Budget", this->budget.toQString());
+    jsonDoc.insert("Total Expenses", this->totalExpenses.toQString());
+    jsonDoc.insert("Remaining Budget", this->remainingBudget.toQString());
     jsonDoc.insert("Expenses", expensesArray); //adds expenses jsonarray
     jsonDoc.insert("Index", this->budgetIndex);
-    jsonDoc.insert("Goal", this->budgetGoal);
+    jsonDoc.insert("Goal", this->budgetGoal.toQString());
     return jsonDoc;
 }
 
@@ -262,7 +263,7 @@ QVBoxLayout *BudgetPageBudget::getExpensesscrolllistvbox(int index) {
   @author Katherine R
   @return the budget goal
   */
-double BudgetPageBudget::getBudgetGoal() const {
+Money BudgetPageBudget::getBudgetGoal() const {
     return budgetGoal;
 }
 
@@ -271,7 +272,7 @@ double BudgetPageBudget::getBudgetGoal() const {
  * @param newbudgetgoal the new goal
   * @author Katherine R
  */
-void BudgetPageBudget::setBudgetGoal(double newbudgetgoal) {
+void BudgetPageBudget::setBudgetGoal(Money newbudgetgoal) {
     this->budgetGoal = newbudgetgoal;
 }
 
@@ -317,38 +318,42 @@ void BudgetPageBudget::createBudgetPageCSV() {
     filename.append("_");
     filename.append(getBudgetPeriodString());
     filename.append(".csv");
-    QFile file(filename); //sets output file to CSV_NAME macro
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    CsvWriter writer; //buffered writer, replaces the file only once everything is written
+    if (!writer.open(filename)) {
         //breaks if the file is readonly
         qDebug() << "error creating file";
-        file.close();
         return;
     }
-    QTextStream stream(&file); //creates qtextstream to add text
     //adds first line explaining the vars
-    stream << "budget,total expenses, remaining budget, budget goal, budget index, budget period\n";
+    writer.writeLine("budget,total expenses, remaining budget, budget goal, budget index, budget period");
     //adds the variables to the second line
-    stream << this->budget << "," << this->totalExpenses << "," << this->remainingBudget << ",";
-    stream << this->budgetGoal << "," << this->budgetIndex << "," << getBudgetPeriodString() << "\n";
-    //adds category names and descriptions
+    writer.addField(this->budget);
+    writer.addField(this->totalExpenses);
+    writer.addField(this->remainingBudget);
+    writer.addField(this->budgetGoal);
+    writer.addField(this->budgetIndex);
+    writer.addField(getBudgetPeriodString());
+    writer.endRow();
+    //adds category names and descriptions, each one quoted if it has a comma
     for (int i = 0; i < budgetCategoryNames->count(); i++) {
-        stream<<budgetCategoryNames->at(i)<<"_"<<budgetCategoryDescriptions->at(i)<<",";
+        writer.addField(budgetCategoryNames->at(i) + "_" + budgetCategoryDescriptions->at(i));
     }
-    stream<<"\n";
+    writer.addField(""); //keeps the trailing comma the file always had
+    writer.endRow();
     //adds a line explaining expense vars
-    stream << "expense name, expense description, expense quantity, expense price, expense category index\n";
+    writer.writeLine("expense name, expense description, expense quantity, expense price, expense category index");
     if (expenses.count() > 0) {
         //adds expenses after
         for (BudgetPageExpenses *expense: this->expenses) {
             //loops through all expenses
-            //writes them in csv format
-            stream << expense->to_CSV(); //calls to_CSV and adds it to the file
-            stream << "\n"; //goes to next line
+            expense->to_CSV(writer); //writes the expense as one row
         }
     } else {
-        stream << "\n";
+        writer.endRow();
+    }
+    if (!writer.commit()) {
+        qDebug() << "error writing file" << writer.errorString();
     }
-    file.close();
 }
 
 
@@ -1,4 +1,5 @@
 #include "budgetpageexpenses.h"
+#include <cmath>
 
 /**
     * @brief default constructor for expenses
@@ -11,7 +12,7 @@ BudgetPageExpenses::BudgetPageExpenses(QObject * parent)
     this->expenseName        = new QString( "" );
     this->expenseDescription = new QString( "" );
     this->quantity           = 1;
-    this->price              = 1;
+    this->price              = Money::fromCents( 100 );
     this->categoryIndex      = 0;
     createUIobjects( );
 }
@@ -27,7 +28,7 @@ BudgetPageExpenses::BudgetPageExpenses(QObject * parent)
  * @param categoryIndex the index of category
   * @author Katherine R
  */
-BudgetPageExpenses::BudgetPageExpenses(QObject * parent, const QString &name, const QString &description, double price,
+BudgetPageExpenses::BudgetPageExpenses(QObject * parent, const QString &name, const QString &description, Money price,
                                        double    quantity, int          categoryIndex
         ): QObject { parent } {
     expenseName         = new QString( name );
@@ -51,10 +52,12 @@ BudgetPageExpenses::BudgetPageExpenses(QObject * parent, const QString &name, co
      */
 BudgetPageExpenses::BudgetPageExpenses(QObject * parent, const QJsonObject &Expense): QObject { parent } {
     if ( !Expense.isEmpty( ) ) {
-        expenseName        = new QString( Expense.value( "name" ).toString( ) );
-        expenseDescription = new QString( Expense.value( "description" ).toString( ) );
-        price              = Expense.value( "price" ).toDouble( );
-        quantity           = Expense.value( "quantity" ).toDouble( );
+        //to_JSON writes capitalized keys, older saves used lowercase ones
+        expenseName        = new QString( Expense.value( Expense.contains( "Name" ) ? "Name" : "name" ).toString( ) );
+        expenseDescription = new QString(
+                Expense.value( Expense.contains( "Description" ) ? "Description" : "description" ).toString( ) );
+        price              = Money::fromJson( Expense.value( Expense.contains( "Price" ) ? "Price" : "price" ) );
+        quantity           = Expense.value( Expense.contains( "Quantity" ) ? "Quantity" : "quantity" ).toDouble( );
         categoryIndex      = Expense.value( "Category Index" ).toInt( );
         createUIobjects( );
     } else {
@@ -83,7 +86,7 @@ QJsonObject BudgetPageExpenses::to_JSON() {
     } else {
         expenseJson.insert( "Description" , "\0" );
     }
-    expenseJson.insert( "Price" , QString::number( price ) );
+    expenseJson.insert( "Price" , price.toQString( ) ); //exact decimal string, no float rounding
     expenseJson.insert( "Quantity" , quantity );
     expenseJson.insert( "Category Index" , categoryIndex );
     return expenseJson;
@@ -104,11 +107,12 @@ QPushButton * BudgetPageExpenses::getRemoveButton() {
      * @return price * quantity of expense item
       * @author Katherine R
      */
-double BudgetPageExpenses::getExpense() const {
-    if ( quantity <= 0 || price < 0 ) {
-        return 0;
+Money BudgetPageExpenses::getExpense() const {
+    if ( quantity <= 0 || price < Money( ) ) {
+        return Money( );
     }
-    return this->price * this->quantity;
+    //quantity can be fractional, so the line total is rounded to the nearest cent once
+    return Money::fromCents( std::llround( static_cast<double>( this->price.cents( ) ) * this->quantity ) );
 }
 
 /**
@@ -142,25 +146,24 @@ void BudgetPageExpenses::onExpenseDescriptionChangedSlot(const QString &newDescr
      * @author Katherine R
      */
 void BudgetPageExpenses::expenseSBChangedSlot(double change, char changedType) {
-    double oldExpenses = this->quantity * this->price;
+    Money oldExpenses = getExpense( );
     //determines the type that was changed (price or quantity)
     switch ( changedType ) {
         case 'Q': //if quantity
             this->quantity = change;
             break;
         case 'P': //if price
-            this->price = change;
+            this->price = Money::fromDouble( change );
             break;
         default:
             break;
     }
 
     if ( SHOW_DEBUG_LOGS ) {
-        qDebug( ) << "Expense " << * this->expenseName << " changed by - " << ( this->quantity * this->price ) -
-                oldExpenses;
+        qDebug( ) << "Expense " << * this->expenseName << " changed by - " << ( getExpense( ) - oldExpenses ).toQString( );
     }
 
-    emit expenseChangedSignal( ( this->quantity * this->price ) - oldExpenses );
+    emit expenseChangedSignal( getExpense( ) - oldExpenses );
 }
 
 /**
@@ -196,7 +199,7 @@ void BudgetPageExpenses::createExpenseUI(QVBoxLayout * vbox) {
     expenseObj_NameLineEdit->setText( * this->expenseName );
     expenseObj_DescriptionLineEdit->setText( * this->expenseDescription );
     expenseObj_QuantitySpinBox->setValue( this->quantity );
-    expenseObj_PriceSpinBox->setValue( this->price );
+    expenseObj_PriceSpinBox->setValue( this->price.toDouble( ) );
 
     //connects spin boxes to the expenseChanged slot - with a char to denote if it's the quantity or price
     connect( expenseObj_QuantitySpinBox , & QDoubleSpinBox::valueChanged , this ,
@@ -244,23 +247,18 @@ void BudgetPageExpenses::setCategoryIndex(int index) {
 }
 
 /**
- * @brief creates a csv entry with the expenses values
- * @return a QString with
- * name, description, quantity, price, category index
+ * @brief writes the expense as one csv row
+ * \n name, description, quantity, price, category index
+ * @param writer the csv writer to add the row to
  */
-QString BudgetPageExpenses::to_CSV() {
-    QString csv;
-    //adds name, description, quantity price, and category index to the qstring
-    csv.append( * this->expenseName );
-    csv.append( "," );
-    csv.append( * this->expenseDescription );
-    csv.append( "," );
-    csv.append( std::to_string( this->quantity ) );
-    csv.append( "," );
-    csv.append( std::to_string( this->price ) );
-    csv.append( "," );
-    csv.append( std::to_string( this->categoryIndex ) );
-    return csv;
+void BudgetPageExpenses::to_CSV(CsvWriter &writer) const {
+    //adds name, description, quantity price, and category index as separate fields
+    writer.addField( * this->expenseName );
+    writer.addField( * this->expenseDescription );
+    writer.addField( std::to_string( this->quantity ) );
+    writer.addField( this->price );
+    writer.addField( this->categoryIndex );
+    writer.endRow( );
 }
 
 /**
@@ -285,9 +283,9 @@ void BudgetPageExpenses::setExpenseDescription(const QString &description) {
  * @brief setter for price
  * @param price the price
  */
-void BudgetPageExpenses::setExpensePrice(double price) {
+void BudgetPageExpenses::setExpensePrice(Money price) {
     this->price = price;
-    this->expenseObj_PriceSpinBox->setValue( this->price );
+    this->expenseObj_PriceSpinBox->setValue( this->price.toDouble( ) );
 }
 
 /**
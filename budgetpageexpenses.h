@@ -10,6 +10,8 @@
 #include<QMainWindow>
 #include<QComboBox>
 #include<QJsonObject>
+#include "csvwriter.h"
+#include "money.h"
 
 #define SHOW_DEBUG_LOGS true
 
@@ -42,7 +44,7 @@ public:
      * @param categoryIndex the index of category
       * @author Katherine R
      */
-    BudgetPageExpenses(QObject * parent, const QString &name, const QString &description, double price, double quantity,
+    BudgetPageExpenses(QObject * parent, const QString &name, const QString &description, Money price, double quantity,
                        int       categoryIndex);
 
     /**
@@ -80,7 +82,7 @@ public:
      * @return price * quantity of expense item
       * @author Katherine R
      */
-    double getExpense() const;
+    Money getExpense() const;
 
     /**
      * @brief Creates the UI for the expense item
@@ -104,11 +106,12 @@ public:
     void setCategoryIndex(int index);
 
     /**
-     * @brief creates a csv entry with the expenses values
-     * @return a QString with
-     * name, description, quantity, price, category index
+     * @brief writes the expense as one csv row
+     * \n name, description, quantity, price, category index
+     * \n names and descriptions with commas or quotes are quoted
+     * @param writer the csv writer to add the row to
      */
-    QString to_CSV();
+    void to_CSV(CsvWriter &writer) const;
 
     /**
      * @brief setter for name
@@ -126,7 +129,7 @@ public:
  * @brief setter for price
  * @param price the price
  */
-    void setExpensePrice(double price);
+    void setExpensePrice(Money price);
 
     /**
  * @brief setter for quantity
@@ -141,7 +144,7 @@ public:
     void setCategoryindex(int categoryindex);
 
 signals:
-    void expenseChangedSignal(double delta);
+    void expenseChangedSignal(Money delta);
 
 public slots:
     /**
@@ -167,7 +170,7 @@ public slots:
     void onExpenseNameChangedSlot(const QString &newName) const;
 
 private:
-    double price;
+    Money price;
     double quantity;
     int    categoryIndex;
 
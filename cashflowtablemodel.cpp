@@ -0,0 +1,201 @@
+#include "cashflowtablemodel.h"
+
+/**
+ * @class cashflowtablemodel.cpp
+ * @brief Implements the table model over the CashflowTracking ledger.
+ */
+
+/**
+ * @brief Creates a model over a cashflow ledger.
+ * @param tracking The ledger to show.
+ * @param parent Parent QObject.
+ */
+CashflowTableModel::CashflowTableModel(CashflowTracking& tracking, QObject* parent)
+    : QAbstractTableModel(parent), tracking(tracking) {
+}
+
+int CashflowTableModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0; // Flat table, no children
+    }
+    return static_cast<int>(tracking.entryCount());
+}
+
+int CashflowTableModel::columnCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return ColumnCount;
+}
+
+/**
+ * @brief Formats one cell of a transaction.
+ *
+ * Only called for the cells the view is painting, so the cost does not grow
+ * with the size of the ledger.
+ *
+ * @param index The cell.
+ * @param role The requested role.
+ * @return The cell value.
+ */
+QVariant CashflowTableModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() < 0 || static_cast<std::size_t>(index.row()) >= tracking.entryCount()) {
+        return QVariant();
+    }
+
+    if (role == Qt::TextAlignmentRole && index.column() == CostColumn) {
+        return QVariant(Qt::AlignRight | Qt::AlignVCenter); // Line up the decimals
+    }
+    if (role != Qt::DisplayRole && role != Qt::EditRole) {
+        return QVariant();
+    }
+
+    const DataEntry& entry = tracking.entryAt(static_cast<std::size_t>(index.row())); // Never squeezes out removed slots
+    switch (index.column()) {
+    case IdColumn:
+        return entry.transid;
+    case DateTimeColumn:
+        return QString::fromStdString(entry.dateTime);
+    case SellerColumn:
+        return QString::fromStdString(entry.seller);
+    case BuyerColumn:
+        return QString::fromStdString(entry.buyer);
+    case MerchandiseColumn:
+        return QString::fromStdString(entry.merchandise);
+    case CostColumn:
+        return entry.cost.toQString(); // Formatted to 2 decimal places
+    case CategoryColumn:
+        return QString::fromStdString(entry.category);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant CashflowTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        static const char* const titles[ColumnCount] = {
+            "ID", "Date/Time", "Seller", "Buyer", "Merchandise", "Cost", "Category"
+        };
+        if (section >= 0 && section < ColumnCount) {
+            return QString::fromLatin1(titles[section]);
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+Qt::ItemFlags CashflowTableModel::flags(const QModelIndex& index) const {
+    Qt::ItemFlags itemFlags = QAbstractTableModel::flags(index);
+    if (index.isValid() && index.column() != IdColumn) {
+        itemFlags |= Qt::ItemIsEditable; // The ID is what journal records refer to, it never changes
+    }
+    return itemFlags;
+}
+
+/**
+ * @brief Changes one field of a transaction from an edited cell.
+ *
+ * The edited transaction is copied, the field is replaced and the copy goes
+ * back through CashflowTracking::updateData(). Only that row is repainted.
+ *
+ * @param index The cell.
+ * @param value The new text of the cell.
+ * @param role Only Qt::EditRole is handled.
+ * @return True if the transaction was changed, false otherwise.
+ */
+bool CashflowTableModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+    if (role != Qt::EditRole || !index.isValid() || index.row() < 0
+        || static_cast<std::size_t>(index.row()) >= tracking.entryCount()) {
+        return false;
+    }
+
+    // Same rules as the add dialog: no empty fields, and the cost must be a plain amount
+    const QString text = value.toString().trimmed();
+    if (text.isEmpty()) {
+        return false;
+    }
+    DataEntry entry = tracking.entryAt(static_cast<std::size_t>(index.row()));
+    switch (index.column()) {
+    case DateTimeColumn:
+        entry.dateTime = text.toStdString();
+        break;
+    case SellerColumn:
+        entry.seller = text.toStdString();
+        break;
+    case BuyerColumn:
+        entry.buyer = text.toStdString();
+        break;
+    case MerchandiseColumn:
+        entry.merchandise = text.toStdString();
+        break;
+    case CostColumn: {
+        bool isCostValid;
+        entry.cost = Money::parse(text.toStdString(), &isCostValid);
+        if (!isCostValid) {
+            return false;
+        }
+        break;
+    }
+    case CategoryColumn:
+        entry.category = text.toStdString();
+        break;
+    default:
+        return false; // The ID is not editable
+    }
+
+    if (!tracking.updateData(entry)) {
+        return false;
+    }
+    emit dataChanged(this->index(index.row(), 0), this->index(index.row(), ColumnCount - 1));
+    emit transactionUpdated(entry.transid);
+    return true;
+}
+
+/**
+ * @brief Adds a transaction to the ledger and inserts its row in the views.
+ *
+ * New transactions always go to the end, so the views only lay out one new row.
+ *
+ * @return The ID the new transaction was given.
+ */
+int CashflowTableModel::addData(const std::string& dateTime, const std::string& seller, const std::string& buyer,
+    const std::string& merchandise, Money cost, const std::string& category) {
+    const int transID = tracking.nextTransactionId();
+    int row = rowCount();
+    beginInsertRows(QModelIndex(), row, row);
+    tracking.addData(dateTime, seller, buyer, merchandise, cost, category);
+    endInsertRows();
+    return transID;
+}
+
+/**
+ * @brief Removes a transaction from the ledger and its row from the views.
+ *
+ * The row is found through the ID index and the ledger's count of removed
+ * slots, so nothing is compacted and the cost does not grow with the ledger.
+ *
+ * @param transID ID of the transaction to remove.
+ * @return True if the transaction existed, false otherwise.
+ */
+bool CashflowTableModel::removeData(int transID) {
+    // Rows are positions in the ledger's list of live entries
+    const long long position = tracking.positionOf(transID);
+    if (position < 0) {
+        return false;
+    }
+
+    int row = static_cast<int>(position);
+    beginRemoveRows(QModelIndex(), row, row);
+    tracking.removeData(transID);
+    endRemoveRows();
+    return true;
+}
+
+/**
+ * @brief Changes the ledger in bulk and resets the views around it.
+ * @param mutate Makes the change to the ledger.
+ */
+void CashflowTableModel::refresh(const std::function<void()>& mutate) {
+    beginResetModel(); // Must come before the ledger changes, the views may still read the old rows
+    mutate();
+    endResetModel();
+}
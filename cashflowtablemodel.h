@@ -0,0 +1,132 @@
+#ifndef CASHFLOWTABLEMODEL_H
+#define CASHFLOWTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <functional>
+#include "cashflowtracking.h"
+
+/**
+ * @class CashflowTableModel
+ * @brief Table model that shows the transactions of a CashflowTracking directly.
+ *
+ * The model keeps no copy of the data: every cell is formatted from the stored
+ * DataEntry when the view asks for it, and a QTableView only asks for the rows
+ * that are on screen. Adding or removing a transaction through the model
+ * notifies the view about that single row instead of rebuilding the table.
+ * Every column but the ID can be edited in place; the change goes through
+ * CashflowTracking::updateData(), so the ledger's indexes and totals follow it.
+ */
+class CashflowTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Columns shown by the model, in display order.
+     */
+    enum Column {
+        IdColumn,
+        DateTimeColumn,
+        SellerColumn,
+        BuyerColumn,
+        MerchandiseColumn,
+        CostColumn,
+        CategoryColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief Creates a model over a cashflow ledger.
+     * @param tracking The ledger to show; it must outlive the model.
+     * @param parent Parent QObject.
+     */
+    explicit CashflowTableModel(CashflowTracking& tracking, QObject* parent = nullptr);
+
+    /**
+     * @brief Gets the number of transactions.
+     * @param parent Unused, the model is flat.
+     * @return The row count.
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief Gets the number of columns.
+     * @param parent Unused, the model is flat.
+     * @return ColumnCount.
+     */
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief Formats one cell of a transaction.
+     * @param index The cell.
+     * @param role The requested role; display and alignment are supported.
+     * @return The cell value, or an invalid QVariant.
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Gets the column titles.
+     * @param section The column or row number.
+     * @param orientation Horizontal for column titles.
+     * @param role The requested role.
+     * @return The title, or the default header data.
+     */
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Gets the item flags of a cell.
+     * @param index The cell.
+     * @return The default flags, plus editable for every column but the ID.
+     */
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /**
+     * @brief Changes one field of a transaction from an edited cell.
+     * @param index The cell.
+     * @param value The new text of the cell.
+     * @param role Only Qt::EditRole is handled.
+     * @return True if the transaction was changed, false if the value was empty or not a valid cost.
+     */
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
+    /**
+     * @brief Adds a transaction to the ledger and inserts its row in the views.
+     * @param dateTime Date and time of the transaction.
+     * @param seller Name of the seller.
+     * @param buyer Name of the buyer.
+     * @param merchandise Purchased merchandise.
+     * @param cost Cost of the transaction.
+     * @param category Category to store the transaction under.
+     * @return The ID the new transaction was given.
+     */
+    int addData(const std::string& dateTime, const std::string& seller, const std::string& buyer,
+        const std::string& merchandise, Money cost, const std::string& category);
+
+    /**
+     * @brief Removes a transaction from the ledger and its row from the views.
+     * @param transID ID of the transaction to remove.
+     * @return True if the transaction existed, false otherwise.
+     */
+    bool removeData(int transID);
+
+    /**
+     * @brief Changes the ledger in bulk, e.g. by loading a file, and resets the views around it.
+     *
+     * The views are told before the ledger changes, so none of them reads a
+     * row that no longer exists while the change is in progress.
+     *
+     * @param mutate Makes the change to the ledger.
+     */
+    void refresh(const std::function<void()>& mutate);
+
+signals:
+    /**
+     * @brief Emitted after a transaction was changed through setData().
+     * @param transID ID of the changed transaction.
+     */
+    void transactionUpdated(int transID);
+
+private:
+    CashflowTracking& tracking; // The ledger being shown.
+};
+
+#endif // CASHFLOWTABLEMODEL_H
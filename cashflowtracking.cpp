@@ -1,5 +1,7 @@
 #include "cashflowtracking.h"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 
 /**
  * @class cashflowtracking.cpp
@@ -22,52 +24,606 @@
      * @param category Category to store transaction under.
      *
      * This function assigns a unique transaction ID to each entry and stores it
-     * in the dataEntries vector. It also updates the category mapping.
+     * in the dataEntries vector. It also updates the ID, category and date indexes.
      */
 void CashflowTracking::addData(const std::string& dateTime, const std::string& seller,
     const std::string& buyer, const std::string& merchandise, 
-    double cost, const std::string& category) {
+    Money cost, const std::string& category) {
     // Create a new DataEntry object and add it to the dataEntries vector
-    DataEntry data = { dataCounter++, dateTime, seller, buyer, merchandise, cost, category };
+    DataEntry data = { dataCounter, dateTime, seller, buyer, merchandise, cost, category };
+    restoreData(data);
+}
+
+/**
+     * @brief Puts back a transaction that was saved earlier, keeping its ID.
+     * @param data The saved transaction.
+     * @return True if it was added, false if a transaction with that ID already exists.
+     */
+bool CashflowTracking::restoreData(const DataEntry& data) {
+    if (data.transid > 0 && idIndex.count(data.transid) != 0) {
+        return false; // Already present, e.g. a journal record that the snapshot covers
+    }
+
     dataEntries.push_back(data);
-    categories[category].push_back(data.transid); // Add the transaction ID to the category's list
+    DataEntry& stored = dataEntries.back();
+    if (stored.transid <= 0) {
+        stored.transid = dataCounter; // Old files without IDs
+    }
+    if (stored.transid >= dataCounter) {
+        dataCounter = stored.transid + 1; // New IDs never reuse a restored one
+    }
+
+    idIndex[stored.transid] = dataEntries.size() - 1;
+    appendRemovedTreeNode();
+    addDerivedKeys(dataEntries.size() - 1); // Adds it to its date and category
+    addToTotals(stored);
+    return true;
 }
 /**
      * @brief Searches for a transaction by its ID.
      * @param transID Unique transaction ID to search for.
      * @return Pointer to the found DataEntry, or nullptr if not found.
      *
-     * This function iterates through the stored transactions and returns
-     * a pointer to the matching transaction if found.
+     * The position of the transaction is looked up in the ID index, so this
+     * takes constant time.
+     */
+const DataEntry* CashflowTracking::searchDataEntries(int transID) const {
+    auto found = idIndex.find(transID);
+    if (found == idIndex.end()) {
+        return nullptr; // Return nullptr if no matching entry is found
+    }
+    return &dataEntries[found->second]; // Return a pointer to the matching entry
+}
+
+/**
+     * @brief Changes the fields of a stored transaction.
+     * @param data The new fields; data.transid selects the transaction.
+     * @return True if the transaction existed, false otherwise.
+     */
+bool CashflowTracking::updateData(const DataEntry& data) {
+    auto found = idIndex.find(data.transid);
+    if (found == idIndex.end()) {
+        return false; // Nothing to update
+    }
+    const std::size_t position = found->second;
+    DataEntry& stored = dataEntries[position];
+    removeFromTotals(stored);
+
+    // Buckets hold positions in ascending order, so the entry is found and placed by binary search
+    auto dropPosition = [position](std::vector<std::size_t>& positions) {
+        auto at = std::lower_bound(positions.begin(), positions.end(), position);
+        if (at != positions.end() && *at == position) {
+            positions.erase(at);
+        }
+    };
+    auto insertPosition = [position](std::vector<std::size_t>& positions) {
+        positions.insert(std::lower_bound(positions.begin(), positions.end(), position), position);
+    };
+
+    const int day = dayNumber(data.dateTime);
+    if (day != stored.day) {
+        auto oldDay = dayBuckets.find(stored.day);
+        if (oldDay != dayBuckets.end()) {
+            dropPosition(oldDay->second);
+            if (oldDay->second.empty()) {
+                dayBuckets.erase(oldDay); // Do not keep empty days around
+            }
+        }
+        if (day != InvalidDay) {
+            insertPosition(dayBuckets[day]);
+        }
+    }
+
+    const int categoryCode = internCategory(data.category);
+    if (categoryCode != stored.categoryCode) {
+        dropPosition(categoryBuckets[static_cast<std::size_t>(stored.categoryCode)].positions);
+        insertPosition(categoryBuckets[static_cast<std::size_t>(categoryCode)].positions);
+    }
+
+    stored.dateTime = data.dateTime;
+    stored.seller = data.seller;
+    stored.buyer = data.buyer;
+    stored.merchandise = data.merchandise;
+    stored.cost = data.cost;
+    stored.category = data.category;
+    stored.day = day;
+    stored.categoryCode = categoryCode;
+    addToTotals(stored);
+    return true;
+}
+
+/**
+     * @brief Gets the row of a transaction among the live entries.
+     * @param transID Unique transaction ID to look up.
+     * @return Its row, as used by entryAt() and getAllDataEntries(), or -1 if not found.
+     */
+long long CashflowTracking::positionOf(int transID) const {
+    auto found = idIndex.find(transID);
+    if (found == idIndex.end()) {
+        return -1;
+    }
+    // The removed slots in front of it do not count as rows
+    return static_cast<long long>(found->second - removedBefore(found->second));
+}
+
+std::size_t CashflowTracking::entryCount() const {
+    return idIndex.size();
+}
+
+/**
+     * @brief Gets a transaction by its row among the live entries.
+     * @param row The row, below entryCount().
+     * @return The transaction.
+     */
+const DataEntry& CashflowTracking::entryAt(std::size_t row) const {
+    return dataEntries[removedEntries == 0 ? row : positionOfRow(row)];
+}
+
+/**
+     * @brief Adds the Fenwick tree node of the slot just appended to dataEntries.
+     *
+     * Node k (counting from 1) holds the number of removed slots among the
+     * lowbit(k) slots that end at slot k. The new slot itself is live.
+     */
+void CashflowTracking::appendRemovedTreeNode() {
+    const std::size_t node = dataEntries.size();
+    std::uint32_t removed = 0;
+    if (removedEntries > 0) {
+        removed = static_cast<std::uint32_t>(removedBefore(node - 1) - removedBefore(node - (node & (~node + 1))));
+    }
+    removedTree.push_back(removed);
+}
+
+/**
+     * @brief Counts the removed slots in front of a slot.
+     * @param position Position in dataEntries.
+     * @return The number of removed slots before it.
+     */
+std::size_t CashflowTracking::removedBefore(std::size_t position) const {
+    if (removedEntries == 0) {
+        return 0;
+    }
+    std::size_t removed = 0;
+    for (std::size_t node = position; node > 0; node -= node & (~node + 1)) {
+        removed += removedTree[node - 1];
+    }
+    return removed;
+}
+
+/**
+     * @brief Finds the slot that holds a row of the live entries.
+     * @param row Row among the live entries.
+     * @return Its position in dataEntries.
+     *
+     * Walks down the Fenwick tree from its largest power of two, skipping every
+     * node whose live slots all come before the row.
      */
-DataEntry* CashflowTracking::searchDataEntries(int transID) {
-    for (auto& data : dataEntries) {
-        if (data.transid == transID) { // Check if the current entry matches the transaction ID
-            return &data; // Return a pointer to the matching entry
+std::size_t CashflowTracking::positionOfRow(std::size_t row) const {
+    std::size_t step = 1;
+    while (step * 2 <= removedTree.size()) {
+        step *= 2;
+    }
+    std::size_t position = 0;        // Slots passed so far
+    std::size_t remaining = row + 1; // Live slots still to pass, including the row itself
+    for (; step > 0; step /= 2) {
+        const std::size_t node = position + step;
+        if (node <= removedTree.size()) {
+            const std::size_t live = step - removedTree[node - 1];
+            if (live < remaining) {
+                position = node;
+                remaining -= live;
+            }
+        }
+    }
+    return position;
+}
+
+/**
+     * @brief Removes a transaction and drops it from every index.
+     * @param transID Unique transaction ID to remove.
+     * @return True if the transaction existed, false otherwise.
+     */
+bool CashflowTracking::removeData(int transID) {
+    auto found = idIndex.find(transID);
+    if (found == idIndex.end()) {
+        return false; // Nothing to remove
+    }
+    std::size_t position = found->second;
+    idIndex.erase(found);
+    removeFromTotals(dataEntries[position]);
+
+    // Leave an empty slot behind; the date and category buckets skip it until the next compaction
+    dataEntries[position] = DataEntry{};
+    removedEntries++;
+    for (std::size_t node = position + 1; node <= removedTree.size(); node += node & (~node + 1)) {
+        removedTree[node - 1]++; // Every node covering the slot counts one more removed slot
+    }
+    if (removedEntries > 64 && removedEntries * 2 > dataEntries.size()) {
+        compactEntries(); // Amortized: at least as many removes as live entries happened since the last one
+    }
+    return true;
+}
+
+/**
+     * @brief Squeezes the removed slots out of dataEntries and renumbers every index.
+     *
+     * The live entries keep their order. Every bucket is renumbered in the same
+     * pass, dropping the positions of removed slots.
+     */
+void CashflowTracking::compactEntries() const {
+    const std::size_t removed = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> newPosition(dataEntries.size(), removed); // Old position -> new one
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < dataEntries.size(); ++i) {
+        if (dataEntries[i].transid == 0) {
+            continue; // Removed slot
+        }
+        newPosition[i] = kept;
+        if (i != kept) {
+            dataEntries[kept] = std::move(dataEntries[i]);
         }
+        idIndex[dataEntries[kept].transid] = kept;
+        kept++;
     }
-    return nullptr; // Return nullptr if no matching entry is found
+    dataEntries.resize(kept);
+    removedEntries = 0;
+    removedTree.assign(kept, 0); // No removed slots left to count
+
+    // Buckets keep their order, so the entries of a day or category stay in the order they were added
+    auto renumber = [&newPosition, removed](std::vector<std::size_t>& positions) {
+        std::size_t out = 0;
+        for (std::size_t position : positions) {
+            if (newPosition[position] != removed) {
+                positions[out++] = newPosition[position];
+            }
+        }
+        positions.resize(out);
+    };
+    for (auto bucket = dayBuckets.begin(); bucket != dayBuckets.end();) {
+        renumber(bucket->second);
+        bucket = bucket->second.empty() ? dayBuckets.erase(bucket) : std::next(bucket); // Do not keep empty days around
+    }
+    for (CategoryBucket& category : categoryBuckets) {
+        renumber(category.positions); // Codes are never released, an empty category keeps its code
+    }
+}
+
+/**
+     * @brief Removes every transaction and empties the indexes.
+     */
+void CashflowTracking::clear() {
+    dataEntries.clear();
+    removedTree.clear();
+    idIndex.clear();
+    dayBuckets.clear();
+    categoryBuckets.clear();
+    categoryCodes.clear();
+    removedEntries = 0;
+    dataCounter = 1;
+    ledgerTotal = LedgerAggregate();
+    categoryTotals.clear();
+    monthTotals.clear();
 }
+
+/**
+     * @brief Replaces the whole ledger with entries and indexes loaded in bulk.
+     * @param entries The transactions, in ledger order, with their day numbers and category codes filled in.
+     * @param days Day number -> positions in entries.
+     * @param categories Category code -> name and positions in entries.
+     * @param nextId The ID the next addData() call will use.
+     */
+void CashflowTracking::assignData(std::vector<DataEntry>&& entries, std::map<int, std::vector<std::size_t>>&& days,
+    std::vector<CategoryBucket>&& categories, int nextId) {
+    dataEntries = std::move(entries);
+    dayBuckets = std::move(days);
+    categoryBuckets = std::move(categories);
+    removedEntries = 0;
+    removedTree.assign(dataEntries.size(), 0);
+
+    // One lookup entry per distinct category, not per transaction
+    categoryCodes.clear();
+    categoryCodes.reserve(categoryBuckets.size());
+    for (std::size_t code = 0; code < categoryBuckets.size(); ++code) {
+        categoryCodes.emplace(categoryBuckets[code].name, static_cast<int>(code));
+    }
+
+    // Sized once up front, so filling it never rehashes
+    idIndex.clear();
+    idIndex.reserve(dataEntries.size());
+    dataCounter = nextId;
+
+    // The running totals are not stored in snapshots, they are summed up here in the same pass
+    ledgerTotal = LedgerAggregate();
+    categoryTotals.clear();
+    monthTotals.clear();
+    for (std::size_t i = 0; i < dataEntries.size(); ++i) {
+        idIndex[dataEntries[i].transid] = i;
+        if (dataEntries[i].transid >= dataCounter) {
+            dataCounter = dataEntries[i].transid + 1;
+        }
+        addToTotals(dataEntries[i]);
+    }
+}
+
+const std::map<int, std::vector<std::size_t>>& CashflowTracking::dayIndex() const {
+    if (removedEntries > 0) {
+        compactEntries();
+    }
+    return dayBuckets;
+}
+
+const std::vector<CashflowTracking::CategoryBucket>& CashflowTracking::categoryIndex() const {
+    if (removedEntries > 0) {
+        compactEntries();
+    }
+    return categoryBuckets;
+}
+
+int CashflowTracking::nextTransactionId() const {
+    return dataCounter;
+}
+
+const LedgerAggregate& CashflowTracking::totals() const {
+    return ledgerTotal;
+}
+
+/**
+     * @brief Gets the running total of one category.
+     * @param category The category to look up.
+     * @return Sum and count of its transactions, zero if none.
+     */
+LedgerAggregate CashflowTracking::categoryTotal(const std::string& category) const {
+    auto found = categoryTotals.find(category);
+    return found == categoryTotals.end() ? LedgerAggregate() : found->second;
+}
+
+/**
+     * @brief Gets the running total of one month.
+     * @param month The month, e.g. "2025-03".
+     * @return Sum and count of its transactions, zero if none.
+     */
+LedgerAggregate CashflowTracking::monthTotal(const std::string& month) const {
+    auto found = monthTotals.find(month);
+    return found == monthTotals.end() ? LedgerAggregate() : found->second;
+}
+
+const std::unordered_map<std::string, LedgerAggregate>& CashflowTracking::categoryTotalsMap() const {
+    return categoryTotals;
+}
+
+/**
+     * @brief Gets the IDs of all transactions in a category.
+     *
+     * One hash lookup finds the category's bucket; only its own entries are read.
+     *
+     * @param category The category to look up, compared exactly.
+     * @return The transaction IDs, empty if none.
+     */
+std::vector<int> CashflowTracking::searchByCategory(const std::string& category) const {
+    std::vector<int> ids;
+    auto found = categoryCodes.find(category);
+    if (found == categoryCodes.end()) {
+        return ids;
+    }
+    const std::vector<std::size_t>& positions = categoryBuckets[static_cast<std::size_t>(found->second)].positions;
+    ids.reserve(positions.size());
+    for (std::size_t position : positions) {
+        if (dataEntries[position].transid != 0) {
+            ids.push_back(dataEntries[position].transid); // Removed slots have ID 0
+        }
+    }
+    return ids;
+}
+
+/**
+     * @brief Gets the IDs of all transactions on a date.
+     * @param date The date, "yyyy-mm-dd".
+     * @return The transaction IDs, empty if none or the date is not valid.
+     */
+std::vector<int> CashflowTracking::searchByDate(const std::string& date) const {
+    std::vector<int> ids;
+    forEachInDateRange(dayNumber(date), dayNumber(date), std::string(), [&ids](const DataEntry& data) {
+        ids.push_back(data.transid);
+    });
+    return ids;
+}
+
+/**
+     * @brief Gets the date part of a date and time.
+     * @param dateTime Date and time as entered.
+     * @return The text before the first space, comma or 'T'.
+     */
+std::string CashflowTracking::dateKey(const std::string& dateTime) {
+    return dateTime.substr(0, dateTime.find_first_of(" ,T")); // The add dialog asks for "yyyy-mm-dd, hh:mm"
+}
+
+/**
+     * @brief Converts a calendar date into a day number.
+     * @param year The year.
+     * @param month The month, 1 to 12.
+     * @param day The day of the month, 1 to 31.
+     * @return Days since 1970-01-01.
+     */
+int CashflowTracking::dayNumber(int year, int month, int day) {
+    // Count from March, so the leap day is the last day of the counting year
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+     * @brief Parses the date at the start of a date and time into a day number.
+     * @param dateTime Date and time as entered, starting with "yyyy-mm-dd".
+     * @return The day number, or InvalidDay if there is no valid date.
+     */
+int CashflowTracking::dayNumber(const std::string& dateTime) {
+    if (dateTime.size() < 10 || dateTime[4] != '-' || dateTime[7] != '-') {
+        return InvalidDay;
+    }
+    auto digits = [&dateTime](std::size_t from, std::size_t count) {
+        int value = 0;
+        for (std::size_t i = from; i < from + count; ++i) {
+            if (dateTime[i] < '0' || dateTime[i] > '9') {
+                return -1;
+            }
+            value = value * 10 + (dateTime[i] - '0');
+        }
+        return value;
+    };
+    const int year = digits(0, 4);
+    const int month = digits(5, 2);
+    const int day = digits(8, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1) {
+        return InvalidDay;
+    }
+
+    static const int daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    const bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (day > daysInMonth[month - 1] + (month == 2 && leapYear ? 1 : 0)) {
+        return InvalidDay;
+    }
+    return dayNumber(year, month, day);
+}
+
+/**
+     * @brief Fills in the day number and category code of a stored entry and adds it to the date and category indexes.
+     * @param position Position of the entry in dataEntries.
+     */
+void CashflowTracking::addDerivedKeys(std::size_t position) {
+    DataEntry& data = dataEntries[position];
+    data.day = dayNumber(data.dateTime);
+    if (data.day != InvalidDay) {
+        dayBuckets[data.day].push_back(position);
+    }
+
+    data.categoryCode = internCategory(data.category);
+    categoryBuckets[static_cast<std::size_t>(data.categoryCode)].positions.push_back(position);
+}
+
+/**
+     * @brief Gets the code of a category, interning it if it is new.
+     * @param category The category.
+     * @return Its code.
+     */
+int CashflowTracking::internCategory(const std::string& category) {
+    // Codes are never released, so a category keeps one code for the ledger's lifetime
+    auto inserted = categoryCodes.emplace(category, static_cast<int>(categoryBuckets.size()));
+    if (inserted.second) {
+        categoryBuckets.push_back(CategoryBucket{ category, {} });
+    }
+    return inserted.first->second;
+}
+
+/**
+     * @brief Lowercases a category so differently cased spellings can be compared.
+     * @param category The category.
+     * @return The category with ASCII letters lowercased.
+     */
+std::string CashflowTracking::foldCase(const std::string& category) {
+    std::string folded = category;
+    for (char& c : folded) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return folded;
+}
+
+/**
+     * @brief Finds the category codes whose names match a category, ignoring case.
+     *
+     * Looks at each distinct category once, not at the entries.
+     *
+     * @param category The category.
+     * @return One flag per category code, true where the name matches.
+     */
+std::vector<bool> CashflowTracking::categoryCodesMatching(const std::string& category) const {
+    const std::string folded = foldCase(category);
+    std::vector<bool> matching(categoryBuckets.size(), false);
+    for (std::size_t code = 0; code < categoryBuckets.size(); ++code) {
+        matching[code] = foldCase(categoryBuckets[code].name) == folded;
+    }
+    return matching;
+}
+
+/**
+     * @brief Gets the month part of a date and time, used as the month total key.
+     * @param dateTime Date and time as entered.
+     * @return The first seven characters of the date part.
+     */
+std::string CashflowTracking::monthKey(const std::string& dateTime) {
+    return dateKey(dateTime).substr(0, 7); // "yyyy-mm-dd" -> "yyyy-mm"
+}
+
+/**
+     * @brief Adds a transaction to the running totals.
+     * @param data The transaction.
+     */
+void CashflowTracking::addToTotals(const DataEntry& data) {
+    ledgerTotal.total += data.cost;
+    ledgerTotal.count++;
+
+    LedgerAggregate& category = categoryTotals[data.category];
+    category.total += data.cost;
+    category.count++;
+
+    LedgerAggregate& month = monthTotals[monthKey(data.dateTime)];
+    month.total += data.cost;
+    month.count++;
+}
+
+/**
+     * @brief Takes a transaction out of the running totals.
+     *
+     * Groups left without transactions are dropped, like empty index buckets.
+     *
+     * @param data The transaction.
+     */
+void CashflowTracking::removeFromTotals(const DataEntry& data) {
+    ledgerTotal.total -= data.cost;
+    ledgerTotal.count--;
+
+    auto subtract = [&data](std::unordered_map<std::string, LedgerAggregate>& groups, const std::string& key) {
+        auto group = groups.find(key);
+        if (group == groups.end()) {
+            return;
+        }
+        group->second.total -= data.cost;
+        if (--group->second.count == 0) {
+            groups.erase(group);
+        }
+    };
+    subtract(categoryTotals, data.category);
+    subtract(monthTotals, monthKey(data.dateTime));
+}
+
 /**
      * @brief Lists all stored transactions.
      *
      * Iterates through the transaction records and prints details.
      */
 void CashflowTracking::listDataEntries() {
-    for (const auto& data : dataEntries) {
+    forEachDataEntry([](const DataEntry& data) {
         // Print details of each transaction in the dataEntries vector
         std::cout << "ID: " << data.transid << ", Date/Time: " << data.dateTime
             << ", Buyer: " << data.buyer << ", Seller: " << data.seller
-            << ", Merchandise: " << data.merchandise << ", Cost: $" << data.cost
+            << ", Merchandise: " << data.merchandise << ", Cost: $" << data.cost.toString()
             << ", Category: " << data.category << "\n";
-    }
+    });
 }
 /**
      * @brief Retrieves all stored transaction records.
-     * @return A vector containing all DataEntry objects.
+     * @return A read-only reference to the stored DataEntry objects.
      *
      * This function provides external access to the full transaction list
+     * without copying it. Slots left by removals are squeezed out first.
      */
-std::vector<DataEntry> CashflowTracking::getAllDataEntries() {
+const std::vector<DataEntry>& CashflowTracking::getAllDataEntries() const {
+    if (removedEntries > 0) {
+        compactEntries();
+    }
     return dataEntries;
 }
\ No newline at end of file
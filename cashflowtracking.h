@@ -1,9 +1,14 @@
 #ifndef CASHFLOWTRACKING_H
 #define CASHFLOWTRACKING_H
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <limits>
+#include <map>
 #include <unordered_map>
+#include "money.h"
 
 /**
  * @class cashflowtracking.h
@@ -11,7 +16,8 @@
  *
  * This file contains the declaration of the CashflowTracking class, which provides
  * functionalities for adding, searching, and listing transactions.
- * Transactions stored in vector, and categories mapped to their respective transaction IDs.
+ * Transactions stored in vector, with a hash index from transaction ID to position
+ * and one index each for category and date.
  *
  * * @author Abbygail Latimer
  */
@@ -25,13 +31,24 @@
 
  */
 struct DataEntry {
-    int transid;                ///< Unique transaction ID.
+    int transid = 0;            ///< Unique transaction ID, 0 in a removed slot.
     std::string dateTime;       ///< Date and time of the transaction.
     std::string seller;         ///< Name of the seller.
     std::string buyer;          ///< Name of the buyer.
     std::string merchandise;    ///< Description of the merchandise involved.
-    double cost;                ///< Cost of the transaction.
+    Money cost;                 ///< Cost of the transaction, in exact cents.
     std::string category;       ///< Category of the transaction (e.g., sales, expenses).
+    int day = 0;                ///< Date as a day number, filled in by CashflowTracking when stored.
+    int categoryCode = -1;      ///< Interned category, filled in by CashflowTracking when stored.
+};
+
+/**
+ * @struct LedgerAggregate
+ * @brief Running total of a group of transactions.
+ */
+struct LedgerAggregate {
+    Money total;                ///< Sum of the costs in the group.
+    std::size_t count = 0;      ///< Number of transactions in the group.
 };
 
 /**
@@ -40,14 +57,149 @@ struct DataEntry {
  *
  * The class provides methods to add, search, and list transactions.
  * It maintains a record of transactions and categorizes them.
+ *
+ * Lookups by ID go through a hash index kept next to the vector, so they take
+ * constant time no matter how many entries are stored.
+ *
+ * Every stored entry gets its date parsed once into a day number and its
+ * category interned as a small code. There is one index per field: a day ->
+ * positions map kept in date order, which lets searchByDate() and
+ * forEachInDateRange() go straight to the days they need, and a code ->
+ * positions table for the categories.
+ *
+ * Removing an entry only marks its slot as removed, so it takes constant time
+ * and later entries do not move. The removed slots are squeezed out in one pass
+ * once they make up half of the vector, or when the whole list is asked for
+ * through getAllDataEntries(), so replaying k removals costs O(N + k). Until
+ * then a Fenwick tree counts the removed slots, so entryAt() and positionOf()
+ * map between rows and slots in O(log N) without squeezing anything out.
+ *
+ * Totals of the whole ledger, of every category and of every month are kept
+ * as running aggregates, updated in constant time by every add and remove, so
+ * reading them never rescans the entries.
  */
 class CashflowTracking {
+public:
+    /**
+     * @brief One interned category and the positions of its entries.
+     */
+    struct CategoryBucket {
+        std::string name;                   ///< The category, as stored.
+        std::vector<std::size_t> positions; ///< Positions in the ledger, in the order they were added.
+    };
+
 private:
-    std::vector<DataEntry> dataEntries;
-    std::unordered_map<std::string, std::vector<int>> categories;
+    // Compacting the removed slots away is invisible to readers, so the const accessors may do it
+    mutable std::vector<DataEntry> dataEntries;                         // Entries in order; removed slots have transid 0.
+    mutable std::unordered_map<int, std::size_t> idIndex;               // Transaction ID -> position in dataEntries.
+    mutable std::map<int, std::vector<std::size_t>> dayBuckets;         // Day number -> positions, in date order.
+    mutable std::vector<CategoryBucket> categoryBuckets;                // Category code -> name and positions.
+    mutable std::size_t removedEntries = 0;                             // Removed slots still in dataEntries.
+    mutable std::vector<std::uint32_t> removedTree;                     // Fenwick tree of removed slots, one node per slot.
+    std::unordered_map<std::string, int> categoryCodes;                 // Category -> interned code.
     int dataCounter = 1;
+    LedgerAggregate ledgerTotal;                                       // All transactions.
+    std::unordered_map<std::string, LedgerAggregate> categoryTotals;  // Category -> running total.
+    std::unordered_map<std::string, LedgerAggregate> monthTotals;     // Month ("yyyy-mm") -> running total.
+
+    /**
+     * @brief Gets the month part of a date and time, used as the month total key.
+     * @param dateTime Date and time as entered, e.g. "2025-03-01 14:30".
+     * @return The first seven characters of the date, e.g. "2025-03".
+     */
+    static std::string monthKey(const std::string& dateTime);
+
+    /**
+     * @brief Fills in the day number and category code of a stored entry and adds it to the date and category indexes.
+     * @param position Position of the entry in dataEntries.
+     */
+    void addDerivedKeys(std::size_t position);
+
+    /**
+     * @brief Gets the code of a category, interning it if it is new.
+     * @param category The category.
+     * @return Its code, an index into categoryBuckets.
+     */
+    int internCategory(const std::string& category);
+
+    /**
+     * @brief Lowercases a category so differently cased spellings can be compared.
+     * @param category The category.
+     * @return The category with ASCII letters lowercased.
+     */
+    static std::string foldCase(const std::string& category);
+
+    /**
+     * @brief Finds the category codes whose names match a category, ignoring case.
+     * @param category The category.
+     * @return One flag per category code, true where the name matches.
+     */
+    std::vector<bool> categoryCodesMatching(const std::string& category) const;
+
+    /**
+     * @brief Squeezes the removed slots out of dataEntries and renumbers every index.
+     *
+     * One pass over the entries and the index buckets, so it costs O(N).
+     */
+    void compactEntries() const;
+
+    /**
+     * @brief Adds the Fenwick tree node of the slot just appended to dataEntries.
+     */
+    void appendRemovedTreeNode();
+
+    /**
+     * @brief Counts the removed slots in front of a slot.
+     * @param position Position in dataEntries.
+     * @return The number of removed slots before it, in O(log N).
+     */
+    std::size_t removedBefore(std::size_t position) const;
+
+    /**
+     * @brief Finds the slot that holds a row of the live entries.
+     * @param row Row among the live entries, below entryCount().
+     * @return Its position in dataEntries, in O(log N).
+     */
+    std::size_t positionOfRow(std::size_t row) const;
+
+    /**
+     * @brief Adds a transaction to the running totals.
+     * @param data The transaction.
+     */
+    void addToTotals(const DataEntry& data);
+
+    /**
+     * @brief Takes a transaction out of the running totals.
+     * @param data The transaction.
+     */
+    void removeFromTotals(const DataEntry& data);
+
+    /**
+     * @brief Gets the date part of a date and time.
+     * @param dateTime Date and time as entered, e.g. "2025-03-01 14:30".
+     * @return The text before the first space, comma or 'T', e.g. "2025-03-01".
+     */
+    static std::string dateKey(const std::string& dateTime);
 
 public:
+    static constexpr int InvalidDay = std::numeric_limits<int>::min(); ///< Day number of an unparsable date.
+
+    /**
+     * @brief Converts a calendar date into a day number.
+     * @param year The year.
+     * @param month The month, 1 to 12.
+     * @param day The day of the month, 1 to 31.
+     * @return Days since 1970-01-01; consecutive dates get consecutive numbers.
+     */
+    static int dayNumber(int year, int month, int day);
+
+    /**
+     * @brief Parses the date at the start of a date and time into a day number.
+     * @param dateTime Date and time as entered, starting with "yyyy-mm-dd".
+     * @return The day number, or InvalidDay if there is no valid date.
+     */
+    static int dayNumber(const std::string& dateTime);
+
     /**
      * @brief Adds a new transaction record to the system.
      * @param dateTime Date and time of the transaction.
@@ -61,17 +213,164 @@ public:
      * in the dataEntries vector. It also updates the category mapping.
      */
     void addData(const std::string& dateTime, const std::string& seller, const std::string& buyer,
-        const std::string& merchandise, double cost, const std::string& category);
+        const std::string& merchandise, Money cost, const std::string& category);
+
+    /**
+     * @brief Puts back a transaction that was saved earlier, keeping its ID.
+     * @param data The saved transaction.
+     * @return True if it was added, false if a transaction with that ID already exists.
+     *
+     * Used when loading a snapshot or replaying a journal, so removals recorded
+     * against an ID still find the right entry. Replaying the same record twice
+     * is harmless. Entries without a valid ID (0 or less) get the next free ID.
+     * Later addData() calls continue after the highest restored ID.
+     */
+    bool restoreData(const DataEntry& data);
 
     /**
      * @brief Searches for a transaction by its ID.
      * @param transID Unique transaction ID to search for.
      * @return Pointer to the found DataEntry, or nullptr if not found.
      *
-     * This function iterates through the stored transactions and returns
-     * a pointer to the matching transaction if found.
+     * The position of the transaction is looked up in the ID index, so this
+     * takes constant time. The pointer is valid until the next add, update or
+     * remove, or the next getAllDataEntries() call, since those may squeeze out
+     * removed slots. The entry is read-only; change it through updateData(), which
+     * keeps the indexes and totals in step.
      */
-    DataEntry* searchDataEntries(int transID);
+    const DataEntry* searchDataEntries(int transID) const;
+
+    /**
+     * @brief Changes the fields of a stored transaction.
+     * @param data The new fields; data.transid selects the transaction, day and categoryCode are ignored.
+     * @return True if the transaction existed, false otherwise.
+     *
+     * The transaction keeps its ID and row. Its running totals are moved, and
+     * if its date or category changed, its position moves to the new day and
+     * category bucket. Finding it in a bucket is a binary search, since buckets
+     * hold positions in ascending order.
+     */
+    bool updateData(const DataEntry& data);
+
+    /**
+     * @brief Gets the row of a transaction among the live entries.
+     * @param transID Unique transaction ID to look up.
+     * @return Its row, as used by entryAt() and getAllDataEntries(), or -1 if not found.
+     *
+     * Constant time while no slot is removed, O(log N) otherwise; nothing is moved.
+     */
+    long long positionOf(int transID) const;
+
+    /**
+     * @brief Gets the number of live transactions.
+     * @return The transaction count, without the removed slots.
+     */
+    std::size_t entryCount() const;
+
+    /**
+     * @brief Gets a transaction by its row among the live entries.
+     * @param row The row, below entryCount().
+     * @return The transaction; valid until the next add or remove.
+     *
+     * Constant time while no slot is removed, O(log N) otherwise; nothing is moved.
+     */
+    const DataEntry& entryAt(std::size_t row) const;
+
+    /**
+     * @brief Removes a transaction and drops it from every index.
+     * @param transID Unique transaction ID to remove.
+     * @return True if the transaction existed, false otherwise.
+     *
+     * The slot of the entry is only marked as removed, so this takes constant
+     * time; the remaining transactions keep their order.
+     */
+    bool removeData(int transID);
+
+    /**
+     * @brief Replaces the whole ledger with entries and indexes loaded in bulk.
+     * @param entries The transactions, in ledger order, with their day numbers and category codes filled in.
+     * @param days Day number -> positions in entries, as returned by dayIndex().
+     * @param categories Category code -> name and positions in entries, as returned by categoryIndex().
+     * @param nextId The ID the next addData() call will use.
+     *
+     * Used by snapshot loading: the date and category indexes are taken over
+     * as they are, no date is parsed and no category is interned again. Only
+     * the ID index and the running totals are built, in one pass over the entries.
+     */
+    void assignData(std::vector<DataEntry>&& entries, std::map<int, std::vector<std::size_t>>&& days,
+        std::vector<CategoryBucket>&& categories, int nextId);
+
+    /**
+     * @brief Gets the date index.
+     * @return Day number -> positions in getAllDataEntries(), in date order.
+     *
+     * Removed slots are squeezed out first, like getAllDataEntries() does, so
+     * the positions match the returned list.
+     */
+    const std::map<int, std::vector<std::size_t>>& dayIndex() const;
+
+    /**
+     * @brief Gets the category index.
+     * @return Category code -> name and positions in getAllDataEntries().
+     *
+     * Removed slots are squeezed out first, like getAllDataEntries() does. A
+     * category whose entries were all removed keeps its code, with no positions.
+     */
+    const std::vector<CategoryBucket>& categoryIndex() const;
+
+    /**
+     * @brief Gets the ID the next addData() call will use.
+     * @return The next transaction ID.
+     */
+    int nextTransactionId() const;
+
+    /**
+     * @brief Removes every transaction and empties the indexes.
+     *
+     * Transaction IDs start again from 1.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the IDs of all transactions in a category.
+     * @param category The category to look up, compared exactly.
+     * @return The transaction IDs in the order they were added, empty if none.
+     */
+    std::vector<int> searchByCategory(const std::string& category) const;
+
+    /**
+     * @brief Gets the IDs of all transactions on a date.
+     * @param date The date, "yyyy-mm-dd"; anything after it is ignored.
+     * @return The transaction IDs in the order they were added, empty if none or the date is not valid.
+     */
+    std::vector<int> searchByDate(const std::string& date) const;
+
+    /**
+     * @brief Gets the running total of the whole ledger.
+     * @return Sum and count of all transactions.
+     */
+    const LedgerAggregate& totals() const;
+
+    /**
+     * @brief Gets the running total of one category.
+     * @param category The category to look up.
+     * @return Sum and count of its transactions, zero if none.
+     */
+    LedgerAggregate categoryTotal(const std::string& category) const;
+
+    /**
+     * @brief Gets the running total of one month.
+     * @param month The month, e.g. "2025-03".
+     * @return Sum and count of its transactions, zero if none.
+     */
+    LedgerAggregate monthTotal(const std::string& month) const;
+
+    /**
+     * @brief Gets the running totals of all categories.
+     * @return Category -> running total, only categories with transactions.
+     */
+    const std::unordered_map<std::string, LedgerAggregate>& categoryTotalsMap() const;
+
     /**
      * @brief Lists all stored transactions.
      *
@@ -80,11 +379,72 @@ public:
     void listDataEntries();
     /**
      * @brief Retrieves all stored transaction records.
-     * @return A vector containing all DataEntry objects.
+     * @return A read-only reference to the stored DataEntry objects.
      *
      * This function provides external access to the full transaction list
+     * without copying it. Removed slots are squeezed out first, so the list only
+     * holds live entries. The reference stays valid, but the entries may move
+     * or change on the next add or remove.
+     */
+    const std::vector<DataEntry>& getAllDataEntries() const;
+
+    /**
+     * @brief Calls a visitor for every transaction in a date range, optionally of one category.
+     * @param firstDay Day number of the first day in the range.
+     * @param lastDay Day number of the last day in the range.
+     * @param category Category to keep, compared ignoring case; empty keeps all.
+     * @param visit Callable taking a const DataEntry&.
+     *
+     * Transactions are visited in date order, and in the order they were added
+     * within a day. Only the days in the range are looked at; transactions
+     * without a valid date are never visited.
+     */
+    template <typename Visitor>
+    void forEachInDateRange(int firstDay, int lastDay, const std::string& category, Visitor&& visit) const {
+        // Resolve the category to its codes once, the loop then compares integers only
+        std::vector<bool> codes;
+        if (!category.empty()) {
+            codes = categoryCodesMatching(category);
+            if (std::find(codes.begin(), codes.end(), true) == codes.end()) {
+                return; // No transaction was ever stored under this category
+            }
+        }
+        for (auto bucket = dayBuckets.lower_bound(firstDay); bucket != dayBuckets.end() && bucket->first <= lastDay; ++bucket) {
+            for (std::size_t position : bucket->second) {
+                const DataEntry& data = dataEntries[position];
+                if (data.transid != 0 && (category.empty() || codes[static_cast<std::size_t>(data.categoryCode)])) {
+                    visit(data); // Removed slots have ID 0 and are skipped
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Calls a visitor for every stored transaction, in order.
+     * @param visit Callable taking a const DataEntry&.
+     */
+    template <typename Visitor>
+    void forEachDataEntry(Visitor&& visit) const {
+        for (const DataEntry& data : dataEntries) {
+            if (data.transid != 0) {
+                visit(data);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls a visitor for every stored transaction that matches a filter, in order.
+     * @param matches Callable taking a const DataEntry& and returning true to visit it.
+     * @param visit Callable taking a const DataEntry&.
      */
-    std::vector<DataEntry> getAllDataEntries();
+    template <typename Predicate, typename Visitor>
+    void forEachDataEntry(Predicate&& matches, Visitor&& visit) const {
+        for (const DataEntry& data : dataEntries) {
+            if (data.transid != 0 && matches(data)) {
+                visit(data);
+            }
+        }
+    }
 };
 
 #endif
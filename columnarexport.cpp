@@ -0,0 +1,373 @@
+#include "columnarexport.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+/**
+ * @class columnarexport.cpp
+ * @brief Implements writing and selective reading of columnar transaction files.
+ */
+
+namespace {
+
+    const char ColumnarMagic[8] = { 'N', 'P', 'C', 'O', 'L', 'S', '0', '1' };
+
+    /**
+     * @brief Appends an unsigned number as a varint, 7 bits per byte.
+     */
+    void putVarint(QByteArray& out, quint64 value) {
+        while (value >= 0x80) {
+            out.append(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.append(static_cast<char>(value));
+    }
+
+    /**
+     * @brief Appends a signed number as a zigzag varint, so small negative values stay short.
+     */
+    void putSignedVarint(QByteArray& out, qint64 value) {
+        putVarint(out, (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+    }
+
+    /**
+     * @brief Sequential decoder for an encoded column chunk.
+     */
+    struct ChunkDecoder {
+        const char* position;
+        const char* end;
+        bool ok = true;
+
+        quint64 varint() {
+            quint64 value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (position == end) {
+                    break;
+                }
+                const quint8 byte = static_cast<quint8>(*position++);
+                value |= static_cast<quint64>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            ok = false; // Ran off the chunk or more than ten bytes
+            return 0;
+        }
+
+        qint64 signedVarint() {
+            const quint64 value = varint();
+            return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+        }
+
+        QByteArray bytes(quint64 length) {
+            if (length > static_cast<quint64>(end - position)) {
+                ok = false;
+                return QByteArray();
+            }
+            QByteArray value(position, static_cast<qsizetype>(length));
+            position += length;
+            return value;
+        }
+    };
+
+    /**
+     * @brief Converts a dictionary into a list for the footer.
+     */
+    QStringList dictionaryValues(const StringDictionary& dictionary) {
+        QStringList values;
+        values.reserve(dictionary.size());
+        for (int code = 0; code < dictionary.size(); ++code) {
+            values.append(dictionary.value(static_cast<quint32>(code)));
+        }
+        return values;
+    }
+
+}
+
+/**
+ * @brief Writes a transaction store to a columnar file.
+ *
+ * Each row group is encoded column by column, compressed and written right
+ * away, so only one group's chunks are in memory at a time. The footer with the
+ * dictionaries, statistics and chunk locations comes last.
+ *
+ * @param path The output file.
+ * @param store The transactions to write.
+ * @return True if the file was written, false otherwise.
+ */
+bool ColumnarExport::write(const QString& path, const TransactionStore& store) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Error: Unable to write columnar file" << path << ":" << file.errorString();
+        return false;
+    }
+    bool written = file.write(ColumnarMagic, sizeof(ColumnarMagic)) == sizeof(ColumnarMagic);
+
+    const qsizetype rowCount = store.size();
+    const qint32* dates = store.dateColumn().constData();
+    const quint32* typeCodes = store.typeColumn().constData();
+    const quint32* categoryCodes = store.categoryColumn().constData();
+    const quint32* paymentCodes = store.paymentMethodColumn().constData();
+    const std::int64_t* amounts = store.amountColumn().constData();
+
+    QVector<RowGroup> groups;
+    QByteArray encoded[ColumnCount]; // Reused for every group
+    for (qsizetype first = 0; first < rowCount && written; first += RowsPerGroup) {
+        const qsizetype last = qMin<qsizetype>(first + RowsPerGroup, rowCount);
+        RowGroup group;
+        group.rowCount = static_cast<quint32>(last - first);
+        group.minDate = TransactionStore::InvalidDate;
+        group.maxDate = TransactionStore::InvalidDate;
+        group.minAmount = std::numeric_limits<qint64>::max();
+        group.maxAmount = std::numeric_limits<qint64>::min();
+        for (QByteArray& column : encoded) {
+            column.resize(0);
+        }
+
+        qint64 previousDate = 0;
+        for (qsizetype row = first; row < last; ++row) {
+            // Dates barely change from row to row, so their deltas take one byte
+            putSignedVarint(encoded[DateColumn], static_cast<qint64>(dates[row]) - previousDate);
+            previousDate = dates[row];
+            if (dates[row] != TransactionStore::InvalidDate) {
+                if (group.minDate == TransactionStore::InvalidDate || dates[row] < group.minDate) {
+                    group.minDate = dates[row];
+                }
+                if (group.maxDate == TransactionStore::InvalidDate || dates[row] > group.maxDate) {
+                    group.maxDate = dates[row];
+                }
+            }
+
+            const QByteArrayView id = store.transactionID(row);
+            putVarint(encoded[TransactionIDColumn], static_cast<quint64>(id.size()));
+            encoded[TransactionIDColumn].append(id.data(), id.size());
+
+            putVarint(encoded[TypeColumn], typeCodes[row]);
+
+            const QByteArrayView description = store.description(row);
+            putVarint(encoded[DescriptionColumn], static_cast<quint64>(description.size()));
+            encoded[DescriptionColumn].append(description.data(), description.size());
+
+            putSignedVarint(encoded[AmountColumn], amounts[row]);
+            group.minAmount = qMin<qint64>(group.minAmount, amounts[row]);
+            group.maxAmount = qMax<qint64>(group.maxAmount, amounts[row]);
+
+            putVarint(encoded[PaymentMethodColumn], paymentCodes[row]);
+            putVarint(encoded[CategoryColumn], categoryCodes[row]);
+        }
+
+        for (int column = 0; column < ColumnCount && written; ++column) {
+            const QByteArray compressed = qCompress(encoded[column], CompressionLevel);
+            group.columns[column].offset = static_cast<quint64>(file.pos());
+            group.columns[column].storedSize = static_cast<quint32>(compressed.size());
+            group.columns[column].rawSize = static_cast<quint32>(encoded[column].size());
+            written = file.write(compressed) == compressed.size();
+        }
+        groups.append(group);
+    }
+
+    // Footer: everything a reader needs to pick the chunks it wants
+    QByteArray footer;
+    QDataStream out(&footer, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << Version << static_cast<quint64>(rowCount) << static_cast<quint32>(RowsPerGroup)
+        << dictionaryValues(store.types()) << dictionaryValues(store.categories())
+        << dictionaryValues(store.paymentMethods()) << static_cast<quint32>(groups.size());
+    for (const RowGroup& group : groups) {
+        out << group.rowCount << group.minDate << group.maxDate << group.minAmount << group.maxAmount;
+        for (const ColumnChunk& chunk : group.columns) {
+            out << chunk.offset << chunk.storedSize << chunk.rawSize;
+        }
+    }
+
+    const quint32 footerLength = qToLittleEndian(static_cast<quint32>(footer.size()));
+    written = written
+        && file.write(footer) == footer.size()
+        && file.write(reinterpret_cast<const char*>(&footerLength), sizeof(footerLength)) == sizeof(footerLength)
+        && file.write(ColumnarMagic, sizeof(ColumnarMagic)) == sizeof(ColumnarMagic);
+
+    if (!written || !file.commit()) {
+        qDebug() << "Error: Unable to write columnar file" << path << ":" << file.errorString();
+        return false;
+    }
+    qDebug() << "Exported" << rowCount << "transactions in" << groups.size() << "row groups to" << path;
+    return true;
+}
+
+/**
+ * @brief Opens a file and reads its footer.
+ * @param path The columnar file.
+ * @return True if the file is a valid columnar file of this version.
+ */
+bool ColumnarExport::Reader::open(const QString& path) {
+    file.close();
+    groups.clear();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // The trailer at the very end says where the footer starts
+    const qint64 trailerSize = sizeof(quint32) + sizeof(ColumnarMagic);
+    if (file.size() < static_cast<qint64>(sizeof(ColumnarMagic)) + trailerSize || !file.seek(file.size() - trailerSize)) {
+        return false;
+    }
+    const QByteArray trailer = file.read(trailerSize);
+    if (trailer.size() != trailerSize || std::memcmp(trailer.constData() + sizeof(quint32), ColumnarMagic, sizeof(ColumnarMagic)) != 0) {
+        qDebug() << "Error:" << path << "is not a columnar file";
+        return false;
+    }
+    const quint32 footerLength = qFromLittleEndian<quint32>(trailer.constData());
+    const qint64 footerStart = file.size() - trailerSize - footerLength;
+    if (footerStart < static_cast<qint64>(sizeof(ColumnarMagic)) || !file.seek(footerStart)) {
+        return false;
+    }
+
+    QDataStream in(file.read(footerLength));
+    in.setVersion(QDataStream::Qt_6_0);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 version = 0;
+    quint32 rowsPerGroup = 0;
+    quint32 groupCount = 0;
+    in >> version >> rows >> rowsPerGroup >> types >> categories >> paymentMethods >> groupCount;
+    if (in.status() != QDataStream::Ok || version != Version) {
+        qDebug() << "Error: Columnar file" << path << "has an unknown version or is damaged";
+        return false;
+    }
+
+    for (quint32 i = 0; i < groupCount && in.status() == QDataStream::Ok; ++i) {
+        RowGroup group;
+        in >> group.rowCount >> group.minDate >> group.maxDate >> group.minAmount >> group.maxAmount;
+        for (ColumnChunk& chunk : group.columns) {
+            in >> chunk.offset >> chunk.storedSize >> chunk.rawSize;
+        }
+        groups.append(group);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "Error: Columnar file" << path << "has a damaged footer";
+        groups.clear();
+        return false;
+    }
+    return true;
+}
+
+quint64 ColumnarExport::Reader::rowCount() const {
+    return rows;
+}
+
+const QVector<ColumnarExport::RowGroup>& ColumnarExport::Reader::rowGroups() const {
+    return groups;
+}
+
+/**
+ * @brief Gets the dictionary of a dictionary-encoded column.
+ * @param column TypeColumn, CategoryColumn or PaymentMethodColumn.
+ * @return Code -> value, empty for other columns.
+ */
+QStringList ColumnarExport::Reader::dictionary(Column column) const {
+    switch (column) {
+    case TypeColumn:
+        return types;
+    case CategoryColumn:
+        return categories;
+    case PaymentMethodColumn:
+        return paymentMethods;
+    default:
+        return QStringList();
+    }
+}
+
+/**
+ * @brief Reads the dates of one row group.
+ * @param group Index of the row group.
+ * @return Julian day numbers, empty if the chunk is damaged.
+ */
+QVector<qint32> ColumnarExport::Reader::readDates(int group) {
+    const QByteArray chunk = readChunk(group, DateColumn);
+    ChunkDecoder decoder{ chunk.constData(), chunk.constData() + chunk.size() };
+    QVector<qint32> dates;
+    dates.reserve(chunk.isEmpty() ? 0 : groups[group].rowCount);
+    qint64 date = 0;
+    for (quint32 row = 0; !chunk.isEmpty() && row < groups[group].rowCount && decoder.ok; ++row) {
+        date += decoder.signedVarint();
+        dates.append(static_cast<qint32>(date));
+    }
+    return decoder.ok ? dates : QVector<qint32>();
+}
+
+/**
+ * @brief Reads the dictionary codes of one row group.
+ * @param group Index of the row group.
+ * @param column TypeColumn, CategoryColumn or PaymentMethodColumn.
+ * @return The codes, empty if the chunk is damaged.
+ */
+QVector<quint32> ColumnarExport::Reader::readCodes(int group, Column column) {
+    const QByteArray chunk = readChunk(group, column);
+    ChunkDecoder decoder{ chunk.constData(), chunk.constData() + chunk.size() };
+    QVector<quint32> codes;
+    for (quint32 row = 0; !chunk.isEmpty() && row < groups[group].rowCount && decoder.ok; ++row) {
+        codes.append(static_cast<quint32>(decoder.varint()));
+    }
+    return decoder.ok ? codes : QVector<quint32>();
+}
+
+/**
+ * @brief Reads the amounts of one row group.
+ * @param group Index of the row group.
+ * @return Amounts in cents, empty if the chunk is damaged.
+ */
+QVector<std::int64_t> ColumnarExport::Reader::readAmounts(int group) {
+    const QByteArray chunk = readChunk(group, AmountColumn);
+    ChunkDecoder decoder{ chunk.constData(), chunk.constData() + chunk.size() };
+    QVector<std::int64_t> amounts;
+    for (quint32 row = 0; !chunk.isEmpty() && row < groups[group].rowCount && decoder.ok; ++row) {
+        amounts.append(decoder.signedVarint());
+    }
+    return decoder.ok ? amounts : QVector<std::int64_t>();
+}
+
+/**
+ * @brief Reads a text column of one row group.
+ * @param group Index of the row group.
+ * @param column TransactionIDColumn or DescriptionColumn.
+ * @return The UTF-8 values, empty if the chunk is damaged.
+ */
+QVector<QByteArray> ColumnarExport::Reader::readStrings(int group, Column column) {
+    const QByteArray chunk = readChunk(group, column);
+    ChunkDecoder decoder{ chunk.constData(), chunk.constData() + chunk.size() };
+    QVector<QByteArray> values;
+    for (quint32 row = 0; !chunk.isEmpty() && row < groups[group].rowCount && decoder.ok; ++row) {
+        values.append(decoder.bytes(decoder.varint()));
+    }
+    return decoder.ok ? values : QVector<QByteArray>();
+}
+
+/**
+ * @brief Reads and decompresses one column chunk.
+ *
+ * Seeks straight to the chunk, so the other columns and row groups are never read.
+ *
+ * @param group Index of the row group.
+ * @param column The column.
+ * @return The encoded column, empty if it could not be read.
+ */
+QByteArray ColumnarExport::Reader::readChunk(int group, Column column) {
+    if (group < 0 || group >= groups.size() || column < 0 || column >= ColumnCount) {
+        return QByteArray();
+    }
+    const ColumnChunk& chunk = groups[group].columns[column];
+    if (!file.seek(static_cast<qint64>(chunk.offset))) {
+        return QByteArray();
+    }
+    const QByteArray encoded = qUncompress(file.read(chunk.storedSize));
+    if (encoded.size() != static_cast<qsizetype>(chunk.rawSize)) {
+        qDebug() << "Error: Damaged column chunk" << column << "in row group" << group;
+        return QByteArray();
+    }
+    return encoded;
+}
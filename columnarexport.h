@@ -0,0 +1,172 @@
+#ifndef COLUMNAREXPORT_H
+#define COLUMNAREXPORT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <cstdint>
+#include "transactionstore.h"
+
+/**
+ * @class ColumnarExport
+ * @brief Compressed columnar file format for the loaded financial transactions.
+ *
+ * Meant for analytics tools that would otherwise parse the CSV reports again.
+ * The file is self-contained and laid out like a Parquet file:
+ *
+ * - The 8-byte magic "NPCOLS01".
+ * - Row groups of up to RowsPerGroup rows. Each group stores one chunk per
+ *   column, compressed with qCompress (zlib), one after another.
+ * - The footer, a QDataStream (little endian, Qt 6.0 format) holding the row
+ *   count, the three dictionaries and, for every row group, its row count,
+ *   min/max date and amount, and the offset, stored size and raw size of each
+ *   column chunk.
+ * - The footer length as a little-endian quint32, then the magic again.
+ *
+ * Column encodings, before compression:
+ * - Date: Julian day numbers, delta-encoded from the previous row as zigzag varints
+ *   (TransactionStore::InvalidDate for rows without a valid date).
+ * - Type, Category, PaymentMethod: dictionary codes as varints; the values are in the footer.
+ * - Amount: cents as zigzag varints.
+ * - TransactionID, Description: varint byte length followed by the UTF-8 bytes.
+ *
+ * A reader only has to read the footer and then the chunks of the columns and
+ * row groups it needs; the min/max statistics let it skip whole groups, e.g.
+ * all groups outside a date range.
+ */
+class ColumnarExport {
+public:
+    static constexpr quint32 Version = 1;           ///< Format version written by write().
+    static constexpr int RowsPerGroup = 64 * 1024;  ///< Rows per row group.
+    static constexpr int CompressionLevel = 6;      ///< zlib level of the column chunks.
+
+    /**
+     * @brief Columns of the file, in chunk order.
+     */
+    enum Column {
+        DateColumn,
+        TransactionIDColumn,
+        TypeColumn,
+        DescriptionColumn,
+        AmountColumn,
+        PaymentMethodColumn,
+        CategoryColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief Where one column chunk is stored.
+     */
+    struct ColumnChunk {
+        quint64 offset = 0;     ///< Byte offset of the compressed chunk in the file.
+        quint32 storedSize = 0; ///< Compressed size in bytes.
+        quint32 rawSize = 0;    ///< Encoded size before compression.
+    };
+
+    /**
+     * @brief Statistics and chunk locations of one row group.
+     */
+    struct RowGroup {
+        quint32 rowCount = 0;               ///< Rows in the group.
+        qint32 minDate = 0;                 ///< Smallest valid date, InvalidDate if none.
+        qint32 maxDate = 0;                 ///< Largest valid date, InvalidDate if none.
+        qint64 minAmount = 0;               ///< Smallest amount in cents.
+        qint64 maxAmount = 0;               ///< Largest amount in cents.
+        ColumnChunk columns[ColumnCount];   ///< One chunk per column.
+    };
+
+    /**
+     * @brief Writes a transaction store to a columnar file.
+     *
+     * The file is written through QSaveFile, so an existing file is only
+     * replaced once the new one is complete.
+     *
+     * @param path The output file.
+     * @param store The transactions to write.
+     * @return True if the file was written, false otherwise.
+     */
+    static bool write(const QString& path, const TransactionStore& store);
+
+    /**
+     * @class ColumnarExport::Reader
+     * @brief Reads selected columns and row groups of a columnar file.
+     */
+    class Reader {
+    public:
+        /**
+         * @brief Opens a file and reads its footer.
+         * @param path The columnar file.
+         * @return True if the file is a valid columnar file of this version.
+         */
+        bool open(const QString& path);
+
+        /**
+         * @brief Gets the total number of rows.
+         * @return The row count.
+         */
+        quint64 rowCount() const;
+
+        /**
+         * @brief Gets the row groups with their statistics.
+         * @return The row groups, in file order.
+         */
+        const QVector<RowGroup>& rowGroups() const;
+
+        /**
+         * @brief Gets the dictionary of a dictionary-encoded column.
+         * @param column TypeColumn, CategoryColumn or PaymentMethodColumn.
+         * @return Code -> value, empty for other columns.
+         */
+        QStringList dictionary(Column column) const;
+
+        /**
+         * @brief Reads the dates of one row group.
+         * @param group Index of the row group.
+         * @return Julian day numbers, empty if the chunk is damaged.
+         */
+        QVector<qint32> readDates(int group);
+
+        /**
+         * @brief Reads the dictionary codes of one row group.
+         * @param group Index of the row group.
+         * @param column TypeColumn, CategoryColumn or PaymentMethodColumn.
+         * @return The codes, empty if the chunk is damaged.
+         */
+        QVector<quint32> readCodes(int group, Column column);
+
+        /**
+         * @brief Reads the amounts of one row group.
+         * @param group Index of the row group.
+         * @return Amounts in cents, empty if the chunk is damaged.
+         */
+        QVector<std::int64_t> readAmounts(int group);
+
+        /**
+         * @brief Reads a text column of one row group.
+         * @param group Index of the row group.
+         * @param column TransactionIDColumn or DescriptionColumn.
+         * @return The UTF-8 values, empty if the chunk is damaged.
+         */
+        QVector<QByteArray> readStrings(int group, Column column);
+
+    private:
+        /**
+         * @brief Reads and decompresses one column chunk.
+         * @param group Index of the row group.
+         * @param column The column.
+         * @return The encoded column, empty if it could not be read.
+         */
+        QByteArray readChunk(int group, Column column);
+
+        QFile file;                 // The open columnar file.
+        quint64 rows = 0;           // Total row count.
+        QStringList types;          // Type dictionary.
+        QStringList categories;     // Category dictionary.
+        QStringList paymentMethods; // Payment method dictionary.
+        QVector<RowGroup> groups;   // Row groups from the footer.
+    };
+};
+
+#endif // COLUMNAREXPORT_H
@@ -0,0 +1,348 @@
+#include "csvreader.h"
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+    /**
+     * @brief Where readRow() would be within a record, as splitRecords() walks the bytes.
+     */
+    enum class ScanState {
+        FieldStart, // At the first character of a field
+        Unquoted,   // Inside an unquoted field; quotes are literal text
+        Quoted,     // Inside a quoted field; line breaks and commas are text
+        AfterQuote  // After the closing quote, skipping to the next delimiter
+    };
+
+}
+
+/**
+ * @class CsvReader
+ * @brief Implements the streaming, zero-copy CSV reader.
+ *
+ * The file is mapped into memory once and records are tokenized in place.
+ * Fields are returned as views into the mapping, never as copies.
+ */
+
+ /**
+  * @brief Default constructor for CsvReader.
+  */
+CsvReader::CsvReader() = default;
+
+/**
+ * @brief Destructor for CsvReader.
+ *
+ * Releases the mapping and closes the file.
+ */
+CsvReader::~CsvReader() {
+    close();
+}
+
+/**
+ * @brief Opens and maps a CSV file for reading.
+ *
+ * @param filePath The path of the CSV file to open.
+ * @return True if the file was opened, false otherwise.
+ */
+bool CsvReader::open(const QString& filePath) {
+    close(); // Drop any file that is still attached
+
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        lastError = file.errorString();
+        return false;
+    }
+
+    length = file.size();
+    if (length > 0) {
+        // Map the whole file; the OS pages it in lazily as we walk through it
+        mapping = file.map(0, length);
+        if (mapping) {
+            data = reinterpret_cast<const char*>(mapping);
+        }
+        else {
+            // Some devices cannot be mapped, fall back to reading the contents
+            qDebug() << "CsvReader: mapping failed for" << filePath << ", reading into memory instead";
+            fallbackBuffer = file.readAll();
+            data = fallbackBuffer.constData();
+            length = fallbackBuffer.size();
+        }
+    }
+
+    position = 0;
+    nextLine = 1;
+    currentLine = 0;
+    return true;
+}
+
+/**
+ * @brief Reads records from bytes owned by someone else instead of a file.
+ * @param bytes The bytes to read, starting at a record boundary.
+ * @param firstLine Line number of the first record in bytes.
+ */
+void CsvReader::attach(QByteArrayView bytes, qint64 firstLine) {
+    close(); // Drop any file that is still attached
+    data = bytes.data();
+    length = bytes.size();
+    position = 0;
+    nextLine = firstLine;
+    currentLine = 0;
+}
+
+/**
+ * @brief Gets all bytes of the open file or attached buffer.
+ * @return A view of the bytes.
+ */
+QByteArrayView CsvReader::contents() const {
+    return QByteArrayView(data, length);
+}
+
+/**
+ * @brief Splits bytes into chunks that each start and end on a record boundary.
+ *
+ * Every chunk starts at a record start, so the scan for the next boundary begins
+ * there in a known state and each byte is looked at once.
+ *
+ * @param bytes The bytes to split.
+ * @param chunkCount The wanted number of chunks.
+ * @return The chunks in file order.
+ */
+QVector<QByteArrayView> CsvReader::splitRecords(QByteArrayView bytes, int chunkCount) {
+    QVector<QByteArrayView> chunks;
+    const char* begin = bytes.data();
+    const qsizetype total = bytes.size();
+    if (chunkCount <= 1 || total == 0) {
+        if (total > 0) {
+            chunks.append(bytes);
+        }
+        return chunks;
+    }
+
+    const qsizetype step = total / chunkCount;
+    qsizetype chunkStart = 0;
+
+    for (int i = 1; i < chunkCount && chunkStart < total; ++i) {
+        const qsizetype cut = qMax(step * i, chunkStart);
+
+        // Walk the record structure from the chunk start to the first line break at or past the cut that ends a record
+        ScanState state = ScanState::FieldStart;
+        qsizetype boundary = chunkStart;
+        while (boundary < total) {
+            const char c = begin[boundary];
+            if (state == ScanState::Quoted) {
+                if (c == '"') {
+                    if (boundary + 1 < total && begin[boundary + 1] == '"') {
+                        boundary += 2; // Escaped quote
+                        continue;
+                    }
+                    state = ScanState::AfterQuote;
+                }
+            }
+            else if (c == '\n') {
+                if (boundary >= cut) {
+                    break;
+                }
+                state = ScanState::FieldStart;
+            }
+            else if (c == ',') {
+                state = ScanState::FieldStart;
+            }
+            else if (state == ScanState::FieldStart) {
+                state = c == '"' ? ScanState::Quoted : ScanState::Unquoted;
+            }
+            boundary++;
+        }
+        if (boundary >= total) {
+            break; // The rest of the input is a single record
+        }
+        boundary++; // The chunk keeps its line break
+
+        chunks.append(QByteArrayView(begin + chunkStart, boundary - chunkStart));
+        chunkStart = boundary;
+    }
+
+    if (chunkStart < total) {
+        chunks.append(QByteArrayView(begin + chunkStart, total - chunkStart));
+    }
+    return chunks;
+}
+
+/**
+ * @brief Unmaps and closes the current file.
+ */
+void CsvReader::close() {
+    if (mapping) {
+        file.unmap(mapping);
+        mapping = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+    fallbackBuffer.clear();
+    data = nullptr;
+    length = 0;
+    position = 0;
+}
+
+/**
+ * @brief Reads the next record from the file.
+ *
+ * Walks the bytes of one record and records a view for every field. Quoted fields
+ * may contain commas and line breaks; a trailing carriage return is dropped from
+ * the last field so files with Windows line endings read the same as Unix ones.
+ *
+ * @param fields Output vector receiving the field views of the record.
+ * @return True if a record was read, false at the end of the file.
+ */
+bool CsvReader::readRow(QVector<QByteArrayView>& fields) {
+    fields.clear(); // Qt 6 keeps the capacity, so this does not free memory
+
+    if (data == nullptr || position >= length) {
+        return false; // Nothing left to read
+    }
+
+    currentLine = nextLine;
+    const char* cursor = data + position;
+    const char* end = data + length;
+
+    while (true) {
+        const char* fieldStart = cursor;
+        const char* fieldEnd = cursor;
+
+        if (cursor < end && *cursor == '"') {
+            // Quoted field: scan to the closing quote, skipping escaped ("") quotes
+            fieldStart = ++cursor;
+            while (cursor < end) {
+                if (*cursor == '"') {
+                    if (cursor + 1 < end && cursor[1] == '"') {
+                        cursor += 2;
+                        continue;
+                    }
+                    break;
+                }
+                if (*cursor == '\n') {
+                    nextLine++; // Line break inside the field
+                }
+                cursor++;
+            }
+            fieldEnd = cursor;
+            if (cursor < end) {
+                cursor++; // Step over the closing quote
+            }
+            // Ignore anything between the closing quote and the next delimiter
+            while (cursor < end && *cursor != ',' && *cursor != '\n') {
+                cursor++;
+            }
+        }
+        else {
+            // Unquoted field: runs up to the next comma or line break
+            while (cursor < end && *cursor != ',' && *cursor != '\n') {
+                cursor++;
+            }
+            fieldEnd = cursor;
+            if (fieldEnd > fieldStart && fieldEnd[-1] == '\r' && (cursor == end || *cursor == '\n')) {
+                fieldEnd--; // Drop the carriage return of a CRLF line ending
+            }
+        }
+
+        fields.append(QByteArrayView(fieldStart, fieldEnd - fieldStart));
+
+        if (cursor < end && *cursor == ',') {
+            cursor++; // Move on to the next field of the same record
+            continue;
+        }
+
+        if (cursor < end) {
+            cursor++; // Step over the line break that ends the record
+            nextLine++;
+        }
+        position = cursor - data;
+        return true;
+    }
+}
+
+/**
+ * @brief Gets the line number of the last record returned by readRow().
+ * @return The 1-based line number.
+ */
+qint64 CsvReader::lineNumber() const {
+    return currentLine;
+}
+
+/**
+ * @brief Gets how many bytes of the file have been consumed so far.
+ * @return The number of bytes read.
+ */
+qint64 CsvReader::bytesRead() const {
+    return position;
+}
+
+/**
+ * @brief Gets the total size of the open file in bytes.
+ * @return The file size.
+ */
+qint64 CsvReader::size() const {
+    return length;
+}
+
+/**
+ * @brief Gets a description of the last error that occurred.
+ * @return The error message.
+ */
+QString CsvReader::errorString() const {
+    return lastError;
+}
+
+/**
+ * @brief Strips leading and trailing whitespace from a field view.
+ * @param field The field to trim.
+ * @return A view of the field without surrounding whitespace.
+ */
+QByteArrayView CsvReader::trimmed(QByteArrayView field) {
+    qsizetype begin = 0;
+    qsizetype end = field.size();
+    while (begin < end && (field[begin] == ' ' || field[begin] == '\t' || field[begin] == '\r' || field[begin] == '\n')) {
+        begin++;
+    }
+    while (end > begin && (field[end - 1] == ' ' || field[end - 1] == '\t' || field[end - 1] == '\r' || field[end - 1] == '\n')) {
+        end--;
+    }
+    return field.sliced(begin, end - begin);
+}
+
+/**
+ * @brief Collapses doubled quotes ("") in a field without allocating when possible.
+ *
+ * @param field The field to unescape.
+ * @param scratch Buffer that holds the result when unescaping is needed.
+ * @return A view of the unescaped field.
+ */
+QByteArrayView CsvReader::unescaped(QByteArrayView field, QByteArray& scratch) {
+    // Fast path: nothing to unescape, hand the view back as is
+    if (field.isEmpty() || std::memchr(field.data(), '"', field.size()) == nullptr) {
+        return field;
+    }
+
+    scratch.clear();
+    scratch.reserve(field.size());
+    for (qsizetype i = 0; i < field.size(); ++i) {
+        scratch.append(field[i]);
+        if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"') {
+            ++i; // Skip the second quote of an escaped pair
+        }
+    }
+    return QByteArrayView(scratch);
+}
+
+/**
+ * @brief Converts a field view into an owning QString.
+ *
+ * Doubled quotes are collapsed into a single quote while converting.
+ *
+ * @param field The field to convert.
+ * @return The field contents decoded as UTF-8.
+ */
+QString CsvReader::toString(QByteArrayView field) {
+    QByteArray scratch;
+    return QString::fromUtf8(unescaped(field, scratch));
+}
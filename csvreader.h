@@ -0,0 +1,171 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class CsvReader
+ * @brief Streaming, zero-copy reader for comma separated files.
+ *
+ * The reader memory-maps the whole input file and walks it one record at a time.
+ * Every field of a record is handed back as a QByteArrayView that points straight
+ * into the mapping, so tokenizing a row never allocates. The caller decides which
+ * fields are worth converting into owning strings or numbers.
+ *
+ * Quoted fields (RFC 4180) are supported: the surrounding quotes are stripped from
+ * the view and embedded commas and line breaks are kept inside the field. Doubled
+ * quotes ("") stay escaped in the view; use toString() to unescape them.
+ *
+ * There is no limit on the number of rows; memory use does not depend on file size
+ * because the operating system pages the mapping in and out as it is read.
+ */
+class CsvReader {
+public:
+    /**
+     * @brief Default constructor for CsvReader.
+     *
+     * Creates a reader that is not attached to any file yet.
+     */
+    CsvReader();
+
+    /**
+     * @brief Destructor for CsvReader.
+     *
+     * Unmaps and closes the file if one is still open.
+     */
+    ~CsvReader();
+
+    /**
+     * @brief Opens and maps a CSV file for reading.
+     *
+     * Any previously opened file is closed first. If the file cannot be mapped
+     * (e.g. it lives on a device that does not support mapping), its contents are
+     * read into an internal buffer instead so reading still works.
+     *
+     * @param filePath The path of the CSV file to open.
+     * @return True if the file was opened, false otherwise (see errorString()).
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief Reads records from bytes owned by someone else instead of a file.
+     *
+     * Used to tokenize one chunk of a file that another reader has mapped. The
+     * bytes must stay valid while the reader is in use.
+     *
+     * @param bytes The bytes to read, starting at a record boundary.
+     * @param firstLine Line number of the first record in bytes.
+     */
+    void attach(QByteArrayView bytes, qint64 firstLine = 1);
+
+    /**
+     * @brief Gets all bytes of the open file or attached buffer.
+     * @return A view of the bytes, valid until close() is called.
+     */
+    QByteArrayView contents() const;
+
+    /**
+     * @brief Splits bytes into chunks that each start and end on a record boundary.
+     *
+     * The bytes are first cut into roughly equal ranges. Each cut is then moved
+     * forward to the next line break that is not inside a quoted field, so a record
+     * is never split between two chunks. The quote state is tracked with the rules
+     * of readRow(): a quote only opens a field as its first character, elsewhere it
+     * is literal text, and "" inside a quoted field is an escaped quote. The chunks
+     * therefore end exactly where a sequential read ends records.
+     *
+     * @param bytes The bytes to split, e.g. contents().
+     * @param chunkCount The wanted number of chunks; fewer are returned if records are long.
+     * @return The chunks in file order, together covering all bytes.
+     */
+    static QVector<QByteArrayView> splitRecords(QByteArrayView bytes, int chunkCount);
+
+    /**
+     * @brief Unmaps and closes the current file.
+     *
+     * Views returned by readRow() are invalid after this call.
+     */
+    void close();
+
+    /**
+     * @brief Reads the next record from the file.
+     *
+     * The fields vector is cleared and filled with one view per field. Its capacity
+     * is kept, so reusing the same vector for every row avoids allocations.
+     * A blank line is returned as a single empty field.
+     *
+     * @param fields Output vector receiving the field views of the record.
+     * @return True if a record was read, false at the end of the file.
+     */
+    bool readRow(QVector<QByteArrayView>& fields);
+
+    /**
+     * @brief Gets the line number of the last record returned by readRow().
+     * @return The 1-based line number where the last record started.
+     */
+    qint64 lineNumber() const;
+
+    /**
+     * @brief Gets how many bytes of the file have been consumed so far.
+     * @return The number of bytes read.
+     */
+    qint64 bytesRead() const;
+
+    /**
+     * @brief Gets the total size of the open file in bytes.
+     * @return The file size.
+     */
+    qint64 size() const;
+
+    /**
+     * @brief Gets a description of the last error that occurred.
+     * @return The error message.
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Strips leading and trailing whitespace from a field view.
+     * @param field The field to trim.
+     * @return A view of the field without surrounding whitespace.
+     */
+    static QByteArrayView trimmed(QByteArrayView field);
+
+    /**
+     * @brief Collapses doubled quotes ("") in a field without allocating when possible.
+     *
+     * Fields without quotes are returned unchanged. Otherwise the unescaped bytes are
+     * written to scratch and a view of scratch is returned.
+     *
+     * @param field The field to unescape.
+     * @param scratch Buffer that holds the result when unescaping is needed.
+     * @return A view of the unescaped field.
+     */
+    static QByteArrayView unescaped(QByteArrayView field, QByteArray& scratch);
+
+    /**
+     * @brief Converts a field view into an owning QString.
+     *
+     * Doubled quotes ("") inside the field are collapsed into a single quote.
+     *
+     * @param field The field to convert.
+     * @return The field contents decoded as UTF-8.
+     */
+    static QString toString(QByteArrayView field);
+
+private:
+    QFile file;                 // The file being read.
+    uchar* mapping = nullptr;   // Start of the memory mapping, or nullptr when the fallback buffer is used.
+    QByteArray fallbackBuffer;  // File contents when mapping is not possible.
+    const char* data = nullptr; // Start of the bytes being tokenized.
+    qint64 length = 0;          // Number of bytes available at data.
+    qint64 position = 0;        // Offset of the next unread byte.
+    qint64 nextLine = 1;        // Line number the next record starts on.
+    qint64 currentLine = 0;     // Line number of the last record returned.
+    QString lastError;          // Description of the last error.
+};
+
+#endif // CSVREADER_H
@@ -0,0 +1,295 @@
+#include "csvwriter.h"
+#include <charconv>
+#include <cstring>
+
+/**
+ * @class csvwriter.cpp
+ * @brief Implements the buffered CSV writer.
+ */
+
+/**
+ * @brief Creates a writer that is not attached to any file yet.
+ */
+CsvWriter::CsvWriter() {
+}
+
+/**
+ * @brief Opens the file to write. Nothing is replaced until commit().
+ * @param filePath The path of the CSV file.
+ * @return True if the file could be opened, false otherwise.
+ */
+bool CsvWriter::open(const QString& filePath) {
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        lastError = file.errorString();
+        return false;
+    }
+    buffer.resize(0);
+    buffer.reserve(BufferSize);
+    rowOpen = false;
+    failed = false;
+    rows = 0;
+    lastError.clear();
+    return true;
+}
+
+/**
+ * @brief Writes the rest of the buffer and replaces the target file.
+ * @return True if every byte was written, false otherwise.
+ */
+bool CsvWriter::commit() {
+    if (rowOpen) {
+        endRow(); // A row left open still belongs in the file
+    }
+    if (!failed && !buffer.isEmpty() && file.write(buffer) != buffer.size()) {
+        failed = true;
+        lastError = file.errorString();
+    }
+    buffer.clear();
+    if (failed) {
+        file.cancelWriting();
+        file.commit(); // Only closes the file, the target stays as it was
+        return false;
+    }
+    if (!file.commit()) {
+        lastError = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Adds a text field to the current row, quoted if needed.
+ *
+ * A field is quoted when it contains a comma, a quote or a line break; quotes
+ * inside it are doubled. Anything else is copied as is.
+ *
+ * @param field UTF-8 text.
+ */
+void CsvWriter::addField(QByteArrayView field) {
+    beginField();
+
+    const char* data = field.data();
+    const qsizetype size = field.size();
+    qsizetype quotes = 0;
+    bool needsQuotes = false;
+    for (qsizetype i = 0; i < size; ++i) {
+        const char c = data[i];
+        if (c == '"') {
+            quotes++;
+            needsQuotes = true;
+        }
+        else if (c == ',' || c == '\n' || c == '\r') {
+            needsQuotes = true;
+        }
+    }
+
+    if (!needsQuotes) {
+        reserve(size);
+        buffer.append(data, size);
+        return;
+    }
+
+    reserve(size + quotes + 2);
+    buffer.append('"');
+    qsizetype start = 0;
+    for (qsizetype i = 0; i < size; ++i) {
+        if (data[i] == '"') {
+            buffer.append(data + start, i + 1 - start); // Up to and including the quote
+            buffer.append('"');                         // Doubled
+            start = i + 1;
+        }
+    }
+    buffer.append(data + start, size - start);
+    buffer.append('"');
+}
+
+/**
+ * @brief Adds a text field to the current row, quoted if needed.
+ * @param field The text.
+ */
+void CsvWriter::addField(const QString& field) {
+    addField(toUtf8(field));
+}
+
+/**
+ * @brief Adds a text field to the current row, quoted if needed.
+ * @param field UTF-8 text.
+ */
+void CsvWriter::addField(const std::string& field) {
+    addField(QByteArrayView(field.data(), static_cast<qsizetype>(field.size())));
+}
+
+/**
+ * @brief Adds a text field to the current row, quoted if needed.
+ * @param field Null-terminated UTF-8 text.
+ */
+void CsvWriter::addField(const char* field) {
+    addField(QByteArrayView(field, static_cast<qsizetype>(std::strlen(field))));
+}
+
+/**
+ * @brief Adds an integer field to the current row.
+ * @param value The number.
+ */
+void CsvWriter::addField(qint64 value) {
+    beginField();
+    char digits[24];
+    const char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    reserve(end - digits);
+    buffer.append(digits, end - digits);
+}
+
+/**
+ * @brief Adds an integer field to the current row.
+ * @param value The number.
+ */
+void CsvWriter::addField(int value) {
+    addField(static_cast<qint64>(value));
+}
+
+/**
+ * @brief Adds an amount to the current row, with two decimals.
+ * @param amount The amount.
+ */
+void CsvWriter::addField(Money amount) {
+    beginField();
+    char text[Money::MaxFormattedLength];
+    const char* end = amount.format(text);
+    reserve(end - text);
+    buffer.append(text, end - text);
+}
+
+/**
+ * @brief Ends the current row.
+ */
+void CsvWriter::endRow() {
+    reserve(1);
+    buffer.append('\n');
+    rowOpen = false;
+    rows++;
+}
+
+/**
+ * @brief Adds text as a whole line, without any quoting.
+ * @param line UTF-8 text without the line break.
+ */
+void CsvWriter::writeLine(QByteArrayView line) {
+    if (rowOpen) {
+        endRow();
+    }
+    reserve(line.size());
+    buffer.append(line.data(), line.size());
+    endRow();
+}
+
+/**
+ * @brief Adds text as a whole line, without any quoting.
+ * @param line The text without the line break.
+ */
+void CsvWriter::writeLine(const QString& line) {
+    writeLine(toUtf8(line));
+}
+
+/**
+ * @brief Adds text as a whole line, without any quoting.
+ * @param line Null-terminated UTF-8 text without the line break.
+ */
+void CsvWriter::writeLine(const char* line) {
+    writeLine(QByteArrayView(line, static_cast<qsizetype>(std::strlen(line))));
+}
+
+/**
+ * @brief Gets the number of rows and lines ended so far.
+ * @return The row count.
+ */
+qint64 CsvWriter::rowCount() const {
+    return rows;
+}
+
+/**
+ * @brief Gets a description of the last error.
+ * @return The error message, or an empty string if there was none.
+ */
+QString CsvWriter::errorString() const {
+    return lastError;
+}
+
+/**
+ * @brief Makes room for at least a number of bytes, writing the buffer out if needed.
+ *
+ * The buffer is written in one piece once the next append would take it past
+ * BufferSize. A single value larger than that simply grows the buffer once.
+ *
+ * @param bytes The bytes about to be appended.
+ */
+void CsvWriter::reserve(qsizetype bytes) {
+    if (buffer.size() + bytes <= BufferSize || buffer.isEmpty()) {
+        return;
+    }
+    if (!failed && file.write(buffer) != buffer.size()) {
+        failed = true;
+        lastError = file.errorString();
+    }
+    buffer.resize(0); // Unlike clear(), keeps the capacity, so the next rows fill the same memory
+}
+
+/**
+ * @brief Converts text to UTF-8 in the scratch buffer.
+ *
+ * Unlike QString::toUtf8(), which returns a new array every time, this keeps
+ * filling the same one; it only grows for a longer text than it has seen.
+ * A lone surrogate becomes U+FFFD, as QString::toUtf8() would write it.
+ *
+ * @param text The text.
+ * @return The UTF-8 bytes, valid until the next call.
+ */
+QByteArrayView CsvWriter::toUtf8(QStringView text) {
+    const qsizetype capacity = text.size() * 3; // A UTF-16 unit never takes more than 3 bytes
+    if (scratch.size() < capacity) {
+        scratch.resize(capacity);
+    }
+
+    char* out = scratch.data();
+    const char16_t* in = text.utf16();
+    const qsizetype size = text.size();
+    for (qsizetype i = 0; i < size; ++i) {
+        char32_t c = in[i];
+        if (c < 0x80) {
+            *out++ = static_cast<char>(c);
+            continue;
+        }
+        if (c < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (c >> 6));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+            continue;
+        }
+        if (c >= 0xD800 && c < 0xDC00 && i + 1 < size && in[i + 1] >= 0xDC00 && in[i + 1] < 0xE000) {
+            // Surrogate pair: two units, four bytes
+            c = 0x10000 + ((c - 0xD800) << 10) + (in[++i] - 0xDC00);
+            *out++ = static_cast<char>(0xF0 | (c >> 18));
+            *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+            continue;
+        }
+        if (c >= 0xD800 && c < 0xE000) {
+            c = 0xFFFD; // Unpaired surrogate
+        }
+        *out++ = static_cast<char>(0xE0 | (c >> 12));
+        *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    return QByteArrayView(scratch.constData(), out - scratch.constData());
+}
+
+/**
+ * @brief Appends the separator before a new field of the current row.
+ */
+void CsvWriter::beginField() {
+    if (rowOpen) {
+        reserve(1);
+        buffer.append(',');
+    }
+    rowOpen = true;
+}
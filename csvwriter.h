@@ -0,0 +1,159 @@
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QSaveFile>
+#include <QString>
+#include <string>
+#include "money.h"
+
+/**
+ * @class CsvWriter
+ * @brief Buffered writer for comma separated files, the counterpart of CsvReader.
+ *
+ * Rows are built field by field into one large output buffer that is reused for
+ * the whole file and only handed to the file once it is full, so writing a row
+ * never allocates. Numbers and Money amounts are formatted straight into the
+ * buffer without going through QString, and QString text is converted to UTF-8
+ * in a scratch buffer that is reused as well.
+ *
+ * Text fields are quoted following RFC 4180 whenever they contain a comma, a
+ * quote or a line break, with embedded quotes doubled, so a comma in a merchant
+ * name no longer shifts the columns. CsvReader reads such fields back unchanged.
+ * Rows end with a single '\n', like the files the application always wrote.
+ *
+ * The output goes through QSaveFile: the target file is only replaced once
+ * commit() succeeds, and a writer destroyed without commit() leaves it untouched.
+ */
+class CsvWriter {
+public:
+    static constexpr qsizetype BufferSize = 1024 * 1024; ///< Bytes collected before they are written out.
+
+    /**
+     * @brief Creates a writer that is not attached to any file yet.
+     */
+    CsvWriter();
+
+    /**
+     * @brief Opens the file to write. Nothing is replaced until commit().
+     * @param filePath The path of the CSV file.
+     * @return True if the file could be opened, false otherwise (see errorString()).
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief Writes the rest of the buffer and replaces the target file.
+     * @return True if every byte was written, false otherwise (see errorString()).
+     */
+    bool commit();
+
+    /**
+     * @brief Adds a text field to the current row, quoted if needed.
+     * @param field UTF-8 text.
+     */
+    void addField(QByteArrayView field);
+
+    /**
+     * @brief Adds a text field to the current row, quoted if needed.
+     * @param field The text.
+     */
+    void addField(const QString& field);
+
+    /**
+     * @brief Adds a text field to the current row, quoted if needed.
+     * @param field UTF-8 text.
+     */
+    void addField(const std::string& field);
+
+    /**
+     * @brief Adds a text field to the current row, quoted if needed.
+     * @param field Null-terminated UTF-8 text.
+     */
+    void addField(const char* field);
+
+    /**
+     * @brief Adds an integer field to the current row.
+     * @param value The number.
+     */
+    void addField(qint64 value);
+
+    /**
+     * @brief Adds an integer field to the current row.
+     * @param value The number.
+     */
+    void addField(int value);
+
+    /**
+     * @brief Adds an amount to the current row, with two decimals.
+     * @param amount The amount.
+     */
+    void addField(Money amount);
+
+    /**
+     * @brief Ends the current row.
+     */
+    void endRow();
+
+    /**
+     * @brief Adds text as a whole line, without any quoting.
+     *
+     * For free-form lines such as titles; the current row is ended first if one is open.
+     *
+     * @param line UTF-8 text without the line break.
+     */
+    void writeLine(QByteArrayView line);
+
+    /**
+     * @brief Adds text as a whole line, without any quoting.
+     * @param line The text without the line break.
+     */
+    void writeLine(const QString& line);
+
+    /**
+     * @brief Adds text as a whole line, without any quoting.
+     * @param line Null-terminated UTF-8 text without the line break.
+     */
+    void writeLine(const char* line);
+
+    /**
+     * @brief Gets the number of rows and lines ended so far.
+     * @return The row count.
+     */
+    qint64 rowCount() const;
+
+    /**
+     * @brief Gets a description of the last error.
+     * @return The error message, or an empty string if there was none.
+     */
+    QString errorString() const;
+
+private:
+    /**
+     * @brief Makes room for at least a number of bytes, writing the buffer out if needed.
+     * @param bytes The bytes about to be appended.
+     */
+    void reserve(qsizetype bytes);
+
+    /**
+     * @brief Appends the separator before a new field of the current row.
+     */
+    void beginField();
+
+    /**
+     * @brief Converts text to UTF-8 in the scratch buffer.
+     * @param text The text.
+     * @return The UTF-8 bytes, valid until the next call.
+     */
+    QByteArrayView toUtf8(QStringView text);
+
+    QSaveFile file;           // Target file, replaced on commit().
+    QByteArray buffer;        // Pending output, reused for the whole file.
+    QByteArray scratch;       // UTF-8 form of the last QString field, reused as well.
+    bool rowOpen = false;     // The current row already has a field.
+    bool failed = false;      // A write failed; everything after it is dropped.
+    qint64 rows = 0;          // Rows and lines ended so far.
+    QString lastError;        // Description of the last error.
+};
+
+#endif // CSVWRITER_H
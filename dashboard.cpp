@@ -7,6 +7,8 @@
 
 #include "dashboard.h"
 #include "inventory.h"
+#include "storageengine.h"
+#include "cashflowtracking.h"
 #include <QTableWidgetItem>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -28,6 +30,8 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFile>
+#include <QDate>
+#include <QMap>
 
  /**
   * @class Dashboard
@@ -72,9 +76,11 @@ Dashboard::Dashboard(QWidget* parent) : QWidget(parent)
     financialsLabel->setAlignment(Qt::AlignCenter);
     cashInflowsLabel = new QLabel("Inflows: $5000", this);
     cashOutflowsLabel = new QLabel("Outflows: $3000", this);
+    monthOutflowsLabel = new QLabel("Outflows this month: $0.00", this);
     QVBoxLayout* financialsLayout = new QVBoxLayout();
     financialsLayout->addWidget(cashInflowsLabel);
     financialsLayout->addWidget(cashOutflowsLabel);
+    financialsLayout->addWidget(monthOutflowsLabel);
     leftLayout->addWidget(financialsLabel);
     leftLayout->addLayout(financialsLayout);
 
@@ -292,6 +298,40 @@ void Dashboard::updateFinancials()
 
     cashInflowsLabel->setText("Inflows: $5500");
     cashOutflowsLabel->setText("Outflows: $3200");
+    showLedgerOutflows(); // Real outflows once a ledger is attached
+}
+
+/**
+ * @brief Sets the ledger whose running totals the dashboard shows.
+ * @param cashflowLedger The cashflow ledger, or nullptr to show none.
+ */
+void Dashboard::setLedger(const CashflowTracking* cashflowLedger)
+{
+    ledger = cashflowLedger;
+    showLedgerTotals();
+}
+
+/**
+ * @brief Shows the current totals of the ledger in the labels and the pie chart.
+ */
+void Dashboard::showLedgerTotals()
+{
+    showLedgerOutflows();
+    updateCharts();
+}
+
+/**
+ * @brief Writes the ledger's total and current month outflows into their labels.
+ *
+ * Both come from the running aggregates of the ledger, not from a scan.
+ */
+void Dashboard::showLedgerOutflows()
+{
+    if (!ledger) return;
+
+    cashOutflowsLabel->setText("Outflows: $" + ledger->totals().total.toQString());
+    const std::string month = QDate::currentDate().toString("yyyy-MM").toStdString(); // Same key as the month totals
+    monthOutflowsLabel->setText("Outflows this month: $" + ledger->monthTotal(month).total.toQString());
 }
 
 /**
@@ -414,7 +454,19 @@ void Dashboard::updateCharts()
 
     // Add inflows and outflows to pie Series
     pieSeries->append("Inflows", inflows);
-    pieSeries->append("Outflows", outflows);
+    if (ledger && !ledger->categoryTotalsMap().empty()) {
+        // Outflows split by category, from the ledger's running category totals, in name order
+        QMap<QString, double> categoryOutflows;
+        for (const auto& category : ledger->categoryTotalsMap()) {
+            categoryOutflows.insert(QString::fromStdString(category.first), category.second.total.toDouble());
+        }
+        for (auto it = categoryOutflows.constBegin(); it != categoryOutflows.constEnd(); ++it) {
+            pieSeries->append(it.key(), it.value());
+        }
+    }
+    else {
+        pieSeries->append("Outflows", outflows);
+    }
 
     // Add pie series to pie chart
     pieChart->addSeries(pieSeries);
@@ -464,6 +516,14 @@ void Dashboard::setInventoryTable(QTableWidget* sharedTable) {
     }
 }
 
+/**
+ * @brief Saves the monthly revenue table of a user to the database.
+ *
+ * The table is stored as one compact JSON value in the "revenue" table, keyed by
+ * user, so saving replaces only this user's row.
+ *
+ * @param userId The user whose revenue is saved.
+ */
 void Dashboard::saveMonthlyRevenueData(const QString& userId) {
     QJsonArray revenueArray;
 
@@ -478,23 +538,30 @@ void Dashboard::saveMonthlyRevenueData(const QString& userId) {
     root["revenueData"] = revenueArray;
 
     QJsonDocument doc(root);
-    QFile file("data/" + userId + "_revenue.json");
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open file for writing!";
-        return;
+    if (!StorageEngine::instance().put("revenue", userId.toUtf8(), doc.toJson(QJsonDocument::Compact))) {
+        qWarning() << "Failed to save the monthly revenue!";
     }
-
-    file.write(doc.toJson());
-    file.close();
 }
 
+/**
+ * @brief Loads the monthly revenue table of a user from the database.
+ *
+ * Users whose revenue was saved by an older version still have it in
+ * data/<user>_revenue.json, which is read instead.
+ *
+ * @param userId The user whose revenue is loaded.
+ */
 void Dashboard::loadMonthlyRevenueData(const QString& userId) {
-    QFile file("data/" + userId + "_revenue.json");
-    if (!file.open(QIODevice::ReadOnly)) return;
+    QByteArray revenueJson;
+    if (!StorageEngine::instance().get("revenue", userId.toUtf8(), revenueJson)) {
+        QFile file("data/" + userId + "_revenue.json");
+        if (!file.open(QIODevice::ReadOnly)) return;
+        revenueJson = file.readAll();
+        file.close();
+    }
 
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QJsonDocument doc = QJsonDocument::fromJson(revenueJson);
     QJsonArray revenueArray = doc["revenueData"].toArray();
-    file.close();
 
     monthlyReportsTable->setRowCount(0);
     for (const QJsonValue& val : revenueArray) {
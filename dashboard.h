@@ -32,6 +32,7 @@ QT_END_NAMESPACE
 
 class InventoryPage;
 class QStackedWidget;
+class CashflowTracking;
 
 /**
  * @class Dashboard
@@ -124,6 +125,23 @@ public:
     */
     QTableWidget* getInventoryTable() const;
 
+    /**
+    * @brief Sets the ledger whose running totals the dashboard shows.
+    *
+    * The ledger must outlive the dashboard, or be reset to nullptr first.
+    *
+    * @param cashflowLedger The cashflow ledger, or nullptr to show none.
+    */
+    void setLedger(const CashflowTracking* cashflowLedger);
+
+    /**
+    * @brief Shows the current totals of the ledger in the labels and the pie chart.
+    *
+    * Reads the running aggregates of CashflowTracking instead of scanning the
+    * transactions, so it can be called after every change to the ledger.
+    */
+    void showLedgerTotals();
+
 
 private slots:
     /**
@@ -174,10 +192,16 @@ private:
      */
     void setupPieChart();
 
+    /**
+     * @brief Writes the ledger's total and current month outflows into their labels.
+     */
+    void showLedgerOutflows();
+
     QTabWidget* dashboardTabWidget = nullptr; // Pointer to the tab widget for dashboard navigation
 
     QString currentUserId;
     QTableWidget* monthlyReportsTable;
+    const CashflowTracking* ledger = nullptr; // Ledger whose running totals are shown, if any
 
 protected:
     void closeEvent(QCloseEvent* event) override;
@@ -191,6 +215,7 @@ protected:
     QLabel* monthlyReportsLabel;   // Label for the monthly reports section header.
     QLabel* cashInflowsLabel;      // Label displaying cash inflows.
     QLabel* cashOutflowsLabel;     // Label displaying cash outflows.
+    QLabel* monthOutflowsLabel;    // Label displaying the cash outflows of the current month.
 
     QTableWidget* inventoryTable;      // Table widget for displaying inventory data.
     //QTableWidget* monthlyReportsTable; // Table widget for displaying monthly revenue data.
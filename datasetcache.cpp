@@ -0,0 +1,139 @@
+#include "datasetcache.h"
+#include <QCryptographicHash>
+#include <QMutexLocker>
+
+/**
+ * @class datasetcache.cpp
+ * @brief Implements the shared cache of parsed financial CSV files.
+ */
+
+namespace {
+
+    /**
+     * @brief Hashes a chunk of a file's bytes.
+     */
+    QByteArray chunkHash(QByteArrayView bytes) {
+        return QCryptographicHash::hash(bytes, QCryptographicHash::Sha1);
+    }
+
+}
+
+/**
+ * @brief Computes the fingerprint of a file's contents.
+ *
+ * Every byte is hashed, in HashChunkBytes chunks. Hashing runs far faster than
+ * parsing, and keeping one hash per chunk lets isPrefixOf() check the old part
+ * of an appended file against hashes that were already computed here.
+ *
+ * @param contents The whole file.
+ * @return The fingerprint.
+ */
+DatasetCache::Fingerprint DatasetCache::Fingerprint::of(QByteArrayView contents) {
+    Fingerprint fingerprint;
+    fingerprint.size = contents.size();
+    const qint64 wholeChunks = contents.size() / HashChunkBytes;
+    fingerprint.chunkHashes.reserve(wholeChunks);
+    for (qint64 chunk = 0; chunk < wholeChunks; ++chunk) {
+        fingerprint.chunkHashes.append(chunkHash(contents.sliced(chunk * HashChunkBytes, HashChunkBytes)));
+    }
+    fingerprint.tailHash = chunkHash(contents.sliced(wholeChunks * HashChunkBytes));
+    return fingerprint;
+}
+
+/**
+ * @brief Checks whether two fingerprints describe the same file contents.
+ * @param other The other fingerprint.
+ * @return True if the size and every hash match.
+ */
+bool DatasetCache::Fingerprint::matches(const Fingerprint& other) const {
+    return size == other.size && chunkHashes == other.chunkHashes && tailHash == other.tailHash;
+}
+
+/**
+ * @brief Checks whether contents are this file with only new records appended.
+ *
+ * The whole chunks of the old contents are also whole chunks of the new ones,
+ * so their hashes are compared with the current fingerprint's. Only the old
+ * bytes after the last whole chunk are hashed again.
+ *
+ * @param current The fingerprint of contents.
+ * @param contents The whole current file.
+ * @return True if only bytes past size were added.
+ */
+bool DatasetCache::Fingerprint::isPrefixOf(const Fingerprint& current, QByteArrayView contents) const {
+    if (size <= 0 || contents.size() <= size || current.size != contents.size() || contents[size - 1] != '\n') {
+        return false; // Not longer, or the last old record was still open
+    }
+    const qint64 wholeChunks = chunkHashes.size();
+    if (current.chunkHashes.size() < wholeChunks) {
+        return false;
+    }
+    for (qint64 chunk = 0; chunk < wholeChunks; ++chunk) {
+        if (chunkHashes[chunk] != current.chunkHashes[chunk]) {
+            return false; // Edited, not just appended to
+        }
+    }
+    const qint64 tailStart = wholeChunks * HashChunkBytes;
+    return chunkHash(contents.sliced(tailStart, size - tailStart)) == tailHash;
+}
+
+/**
+ * @brief Gets the cache shared by all report generators.
+ * @return The cache.
+ */
+DatasetCache& DatasetCache::instance() {
+    static DatasetCache cache;
+    return cache;
+}
+
+/**
+ * @brief Looks up the dataset of a file.
+ * @param path Canonical path of the file.
+ * @param entry Receives a shallow copy of the entry.
+ * @return True if the file is cached, false otherwise.
+ */
+bool DatasetCache::find(const QString& path, Entry& entry) {
+    QMutexLocker locker(&mutex);
+    auto found = entries.constFind(path);
+    if (found == entries.constEnd()) {
+        return false;
+    }
+    entry = found.value(); // Implicitly shared, no rows are copied
+    touch(path);
+    return true;
+}
+
+/**
+ * @brief Stores the dataset of a file, replacing any older one.
+ *
+ * Drops the least recently used file once more than MaxEntries are cached.
+ *
+ * @param path Canonical path of the file.
+ * @param entry The dataset.
+ */
+void DatasetCache::insert(const QString& path, const Entry& entry) {
+    QMutexLocker locker(&mutex);
+    entries.insert(path, entry);
+    touch(path);
+    while (recentPaths.size() > MaxEntries) {
+        entries.remove(recentPaths.takeFirst());
+    }
+}
+
+/**
+ * @brief Drops every cached dataset.
+ */
+void DatasetCache::clear() {
+    QMutexLocker locker(&mutex);
+    entries.clear();
+    recentPaths.clear();
+}
+
+/**
+ * @brief Moves a path to the most recently used end.
+ * @param path The path.
+ */
+void DatasetCache::touch(const QString& path) {
+    recentPaths.removeOne(path);
+    recentPaths.append(path);
+}
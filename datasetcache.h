@@ -0,0 +1,117 @@
+#ifndef DATASETCACHE_H
+#define DATASETCACHE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include "financialreport.h"
+#include "transactionstore.h"
+
+/**
+ * @class DatasetCache
+ * @brief Process-wide cache of parsed financial CSV files.
+ *
+ * Keeps the transactions and report totals of the last few files that were
+ * loaded, keyed by canonical path. Every entry carries a fingerprint of the file
+ * it came from: its size and a hash of every HashChunkBytes chunk of its
+ * contents. It tells a loader whether the file is unchanged, was only appended
+ * to, or has to be parsed again. Every byte is hashed, so an edit anywhere in
+ * the file is noticed.
+ *
+ * TransactionStore and the totals are implicitly shared, so handing an entry
+ * out copies no rows. The cache is safe to use from several report jobs at once.
+ */
+class DatasetCache {
+public:
+    static constexpr int MaxEntries = 4;                  ///< Files kept before the least recently used one is dropped.
+    static constexpr qint64 HashChunkBytes = 1024 * 1024; ///< Bytes covered by one chunk hash.
+
+    /**
+     * @struct Fingerprint
+     * @brief Identifies the contents a dataset was parsed from.
+     */
+    struct Fingerprint {
+        qint64 size = -1;               // File size in bytes.
+        QList<QByteArray> chunkHashes;  // Hash of each whole HashChunkBytes chunk, in file order.
+        QByteArray tailHash;            // Hash of the bytes after the last whole chunk.
+
+        /**
+         * @brief Computes the fingerprint of a file's contents.
+         * @param contents The whole file.
+         * @return The fingerprint.
+         */
+        static Fingerprint of(QByteArrayView contents);
+
+        /**
+         * @brief Checks whether two fingerprints describe the same file contents.
+         * @param other The other fingerprint.
+         * @return True if the size and every hash match.
+         */
+        bool matches(const Fingerprint& other) const;
+
+        /**
+         * @brief Checks whether contents are this file with only new records appended.
+         *
+         * The old size must end on a line break, so the new bytes start with a
+         * fresh record, and every byte of the old contents must be unchanged.
+         *
+         * @param current The fingerprint of contents.
+         * @param contents The whole current file.
+         * @return True if only bytes past size were added.
+         */
+        bool isPrefixOf(const Fingerprint& current, QByteArrayView contents) const;
+    };
+
+    /**
+     * @struct Entry
+     * @brief One parsed file.
+     */
+    struct Entry {
+        Fingerprint fingerprint;                        // The contents that were parsed.
+        TransactionStore transactions;                  // Parsed transactions.
+        FinancialReportGenerator::ReportTotals totals;  // Totals of the transactions.
+    };
+
+    /**
+     * @brief Gets the cache shared by all report generators.
+     * @return The cache.
+     */
+    static DatasetCache& instance();
+
+    /**
+     * @brief Looks up the dataset of a file.
+     * @param path Canonical path of the file.
+     * @param entry Receives a shallow copy of the entry.
+     * @return True if the file is cached, false otherwise.
+     */
+    bool find(const QString& path, Entry& entry);
+
+    /**
+     * @brief Stores the dataset of a file, replacing any older one.
+     * @param path Canonical path of the file.
+     * @param entry The dataset.
+     */
+    void insert(const QString& path, const Entry& entry);
+
+    /**
+     * @brief Drops every cached dataset.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Moves a path to the most recently used end.
+     * @param path The path.
+     */
+    void touch(const QString& path);
+
+    QMutex mutex;                   // Guards everything below.
+    QHash<QString, Entry> entries;  // Cached datasets by canonical path.
+    QStringList recentPaths;        // Cached paths, least recently used first.
+};
+
+#endif // DATASETCACHE_H
@@ -1,12 +1,23 @@
 #include "financialreport.h"
+#include "csvreader.h"
+#include "csvwriter.h"
+#include "aggregationkernels.h"
+#include "datasetcache.h"
+#include "columnarexport.h"
 #include <QFile>
-#include <QTextStream>
 #include <QDebug>
 #include <QFileInfo>
 #include <QCoreApplication>
 #include <QDir>
+#include <QDate>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <memory>
 
 /**
  * @class FinancialReportGenerator
@@ -22,14 +33,13 @@
  /**
   * @brief Constructor for FinancialReportGenerator.
   *
-  * Initializes the FinancialReportGenerator object and sets the transactions list to empty.
+  * Initializes the FinancialReportGenerator object with an empty transaction store.
   * Logs the initialization message for debugging purposes.
   *
   * @author Simran Kullar
   */
 FinancialReportGenerator::FinancialReportGenerator() {
-    // Initialize the transactions list as an empty QList of Transaction objects.
-    transactions = QList<Transaction>();
+    // The transaction store starts out empty, all of its columns have no rows.
     // Log a debug message to indicate that the constructor has been called
     // and display the initial size of the transactions list (should be 0).
     qDebug() << "Constructor: FinancialReportGenerator initialized, transactions size =" << transactions.size();
@@ -54,13 +64,35 @@ FinancialReportGenerator::~FinancialReportGenerator() {
  *
  * This function reads a CSV file, parses each line into a Transaction object,
  * and stores the transactions in the `transactions` list. It skips malformed lines
- * and logs errors or warnings as needed.
+ * and logs errors or warnings as needed. The file is memory-mapped through CsvReader
+ * and fields are validated as views, so only accepted rows allocate strings and
+ * there is no limit on the number of rows.
+ *
+ * The path is found by resolveCSVPath() and the file is read by loadResolvedCSV().
  *
  * @param filename The path to the CSV file to load.
  * @return True if the file was successfully loaded and contains valid transactions, false otherwise.
  * @author Simran Kullar
  */
 bool FinancialReportGenerator::loadCSV(const QString& filename) {
+    QString filePath = resolveCSVPath(filename); // May ask the user to pick the file
+    if (filePath.isEmpty()) {
+        return false; // Return false if the file was not found
+    }
+    return loadResolvedCSV(filePath);
+}
+
+/**
+ * @brief Finds a CSV file in the usual locations, asking the user as a last resort.
+ *
+ * Checks the given path, the executable directory, the working directory and its
+ * parent. If none of them has the file, a QFileDialog lets the user select it,
+ * which is why this must run on the GUI thread.
+ *
+ * @param filename The name of the CSV file to find.
+ * @return The path of the file, or an empty string if it was not found.
+ */
+QString FinancialReportGenerator::resolveCSVPath(const QString& filename) {
     // Try multiple possible locations for the file
     QStringList possiblePaths;
 
@@ -130,87 +162,295 @@ bool FinancialReportGenerator::loadCSV(const QString& filename) {
             }
         }
 
-        // If the file is still not found, return false
+        // If the file is still not found, return an empty path
         if (!fileFound) {
-            return false;
+            return QString();
         }
     }
+    return filePath;
+}
 
-    // Open the file for reading
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "Error: Unable to open file:" << filePath << ", Error:" << file.errorString();
+/**
+ * @brief Loads transactions from a CSV file whose path is already known.
+ *
+ * This function reads a CSV file, parses each line into a transaction and stores
+ * it in the `transactions` store. It skips malformed lines and logs errors or
+ * warnings as needed. It never shows any UI, so report jobs call it on a worker thread.
+ *
+ * Parsed files are kept in the shared DatasetCache. If the file still has the
+ * fingerprint it had when it was cached, nothing is parsed at all. If records were
+ * only appended since then, just the new tail is parsed and its totals are added
+ * to the cached ones. Any other change parses the whole file again.
+ *
+ * With a progress callback, the chunks are always parsed on a local thread pool
+ * while the calling thread reports the parsed byte count every ProgressIntervalMs.
+ * When the callback returns false the workers stop at their next check and the
+ * partial data is dropped.
+ *
+ * @param filePath The path of the CSV file.
+ * @param progress Optional progress callback that can cancel the load.
+ * @return True if the file was loaded and contains valid transactions, false otherwise.
+ */
+bool FinancialReportGenerator::loadResolvedCSV(const QString& filePath, const LoadProgress& progress) {
+    // Map the file and tokenize it in place; fields come back as views into the mapping
+    CsvReader reader;
+    if (!reader.open(filePath)) {
+        qDebug() << "Error: Unable to open file:" << filePath << ", Error:" << reader.errorString();
         return false; // Return false if the file cannot be opened
     }
 
-    QTextStream in(&file); // Create a QTextStream to read the file line by line
-
     // Clear the existing transactions list safely
-    qDebug() << "Before clearing: transactions size =" << transactions.size();
     transactions.clear(); // Clear the list
-    qDebug() << "After clearing: transactions size =" << transactions.size();
+    totals = ReportTotals(); // Totals of the previous file no longer apply
+    totalsValid = false;
+
+    QElapsedTimer timer; // Times the load so the debug log shows the parse throughput
+    timer.start();
+
+    // Compare the file with what was parsed from it last time
+    const QFileInfo fileInfo(filePath);
+    const QString cacheKey = fileInfo.canonicalFilePath();
+    const DatasetCache::Fingerprint fingerprint = DatasetCache::Fingerprint::of(reader.contents());
+    DatasetCache::Entry cached;
+    const bool isCached = DatasetCache::instance().find(cacheKey, cached);
+
+    if (isCached && cached.fingerprint.matches(fingerprint)) {
+        // Unchanged since the last load, take the parsed rows and totals as they are
+        transactions = cached.transactions;
+        totals = cached.totals;
+        totalsValid = true;
+        reader.close();
+        if (progress) {
+            progress(fingerprint.size, fingerprint.size);
+        }
+        qDebug() << "Using cached" << transactions.size() << "rows of unchanged" << filePath;
+        return !transactions.isEmpty();
+    }
+
+    // Only appended to: keep the cached rows and parse just the new records
+    QByteArrayView bytesToParse = reader.contents();
+    const bool appendOnly = isCached && cached.fingerprint.isPrefixOf(fingerprint, reader.contents());
+    if (appendOnly) {
+        bytesToParse = bytesToParse.sliced(cached.fingerprint.size);
+        qDebug() << "Parsing" << bytesToParse.size() << "appended bytes of" << filePath;
+    }
+
+    TransactionStore parsed;
+    ReportTotals parsedTotals;
+    if (!parseRecords(bytesToParse, parsed, parsedTotals, progress)) {
+        reader.close();
+        qDebug() << "Loading" << filePath << "was cancelled";
+        return false; // Nothing stays loaded and the cache keeps its old entry
+    }
+
+    if (appendOnly) {
+        transactions = cached.transactions;
+        transactions.append(parsed); // Detaches from the cached copy, other users keep seeing the old rows
+        totals = cached.totals;
+        mergeTotals(totals, parsedTotals); // Exact cents, so adding the tail's totals is the same as recomputing
+    }
+    else {
+        transactions = std::move(parsed);
+        totals = parsedTotals;
+    }
+    totalsValid = true; // The partial totals already cover every row
+
+    DatasetCache::instance().insert(cacheKey, DatasetCache::Entry{ fingerprint, transactions, totals });
+
+    qint64 elapsedNs = qMax<qint64>(timer.nsecsElapsed(), 1);
+    qDebug() << "Parsed" << transactions.size() << "rows in" << elapsedNs / 1000000 << "ms ("
+        << static_cast<qint64>(transactions.size() * 1e9 / elapsedNs) << "rows/s)";
+
+    reader.close(); // Unmap and close the file after reading
+    qDebug() << "Total transactions loaded: " << transactions.size(); // Log the total number of transactions loaded
+    if (transactions.unparsedDateCount() > 0) {
+        // Their text is kept, but without a day they cannot be put into a month
+        qDebug() << "Warning:" << transactions.unparsedDateCount()
+            << "transactions have a date that is not yyyy-MM-dd and are left out of the monthly totals";
+    }
+    return !transactions.isEmpty(); // Return true if at least one transaction was loaded, otherwise false
+}
+
+/**
+ * @brief Gets the pool every parse runs its chunks on.
+ *
+ * Sized once to the number of cores. It is not the global pool: report jobs run
+ * there and wait for their chunks, and chunks queued behind those waiting jobs
+ * could never start.
+ *
+ * @return The pool.
+ */
+QThreadPool& FinancialReportGenerator::parsePool() {
+    static QThreadPool pool;
+    static const bool sized = [] {
+        pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+        return true;
+    }();
+    Q_UNUSED(sized);
+    return pool;
+}
+
+/**
+ * @brief Parses CSV records into a store and computes their totals.
+ *
+ * Large inputs are split into record-aligned chunks that are parsed on all cores
+ * at once. The chunks run on the shared parsePool(), so concurrent loads queue
+ * behind each other there instead of oversubscribing the CPU with one pool each.
+ * Every chunk fills its own store and partial totals, which are merged
+ * in input order afterwards, so the rows come out in the same order as a
+ * sequential parse.
+ *
+ * @param bytes The records to parse, starting at a record boundary.
+ * @param store Receives the valid transactions.
+ * @param storeTotals Receives the totals of the transactions.
+ * @param progress Optional progress callback that can cancel the parse.
+ * @return True if the records were parsed, false if the parse was cancelled.
+ */
+bool FinancialReportGenerator::parseRecords(QByteArrayView bytes, TransactionStore& store, ReportTotals& storeTotals,
+    const LoadProgress& progress) {
+    // Cut the input into record-aligned chunks, one per core once it is big enough
+    const int workerCount = parsePool().maxThreadCount();
+    const qint64 chunkCount = qBound<qint64>(1, bytes.size() / MinimumChunkBytes, workerCount);
+    const QVector<QByteArrayView> chunks = CsvReader::splitRecords(bytes, static_cast<int>(chunkCount));
+
+    // Every chunk gets its own store and totals, so the workers only share the progress counters
+    QVector<TransactionStore> chunkStores(chunks.size());
+    QVector<ReportTotals> chunkTotals(chunks.size());
+    TransactionStore* stores = chunkStores.data(); // Raw pointers, so no worker ever touches the vectors themselves
+    ReportTotals* partialTotals = chunkTotals.data();
+    std::atomic<bool> canceled(false);
+    std::atomic<qint64> bytesParsed(0);
+    auto parseChunk = [&chunks, stores, partialTotals, &canceled, &bytesParsed](int index) {
+        CsvReader chunkReader;
+        chunkReader.attach(chunks[index]);
+        parseTransactions(chunkReader, stores[index], index, canceled, bytesParsed);
+        if (!canceled.load(std::memory_order_relaxed)) {
+            partialTotals[index] = totalsOf(stores[index]);
+        }
+    };
+
+    if (chunks.size() == 1 && !progress) {
+        parseChunk(0); // Small input and nobody waiting for progress, not worth starting threads
+    }
+    else {
+        // The pool is shared with other loads, so this parse waits for its own chunks only. Each chunk holds
+        // the semaphore too, since release() may still touch it after this thread has woken up and returned
+        auto chunksDone = std::make_shared<QSemaphore>();
+        for (int index = 0; index < chunks.size(); ++index) {
+            parsePool().start([&parseChunk, chunksDone, index]() {
+                parseChunk(index);
+                chunksDone->release();
+            });
+        }
+
+        // Report from this thread only, so the callback never runs on several threads at once.
+        // Even a cancelled parse waits for every chunk, they write into this scope
+        while (!chunksDone->tryAcquire(static_cast<int>(chunks.size()), progress ? ProgressIntervalMs : -1)) {
+            if (!progress(bytesParsed.load(std::memory_order_relaxed), bytes.size())) {
+                canceled.store(true, std::memory_order_relaxed);
+            }
+        }
+        if (progress && !canceled.load(std::memory_order_relaxed) && !progress(bytes.size(), bytes.size())) {
+            canceled.store(true, std::memory_order_relaxed); // Cancelled right as parsing finished
+        }
+    }
 
-    int lineNum = 0; // Track the current line number
-    const int maxLines = 100000; // Safety limit to prevent infinite loops
+    if (canceled.load(std::memory_order_relaxed)) {
+        return false; // The chunk stores go away with this scope
+    }
 
-    // Read the file line by line until the end or the safety limit is reached
-    while (!in.atEnd() && lineNum < maxLines) {
-        QString line = in.readLine(); // Read the next line
-        lineNum++; // Increment the line counter
+    // Merge in input order, so the rows keep the order they have in the file
+    for (int index = 0; index < chunks.size(); ++index) {
+        if (index == 0) {
+            store = std::move(chunkStores[0]);
+        }
+        else {
+            store.append(chunkStores[index]);
+            chunkStores[index].clear(); // Release the chunk as soon as it is merged
+        }
+        mergeTotals(storeTotals, chunkTotals[index]);
+    }
+    qDebug() << "Parsed" << bytes.size() << "bytes in" << chunks.size() << "chunks";
+    return true;
+}
+
+/**
+ * @brief Parses every record of a reader into a store.
+ *
+ * Runs on a worker thread for each chunk of a large file, so it only touches the
+ * reader and store it is given.
+ *
+ * @param reader The reader positioned at the first record.
+ * @param store The store receiving the valid transactions.
+ * @param chunkIndex Index of the chunk being read, for the log messages.
+ * @param canceled Set by the loading thread to stop parsing early.
+ * @param bytesParsed Running byte count shared by all chunks, for progress reports.
+ */
+void FinancialReportGenerator::parseTransactions(CsvReader& reader, TransactionStore& store, int chunkIndex,
+    const std::atomic<bool>& canceled, std::atomic<qint64>& bytesParsed) {
+    QVector<QByteArrayView> values; // Field views of the current row, reused for every row
+    values.reserve(7);
+    QByteArray unescapeBuffers[7]; // Only used by fields that contain escaped quotes
+    qint64 bytesReported = 0; // Part of this chunk already added to bytesParsed
+    int rowsUntilCheck = RowsPerProgressCheck;
+
+    // Read the file record by record until the end; there is no row limit
+    while (reader.readRow(values)) {
+        // Every few thousand rows, publish the progress and stop if the load was cancelled
+        if (--rowsUntilCheck == 0) {
+            rowsUntilCheck = RowsPerProgressCheck;
+            bytesParsed.fetch_add(reader.bytesRead() - bytesReported, std::memory_order_relaxed);
+            bytesReported = reader.bytesRead();
+            if (canceled.load(std::memory_order_relaxed)) {
+                return;
+            }
+        }
 
         // Skip empty lines (after trimming whitespace)
-        if (line.trimmed().isEmpty()) {
+        if (values.size() == 1 && CsvReader::trimmed(values[0]).isEmpty()) {
             continue;
         }
 
-        // Split the line into values using commas as the delimiter
-        QStringList values = line.split(',');
-
         // Ensure the line has at least 7 columns (expected format)
         if (values.size() < 7) {
-            qDebug() << "Skipping malformed line " << lineNum << ": " << line;
+            qDebug() << "Skipping malformed line " << reader.lineNumber() << " of chunk " << chunkIndex;
             continue; // Skip lines with insufficient columns
         }
 
-        // Create a new Transaction object and populate its fields
-        Transaction txn;
-        txn.date = values[0].trimmed(); // Assign the date (first column)
-        txn.transactionID = values[1].trimmed(); // Assign the transaction ID (second column)
-        txn.type = values[2].trimmed(); // Assign the transaction type (third column)
-        txn.description = values[3].trimmed(); // Assign the description (fourth column)
-
-        // Parse the amount (fifth column) and validate it
+        // Parse the amount (fifth column) straight into exact cents, before anything else is done
+        QByteArrayView amountField = CsvReader::trimmed(values[4]);
         bool isAmountValid;
-        txn.amount = values[4].trimmed().toDouble(&isAmountValid);
+        Money amount = Money::parse(std::string_view(amountField.data(), amountField.size()), &isAmountValid);
         if (!isAmountValid) {
-            qDebug() << "Invalid amount on line " << lineNum << ": " << values[4];
+            qDebug() << "Invalid amount on line " << reader.lineNumber() << " of chunk " << chunkIndex << ": " << values[4];
             continue; // Skip lines with invalid amounts
         }
 
-        txn.paymentMethod = values[5].trimmed(); // Assign the payment method (sixth column)
-        txn.category = values[6].trimmed(); // Assign the category (seventh column)
+        // Trim every field and collapse escaped quotes, still without copying in the common case
+        for (int column = 0; column < 7; ++column) {
+            values[column] = CsvReader::unescaped(CsvReader::trimmed(values[column]), unescapeBuffers[column]);
+        }
 
-        // Validate mandatory fields (transactionID, type, description, category)
-        if (txn.transactionID.isEmpty() || txn.type.isEmpty() ||
-            txn.description.isEmpty() || txn.category.isEmpty()) {
-            qDebug() << "Skipping invalid transaction at line " << lineNum;
+        // Validate mandatory fields (transactionID, type, description, category) on the views
+        if (values[1].isEmpty() || values[2].isEmpty() ||
+            values[3].isEmpty() || values[6].isEmpty()) {
+            qDebug() << "Skipping invalid transaction at line " << reader.lineNumber() << " of chunk " << chunkIndex;
             continue; // Skip transactions with missing mandatory fields
         }
 
-        // Add the valid transaction to the transactions list
-        transactions.append(txn);
+        // Append the row to the columnar store: the date is packed into a day number,
+        // type, payment method and category are interned as integer codes, and the
+        // ID and description are copied into the store's string heap
+        store.append(values[0], values[1], values[2], values[3], amount, values[5], values[6]);
     }
-
-    file.close(); // Close the file after reading
-    qDebug() << "Total transactions loaded: " << transactions.size(); // Log the total number of transactions loaded
-    return !transactions.isEmpty(); // Return true if at least one transaction was loaded, otherwise false
+    bytesParsed.fetch_add(reader.bytesRead() - bytesReported, std::memory_order_relaxed);
 }
 
 /**
  * @brief Generates a Profit & Loss Statement and saves it to a file.
  *
- * This function calculates the total income, total expenses, and net profit
- * from the loaded transactions and writes the results to the specified output file.
+ * This function reads the total income and total expenses from computeTotals(),
+ * derives the net profit and writes the results to the specified output file.
  *
  * @param outputFilename The path to the file where the Profit & Loss Statement will be saved.
  * @author Simran Kullar
@@ -222,42 +462,33 @@ void FinancialReportGenerator::generateProfitLossStatement(const QString& output
         return; // Exit the function if no transactions are available
     }
 
-    // Initialize variables to store total income and total expenses
-    double totalIncome = 0.0;
-    double totalExpenses = 0.0;
-
-    // Iterate through all transactions to calculate totals
-    for (const auto& txn : transactions) {
-        if (txn.type == "Income") {
-            // Add the amount to total income if the transaction type is "Income"
-            totalIncome += txn.amount;
-        }
-        else if (txn.type == "Expense") {
-            // Add the amount to total expenses if the transaction type is "Expense"
-            totalExpenses += txn.amount;
-        }
-    }
+    // Get total income and total expenses from the shared single-pass totals
+    const ReportTotals& reportTotals = computeTotals();
+    Money totalIncome = reportTotals.totalIncome;
+    Money totalExpenses = reportTotals.totalExpenses;
 
     // Calculate net profit by subtracting total expenses from total income
-    double netProfit = totalIncome - totalExpenses;
+    Money netProfit = totalIncome - totalExpenses;
 
-    // Open the output file for writing
-    QFile file(outputFilename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
+    // Open the output file for writing; it only replaces the old report once complete
+    CsvWriter out;
+    if (!out.open(outputFilename)) {
+        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << out.errorString();
         return; // Exit the function if the file cannot be opened for writing
     }
 
-    // Create a QTextStream to write the report to the file
-    QTextStream out(&file);
-    out << "Profit & Loss Statement\n"; // Write the report header
-    out << "------------------------\n"; // Write a separator line
-    out << "Total Income: $" << totalIncome << "\n"; // Write total income
-    out << "Total Expenses: $" << totalExpenses << "\n"; // Write total expenses
-    out << "Net Profit: $" << netProfit << "\n"; // Write net profit
-
-    // Close the file after writing
-    file.close();
+    // Write the report through the shared buffered writer, one line at a time
+    out.writeLine("Profit & Loss Statement"); // Write the report header
+    out.writeLine("------------------------"); // Write a separator line
+    out.writeLine("Total Income: $" + totalIncome.toQString()); // Write total income
+    out.writeLine("Total Expenses: $" + totalExpenses.toQString()); // Write total expenses
+    out.writeLine("Net Profit: $" + netProfit.toQString()); // Write net profit
+
+    // Replace the old report with the complete new one
+    if (!out.commit()) {
+        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << out.errorString();
+        return;
+    }
 
     // Log a message to confirm that the report was saved successfully
     qDebug() << "Profit & Loss Statement saved to " << outputFilename;
@@ -266,8 +497,8 @@ void FinancialReportGenerator::generateProfitLossStatement(const QString& output
 /**
  * @brief Generates an Expense Breakdown Report and saves it to a file.
  *
- * This function categorizes expenses by their category and calculates the total
- * amount spent in each category. The results are written to the specified output file.
+ * This function reads the total amount spent in each expense category from
+ * computeTotals() and writes the results to the specified output file.
  *
  * @param outputFilename The path to the file where the Expense Breakdown Report will be saved.
  * @author Simran Kullar
@@ -279,41 +510,35 @@ void FinancialReportGenerator::generateExpenseBreakdownReport(const QString& out
         return; // Exit the function if no transactions are available
     }
 
-    // Create a QMap to store expense categories and their corresponding totals
-    QMap<QString, double> expenseCategories;
-
-    // Iterate through all transactions to categorize expenses
-    for (const auto& txn : transactions) {
-        if (txn.type == "Expense") {
-            // Add the transaction amount to the corresponding category in the QMap
-            expenseCategories[txn.category] += txn.amount;
-        }
-    }
+    // Get the expense totals per category from the shared single-pass totals
+    const QMap<QString, Money>& expenseCategories = computeTotals().expenseCategories;
 
     // Check if any expense transactions were found
     if (expenseCategories.isEmpty()) {
         qDebug() << "Warning: No expense transactions found"; // Log a warning if no expenses were found
     }
 
-    // Open the output file for writing
-    QFile file(outputFilename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
+    // Open the output file for writing; it only replaces the old report once complete
+    CsvWriter out;
+    if (!out.open(outputFilename)) {
+        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << out.errorString();
         return; // Exit the function if the file cannot be opened for writing
     }
 
-    // Create a QTextStream to write the report to the file
-    QTextStream out(&file);
-    out << "Expense Breakdown Report\n"; // Write the report header
-    out << "------------------------\n"; // Write a separator line
+    // Write the report through the shared buffered writer, one line at a time
+    out.writeLine("Expense Breakdown Report"); // Write the report header
+    out.writeLine("------------------------"); // Write a separator line
 
     // Iterate through the QMap and write each category and its total amount to the file
     for (auto it = expenseCategories.constBegin(); it != expenseCategories.constEnd(); ++it) {
-        out << it.key() << ": $" << it.value() << "\n"; // Write category and amount
+        out.writeLine(it.key() + ": $" + it.value().toQString()); // Write category and amount
     }
 
-    // Close the file after writing
-    file.close();
+    // Replace the old report with the complete new one
+    if (!out.commit()) {
+        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << out.errorString();
+        return;
+    }
 
     // Log a message to confirm that the report was saved successfully
     qDebug() << "Expense Breakdown Report saved to " << outputFilename;
@@ -322,8 +547,9 @@ void FinancialReportGenerator::generateExpenseBreakdownReport(const QString& out
 /**
  * @brief Generates a Balance Sheet Report and saves it to a file.
  *
- * This function calculates the total assets, total liabilities, and net worth
- * from the loaded transactions and writes the results to the specified output file.
+ * This function reads the total assets (income) and total liabilities (expenses)
+ * from computeTotals(), derives the net worth and writes the results to the
+ * specified output file.
  *
  * @param outputFilename The path to the file where the Balance Sheet Report will be saved.
  * @author Simran Kullar
@@ -335,43 +561,334 @@ void FinancialReportGenerator::generateBalanceSheetReport(const QString& outputF
         return; // Exit the function if no transactions are available
     }
 
-    // Initialize variables to store total assets and total liabilities
-    double totalAssets = 0.0;
-    double totalLiabilities = 0.0;
+    // Income counts as assets and expenses as liabilities, both come from the shared totals
+    const ReportTotals& reportTotals = computeTotals();
+    Money totalAssets = reportTotals.totalIncome;
+    Money totalLiabilities = reportTotals.totalExpenses;
 
-    // Iterate through all transactions to calculate totals
-    for (const auto& txn : transactions) {
-        if (txn.type == "Income") {
-            // Add the amount to total assets if the transaction type is "Income"
-            totalAssets += txn.amount;
-        }
-        else if (txn.type == "Expense") {
-            // Add the amount to total liabilities if the transaction type is "Expense"
-            totalLiabilities += txn.amount;
-        }
+    // Calculate net worth by subtracting total liabilities from total assets
+    Money netWorth = totalAssets - totalLiabilities;
+
+    // Open the output file for writing; it only replaces the old report once complete
+    CsvWriter out;
+    if (!out.open(outputFilename)) {
+        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << out.errorString();
+        return; // Exit the function if the file cannot be opened for writing
     }
 
-    // Calculate net worth by subtracting total liabilities from total assets
-    double netWorth = totalAssets - totalLiabilities;
+    // Write the report through the shared buffered writer, one line at a time
+    out.writeLine("Balance Sheet Report"); // Write the report header
+    out.writeLine("----------------------"); // Write a separator line
+    out.writeLine("Total Assets: $" + totalAssets.toQString()); // Write total assets
+    out.writeLine("Total Liabilities: $" + totalLiabilities.toQString()); // Write total liabilities
+    out.writeLine("Net Worth: $" + netWorth.toQString()); // Write net worth
+
+    // Replace the old report with the complete new one
+    if (!out.commit()) {
+        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << out.errorString();
+        return;
+    }
 
-    // Open the output file for writing
-    QFile file(outputFilename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
+    // Log a message to confirm that the report was saved successfully
+    qDebug() << "Balance Sheet Report saved to " << outputFilename;
+}
+
+/**
+ * @brief Generates a Transaction Summary Report and saves it to a file.
+ *
+ * Writes the totals by transaction type, income and expenses month by month,
+ * and expenses by payment method. All of it comes from the totals that were
+ * materialized while loading, so nothing is rescanned.
+ *
+ * @param outputFilename The path to the file where the Transaction Summary Report will be saved.
+ */
+void FinancialReportGenerator::generateTransactionSummaryReport(const QString& outputFilename) {
+    // Check if there are any transactions to process
+    if (transactions.isEmpty()) {
+        qDebug() << "Error: No transactions available for generating transaction summary";
+        return; // Exit the function if no transactions are available
+    }
+
+    const ReportTotals& reportTotals = computeTotals();
+
+    // Open the output file for writing; it only replaces the old report once complete
+    CsvWriter out;
+    if (!out.open(outputFilename)) {
+        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << out.errorString();
         return; // Exit the function if the file cannot be opened for writing
     }
 
-    // Create a QTextStream to write the report to the file
-    QTextStream out(&file);
-    out << "Balance Sheet Report\n"; // Write the report header
-    out << "----------------------\n"; // Write a separator line
-    out << "Total Assets: $" << totalAssets << "\n"; // Write total assets
-    out << "Total Liabilities: $" << totalLiabilities << "\n"; // Write total liabilities
-    out << "Net Worth: $" << netWorth << "\n"; // Write net worth
+    out.writeLine("Transaction Summary Report"); // Write the report header
+    out.writeLine("--------------------------"); // Write a separator line
 
-    // Close the file after writing
-    file.close();
+    // Every transaction type, including types other than income and expense
+    out.writeLine("By Type");
+    for (auto it = reportTotals.typeTotals.constBegin(); it != reportTotals.typeTotals.constEnd(); ++it) {
+        out.writeLine(it.key() + ": $" + it.value().toQString());
+    }
+
+    // Month by month, straight from the materialized monthly totals
+    QStringList months = reportTotals.monthlyIncome.keys() + reportTotals.monthlyExpenses.keys();
+    months.sort();
+    months.removeDuplicates();
+    out.writeLine(""); // Blank line before the section
+    out.writeLine("By Month");
+    for (const QString& month : months) {
+        Money income = reportTotals.monthlyIncome.value(month);
+        Money expenses = reportTotals.monthlyExpenses.value(month);
+        out.writeLine(month + ": Income $" + income.toQString() + ", Expenses $" + expenses.toQString()
+            + ", Net $" + (income - expenses).toQString());
+    }
+
+    // Expenses split by how they were paid
+    out.writeLine(""); // Blank line before the section
+    out.writeLine("Expenses By Payment Method");
+    for (auto it = reportTotals.expensePaymentMethods.constBegin(); it != reportTotals.expensePaymentMethods.constEnd(); ++it) {
+        out.writeLine(it.key() + ": $" + it.value().toQString());
+    }
+
+    // Replace the old report with the complete new one
+    if (!out.commit()) {
+        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << out.errorString();
+        return;
+    }
 
     // Log a message to confirm that the report was saved successfully
-    qDebug() << "Balance Sheet Report saved to " << outputFilename;
-}
\ No newline at end of file
+    qDebug() << "Transaction Summary Report saved to " << outputFilename;
+}
+
+/**
+ * @brief Generates every report from a single scan of the loaded transactions.
+ *
+ * The totals for all three reports are filled by one call to computeTotals(),
+ * then the Profit & Loss Statement, Expense Breakdown and Balance Sheet are
+ * written one after another. Combined with a single loadCSV() call this costs
+ * one file read and one scan instead of three of each.
+ *
+ * @param profitLossFilename The file where the Profit & Loss Statement will be saved.
+ * @param expenseBreakdownFilename The file where the Expense Breakdown Report will be saved.
+ * @param balanceSheetFilename The file where the Balance Sheet Report will be saved.
+ */
+void FinancialReportGenerator::generateAllReports(const QString& profitLossFilename,
+    const QString& expenseBreakdownFilename, const QString& balanceSheetFilename) {
+    // Check if there are any transactions to process
+    if (transactions.isEmpty()) {
+        qDebug() << "Error: No transactions available for generating reports";
+        return; // Exit the function if no transactions are available
+    }
+
+    computeTotals(); // One pass fills the totals of all three reports
+
+    // The generators below only read the cached totals, none of them rescans
+    generateProfitLossStatement(profitLossFilename);
+    generateExpenseBreakdownReport(expenseBreakdownFilename);
+    generateBalanceSheetReport(balanceSheetFilename);
+}
+
+/**
+ * @brief Exports the loaded transactions to a compressed columnar file.
+ *
+ * The store is already columnar and dictionary-encoded, so its columns are
+ * written as they are, without decoding any transaction.
+ *
+ * @param outputFilename The path to the file where the transactions will be saved.
+ * @return True if the file was written, false otherwise.
+ */
+bool FinancialReportGenerator::exportColumnar(const QString& outputFilename) const {
+    // Check if there are any transactions to export
+    if (transactions.isEmpty()) {
+        qDebug() << "Error: No transactions available for the columnar export";
+        return false;
+    }
+    return ColumnarExport::write(outputFilename, transactions);
+}
+
+/**
+ * @brief Computes the totals used by all reports in a single pass.
+ *
+ * Income and expense totals and the per-category expense map are filled from the
+ * type, category and amount columns by the vectorized AggregationKernels, which
+ * pick an AVX2 or scalar implementation for the running CPU. The result is cached until the next
+ * loadCSV(), so generating several reports from the same data scans it only once.
+ *
+ * @return The totals of the currently loaded transactions.
+ */
+const FinancialReportGenerator::ReportTotals& FinancialReportGenerator::computeTotals() {
+    if (totalsValid) {
+        return totals; // Already computed for the loaded transactions
+    }
+
+    totals = totalsOf(transactions);
+    totalsValid = true;
+    return totals;
+}
+
+/**
+ * @brief Computes the report totals of a store with the aggregation kernels.
+ *
+ * Only reads the given store, so it is safe to call for several chunks at once.
+ *
+ * @param store The transactions to aggregate.
+ * @return The totals of the store.
+ */
+FinancialReportGenerator::ReportTotals FinancialReportGenerator::totalsOf(const TransactionStore& store) {
+    ReportTotals result;
+
+    // Resolve the type names to their dictionary codes once, the scan compares integers only
+    const quint32 incomeCode = store.types().find("Income");
+    const quint32 expenseCode = store.types().find("Expense");
+
+    const qsizetype rowCount = store.size();
+    const quint32* typeCodes = store.typeColumn().constData();
+    const quint32* categoryCodes = store.categoryColumn().constData();
+    const std::int64_t* amounts = store.amountColumn().constData(); // Cents
+
+    // Per-category expense sums and row counts indexed by category code
+    const int categoryCount = store.categories().size();
+    QVector<std::int64_t> categoryTotals(categoryCount, 0);
+    QVector<std::uint64_t> categoryRows(categoryCount, 0);
+
+    // Income feeds total income (P&L) and total assets (balance sheet);
+    // expenses feed total expenses and total liabilities
+    std::int64_t incomeCents = 0;
+    std::int64_t expenseCents = 0;
+    AggregationKernels::sumByTwoCodes(typeCodes, amounts, static_cast<std::size_t>(rowCount),
+        incomeCode, expenseCode, incomeCents, expenseCents);
+    result.totalIncome = Money::fromCents(incomeCents);
+    result.totalExpenses = Money::fromCents(expenseCents);
+
+    // Expenses also feed the category breakdown
+    AggregationKernels::sumByKeyWhere(typeCodes, categoryCodes, amounts, static_cast<std::size_t>(rowCount),
+        expenseCode, categoryTotals.data(), categoryRows.data());
+
+    // Decode the category codes back to names for the report
+    for (int code = 0; code < categoryCount; ++code) {
+        if (categoryRows[code] > 0) {
+            result.expenseCategories.insert(store.categories().value(code), Money::fromCents(categoryTotals[code]));
+        }
+    }
+
+    // Expenses by payment method, with the same kernel
+    const quint32* paymentCodes = store.paymentMethodColumn().constData();
+    const int paymentCount = store.paymentMethods().size();
+    QVector<std::int64_t> paymentTotals(paymentCount, 0);
+    QVector<std::uint64_t> paymentRows(paymentCount, 0);
+    AggregationKernels::sumByKeyWhere(typeCodes, paymentCodes, amounts, static_cast<std::size_t>(rowCount),
+        expenseCode, paymentTotals.data(), paymentRows.data());
+    for (int code = 0; code < paymentCount; ++code) {
+        if (paymentRows[code] > 0) {
+            result.expensePaymentMethods.insert(store.paymentMethods().value(code), Money::fromCents(paymentTotals[code]));
+        }
+    }
+
+    // Totals by type and by month in one pass; rows are mostly in date order, so the
+    // month of a day is only worked out when the day changes
+    const qint32* days = store.dateColumn().constData();
+    const int typeCount = store.types().size();
+    QVector<std::int64_t> typeTotals(typeCount, 0);
+    QVector<std::uint64_t> typeRows(typeCount, 0);
+    QHash<qint32, int> monthSlots; // yyyymm -> position in the month vectors
+    QVector<qint32> months;
+    QVector<std::int64_t> monthIncome;
+    QVector<std::int64_t> monthExpenses;
+    qint32 lastDay = TransactionStore::InvalidDate;
+    int monthSlot = -1;
+    for (qsizetype row = 0; row < rowCount; ++row) {
+        const quint32 type = typeCodes[row];
+        typeTotals[type] += amounts[row];
+        typeRows[type]++;
+
+        if ((type != incomeCode && type != expenseCode) || days[row] == TransactionStore::InvalidDate) {
+            continue; // Only income and expenses have monthly totals, and only with a valid date
+        }
+        if (days[row] != lastDay) {
+            lastDay = days[row];
+            const QDate date = QDate::fromJulianDay(lastDay);
+            const qint32 month = date.year() * 100 + date.month();
+            monthSlot = monthSlots.value(month, -1);
+            if (monthSlot < 0) {
+                monthSlot = static_cast<int>(months.size());
+                monthSlots.insert(month, monthSlot);
+                months.append(month);
+                monthIncome.append(0);
+                monthExpenses.append(0);
+            }
+        }
+        (type == incomeCode ? monthIncome : monthExpenses)[monthSlot] += amounts[row];
+    }
+
+    for (int code = 0; code < typeCount; ++code) {
+        if (typeRows[code] > 0) {
+            result.typeTotals.insert(store.types().value(code), Money::fromCents(typeTotals[code]));
+        }
+    }
+    for (qsizetype slot = 0; slot < months.size(); ++slot) {
+        const QString month = QDate(months[slot] / 100, months[slot] % 100, 1).toString("yyyy-MM");
+        if (monthIncome[slot] != 0) {
+            result.monthlyIncome.insert(month, Money::fromCents(monthIncome[slot]));
+        }
+        if (monthExpenses[slot] != 0) {
+            result.monthlyExpenses.insert(month, Money::fromCents(monthExpenses[slot]));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Adds partial totals into running totals.
+ *
+ * Amounts are exact cents, so merging chunk totals gives the same result as
+ * aggregating all rows at once.
+ *
+ * @param into The running totals.
+ * @param part The totals to add.
+ */
+void FinancialReportGenerator::mergeTotals(ReportTotals& into, const ReportTotals& part) {
+    into.totalIncome += part.totalIncome;
+    into.totalExpenses += part.totalExpenses;
+    auto mergeMap = [](QMap<QString, Money>& target, const QMap<QString, Money>& source) {
+        for (auto it = source.constBegin(); it != source.constEnd(); ++it) {
+            target[it.key()] += it.value();
+        }
+    };
+    mergeMap(into.expenseCategories, part.expenseCategories);
+    mergeMap(into.typeTotals, part.typeTotals);
+    mergeMap(into.expensePaymentMethods, part.expensePaymentMethods);
+    mergeMap(into.monthlyIncome, part.monthlyIncome);
+    mergeMap(into.monthlyExpenses, part.monthlyExpenses);
+}
+
+/**
+ * @brief Gets the number of loaded transactions.
+ * @return The transaction count.
+ */
+qsizetype FinancialReportGenerator::transactionCount() const {
+    return transactions.size();
+}
+
+/**
+ * @brief Rebuilds a Transaction from the columnar store.
+ *
+ * Decodes the dictionary codes and the packed date of one row back into strings.
+ * Meant for displaying or exporting individual rows, not for aggregation.
+ *
+ * @param index The row index, from 0 to transactionCount() - 1.
+ * @return The transaction at that row.
+ */
+FinancialReportGenerator::Transaction FinancialReportGenerator::transactionAt(qsizetype index) const {
+    Transaction txn;
+    qint32 day = transactions.dateColumn()[index];
+    if (day != TransactionStore::InvalidDate) {
+        txn.date = QDate::fromJulianDay(day).toString("yyyy-MM-dd");
+    }
+    else {
+        txn.date = QString::fromUtf8(transactions.unparsedDate(index)); // Shown as it was in the file
+    }
+    txn.transactionID = QString::fromUtf8(transactions.transactionID(index));
+    txn.type = transactions.types().value(transactions.typeColumn()[index]);
+    txn.description = QString::fromUtf8(transactions.description(index));
+    txn.amount = Money::fromCents(transactions.amountColumn()[index]);
+    txn.paymentMethod = transactions.paymentMethods().value(transactions.paymentMethodColumn()[index]);
+    txn.category = transactions.categories().value(transactions.categoryColumn()[index]);
+    return txn;
+}
@@ -4,6 +4,13 @@
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <atomic>
+#include <functional>
+#include "transactionstore.h"
+#include "money.h"
+
+class CsvReader;
+class QThreadPool;
 
 /**
  * @class FinancialReportGenerator
@@ -44,18 +51,47 @@ public:
      * @brief Represents a financial transaction.
      *
      * This struct holds details of a financial transaction, including date, ID, type,
-     * description, amount, payment method, and category.
+     * description, amount, payment method, and category. Transactions are stored
+     * column by column in a TransactionStore; this struct is the decoded form of one
+     * row, as returned by transactionAt().
      */
     struct Transaction {
         QString date; // The date of the transaction.
         QString transactionID; // The unique ID of the transaction.
         QString type; // The type of the transaction (e.g., "Income" or "Expense").
         QString description; // A description of the transaction.
-        double amount; // The amount of the transaction.
+        Money amount; // The amount of the transaction, in exact cents.
         QString paymentMethod; // The payment method used for the transaction.
         QString category; // The category of the transaction (e.g., "Food", "Transport").
     };
 
+    /**
+     * @struct ReportTotals
+     * @brief Aggregates shared by all reports.
+     *
+     * Materialized while the transactions are loaded: every parsed chunk gets its
+     * own totals, which are merged into the running totals of the dataset, and
+     * appended records only add their own totals. Reports read them without scanning.
+     * Income doubles as total assets and expenses as total liabilities on the balance sheet.
+     */
+    struct ReportTotals {
+        Money totalIncome; // Sum of all "Income" transactions.
+        Money totalExpenses; // Sum of all "Expense" transactions.
+        QMap<QString, Money> expenseCategories; // Expense totals keyed by category.
+        QMap<QString, Money> typeTotals; // Totals keyed by transaction type, including types other than income and expense.
+        QMap<QString, Money> expensePaymentMethods; // Expense totals keyed by payment method.
+        QMap<QString, Money> monthlyIncome; // Income totals keyed by month ("yyyy-MM").
+        QMap<QString, Money> monthlyExpenses; // Expense totals keyed by month ("yyyy-MM").
+    };
+
+    /**
+     * @brief Reports how far a load has come and asks whether to go on.
+     *
+     * Called with the bytes parsed so far and the file size. Returning false
+     * cancels the load.
+     */
+    using LoadProgress = std::function<bool(qint64 bytesParsed, qint64 bytesTotal)>;
+
     /**
      * @brief Loads transactions from a CSV file.
      *
@@ -63,11 +99,43 @@ public:
      * including the executable directory, current working directory, and user-specified paths.
      * If the file is found, it reads and parses the transactions, storing them in the `transactions` list.
      *
+     * A file that was loaded before and has not changed is taken from the shared
+     * DatasetCache without parsing; a file that was only appended to has just its
+     * new records parsed.
+     *
+     * Large files are split into record-aligned chunks that are parsed on all cores at
+     * once. Every chunk fills its own store and partial totals, which are merged in
+     * file order afterwards, so the rows come out in the same order as a sequential load.
+     *
      * @param filename The name of the CSV file to load.
      * @return True if the file was successfully loaded and contains valid transactions, false otherwise.
      */
     bool loadCSV(const QString& filename);
 
+    /**
+     * @brief Finds a CSV file in the usual locations, asking the user as a last resort.
+     *
+     * May open a QFileDialog, so it must be called on the GUI thread.
+     *
+     * @param filename The name of the CSV file to find.
+     * @return The path of the file, or an empty string if it was not found.
+     */
+    static QString resolveCSVPath(const QString& filename);
+
+    /**
+     * @brief Loads transactions from a CSV file whose path is already known.
+     *
+     * Never shows any UI, so it can run on a worker thread; every generator
+     * instance only touches its own data. While parsing, progress is called
+     * every few milliseconds on the calling thread.
+     *
+     * @param filePath The path of the CSV file.
+     * @param progress Optional progress callback that can cancel the load.
+     * @return True if the file was loaded and contains valid transactions, false
+     *         otherwise or if the load was cancelled (nothing stays loaded then).
+     */
+    bool loadResolvedCSV(const QString& filePath, const LoadProgress& progress = LoadProgress());
+
     /**
      * @brief Generates a Profit & Loss Statement and saves it to a file.
      *
@@ -98,8 +166,117 @@ public:
      */
     void generateBalanceSheetReport(const QString& outputFilename);
 
+    /**
+     * @brief Generates a Transaction Summary Report and saves it to a file.
+     *
+     * Lists the totals by transaction type, income and expenses per month and
+     * expenses per payment method. It is a separate file, so the layouts of the
+     * other three reports stay as they are.
+     *
+     * @param outputFilename The path to the file where the Transaction Summary Report will be saved.
+     */
+    void generateTransactionSummaryReport(const QString& outputFilename);
+
+    /**
+     * @brief Generates all three reports from one scan of the loaded transactions.
+     *
+     * Computes the totals once and writes the Profit & Loss Statement, the Expense
+     * Breakdown Report and the Balance Sheet Report.
+     *
+     * @param profitLossFilename The file where the Profit & Loss Statement will be saved.
+     * @param expenseBreakdownFilename The file where the Expense Breakdown Report will be saved.
+     * @param balanceSheetFilename The file where the Balance Sheet Report will be saved.
+     */
+    void generateAllReports(const QString& profitLossFilename, const QString& expenseBreakdownFilename,
+        const QString& balanceSheetFilename);
+
+    /**
+     * @brief Exports the loaded transactions to a compressed columnar file.
+     *
+     * See ColumnarExport for the file format. Analytics tools can read single
+     * columns and row groups of it instead of parsing the CSV reports.
+     *
+     * @param outputFilename The path to the file where the transactions will be saved.
+     * @return True if the file was written, false otherwise.
+     */
+    bool exportColumnar(const QString& outputFilename) const;
+
+    /**
+     * @brief Computes the totals of all reports in a single pass.
+     *
+     * The result is cached until the next call to loadCSV().
+     *
+     * @return The totals of the loaded transactions.
+     */
+    const ReportTotals& computeTotals();
+
+    /**
+     * @brief Gets the number of loaded transactions.
+     * @return The transaction count.
+     */
+    qsizetype transactionCount() const;
+
+    /**
+     * @brief Decodes one loaded transaction back into a Transaction.
+     * @param index The row index, from 0 to transactionCount() - 1.
+     * @return The transaction at that row.
+     */
+    Transaction transactionAt(qsizetype index) const;
+
 private:
-    QList<Transaction> transactions; // List of transactions loaded from the CSV file.
+    /**
+     * @brief Parses every record of a reader into a store.
+     * @param reader The reader positioned at the first record.
+     * @param store The store receiving the valid transactions.
+     * @param chunkIndex Index of the chunk being read, for the log messages.
+     * @param canceled Set by the loading thread to stop parsing early.
+     * @param bytesParsed Running byte count shared by all chunks, for progress reports.
+     */
+    static void parseTransactions(CsvReader& reader, TransactionStore& store, int chunkIndex,
+        const std::atomic<bool>& canceled, std::atomic<qint64>& bytesParsed);
+
+    /**
+     * @brief Gets the pool every parse runs its chunks on.
+     *
+     * One pool with one thread per core, shared by all loads, so several report
+     * jobs parsing at once split the cores instead of each starting a full set of threads.
+     *
+     * @return The pool.
+     */
+    static QThreadPool& parsePool();
+
+    /**
+     * @brief Parses CSV records into a store and computes their totals, on all cores for large inputs.
+     * @param bytes The records to parse, starting at a record boundary.
+     * @param store Receives the valid transactions.
+     * @param storeTotals Receives the totals of the transactions.
+     * @param progress Optional progress callback that can cancel the parse.
+     * @return True if the records were parsed, false if the parse was cancelled.
+     */
+    static bool parseRecords(QByteArrayView bytes, TransactionStore& store, ReportTotals& storeTotals,
+        const LoadProgress& progress);
+
+    /**
+     * @brief Computes the report totals of a store with the aggregation kernels.
+     * @param store The transactions to aggregate.
+     * @return The totals of the store.
+     */
+    static ReportTotals totalsOf(const TransactionStore& store);
+
+    /**
+     * @brief Adds partial totals into running totals.
+     * @param into The running totals.
+     * @param part The totals to add.
+     */
+    static void mergeTotals(ReportTotals& into, const ReportTotals& part);
+
+    static constexpr qint64 MinimumChunkBytes = 4 * 1024 * 1024; // Files smaller than this are parsed on one thread.
+    static constexpr int ProgressIntervalMs = 50; // How often a load with a progress callback reports.
+    static constexpr int RowsPerProgressCheck = 4096; // Rows parsed between two looks at the cancel flag.
+
+    TransactionStore transactions; // Columnar store of the transactions loaded from the CSV file.
+    ReportTotals totals; // Cached totals of the loaded transactions.
+    bool totalsValid = false; // Whether totals matches the loaded transactions.
 };
 
 #endif // FINANCIALREPORT_H
\ No newline at end of file
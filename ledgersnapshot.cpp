@@ -0,0 +1,423 @@
+#include "ledgersnapshot.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+/**
+ * @class ledgersnapshot.cpp
+ * @brief Implements writing and memory-mapped loading of binary ledger snapshots.
+ */
+
+namespace {
+
+    const char SnapshotMagic[8] = { 'N', 'P', 'L', 'E', 'D', 'G', 'E', 'R' };
+
+    /**
+     * @brief Reference to a string in the heap section.
+     */
+    struct StringRef {
+        quint32 offset; // Byte offset from the start of the heap.
+        quint32 length; // Length in bytes.
+    };
+
+    /**
+     * @brief Fixed-width record of one transaction.
+     */
+    struct SnapshotRecord {
+        qint32 id;
+        qint32 day;             // Day number, CashflowTracking::InvalidDay if the date does not parse.
+        qint64 costCents;
+        StringRef dateTime;
+        StringRef seller;
+        StringRef buyer;
+        StringRef merchandise;
+        qint32 categoryCode;    // Bucket of the category in the category index, which holds its name.
+        quint32 reserved;
+    };
+    static_assert(sizeof(SnapshotRecord) == 56, "snapshot records must stay 56 bytes");
+
+    /**
+     * @brief Record of one transaction in version 1 files, read to migrate them.
+     */
+    struct SnapshotRecordV1 {
+        qint32 id;
+        quint32 reserved;
+        qint64 costCents;
+        StringRef dateTime;
+        StringRef seller;
+        StringRef buyer;
+        StringRef merchandise;
+        StringRef category;
+    };
+    static_assert(sizeof(SnapshotRecordV1) == 56, "version 1 records are 56 bytes");
+
+    /**
+     * @brief One category and where its record positions are.
+     */
+    struct CategoryBucket {
+        StringRef name;
+        quint32 firstPosition;  // Index of its first position in the section's position array.
+        quint32 positionCount;
+    };
+    static_assert(sizeof(CategoryBucket) == 16, "category buckets must stay 16 bytes");
+
+    /**
+     * @brief One day and where its record positions are.
+     */
+    struct DayBucket {
+        qint32 day;
+        quint32 reserved;
+        quint32 firstPosition;  // Index of its first position in the section's position array.
+        quint32 positionCount;
+    };
+    static_assert(sizeof(DayBucket) == 16, "day buckets must stay 16 bytes");
+
+    /**
+     * @brief File header, at offset 0.
+     */
+    struct SnapshotHeader {
+        char magic[8];
+        quint32 version;
+        quint32 recordSize;
+        quint64 fileSize;
+        quint64 recordCount;
+        qint64 nextId;
+        quint64 recordsOffset;
+        quint64 heapOffset;
+        quint64 heapSize;
+        quint64 categoryBucketsOffset;  // Buckets, then their positions as quint32.
+        quint64 categoryBucketCount;
+        quint64 categoryPositionCount;
+        quint64 dayBucketsOffset;       // Buckets in date order, then their positions as quint32.
+        quint64 dayBucketCount;
+        quint64 dayPositionCount;
+    };
+
+    /**
+     * @brief Rounds an offset up to the next multiple of 8.
+     */
+    quint64 align8(quint64 offset) {
+        return (offset + 7) & ~quint64(7);
+    }
+
+    /**
+     * @brief Checks that a section of count items of itemSize bytes fits in the file.
+     */
+    bool sectionFits(quint64 offset, quint64 count, quint64 itemSize, quint64 fileSize) {
+        if (offset > fileSize || (itemSize != 0 && count > (fileSize - offset) / itemSize)) {
+            return false;
+        }
+        return true;
+    }
+
+}
+
+/**
+ * @brief Writes a ledger to a snapshot file.
+ * @param path The snapshot file.
+ * @param tracking The ledger to write.
+ * @return True if the snapshot was written, false otherwise.
+ */
+bool LedgerSnapshot::write(const QString& path, const CashflowTracking& tracking) {
+    // Positions in the indexes refer to this list, which has no removed slots
+    const std::vector<DataEntry>& entries = tracking.getAllDataEntries();
+    const std::vector<CashflowTracking::CategoryBucket>& categories = tracking.categoryIndex();
+    const std::map<int, std::vector<std::size_t>>& days = tracking.dayIndex();
+
+    if (entries.size() > std::numeric_limits<quint32>::max()) {
+        qDebug() << "Error: Ledger too large for snapshot" << path; // Positions are 32-bit
+        return false;
+    }
+
+    // Every distinct string goes into the heap once; dates and names repeat a lot
+    QByteArray heap;
+    std::unordered_map<std::string_view, StringRef> heapStrings;
+    bool heapOverflow = false;
+    auto addString = [&](const std::string& text) {
+        auto found = heapStrings.find(text);
+        if (found != heapStrings.end()) {
+            return found->second;
+        }
+        if (static_cast<quint64>(heap.size()) + text.size() > std::numeric_limits<quint32>::max()) {
+            heapOverflow = true; // Offsets are 32-bit
+            return StringRef{ 0, 0 };
+        }
+        StringRef ref{ static_cast<quint32>(heap.size()), static_cast<quint32>(text.size()) };
+        heap.append(text.data(), static_cast<qsizetype>(text.size()));
+        heapStrings.emplace(std::string_view(text), ref);
+        return ref;
+    };
+
+    QVector<SnapshotRecord> records;
+    records.reserve(static_cast<qsizetype>(entries.size()));
+    for (const DataEntry& entry : entries) {
+        SnapshotRecord record;
+        record.id = entry.transid;
+        record.day = entry.day;
+        record.costCents = entry.cost.cents();
+        record.dateTime = addString(entry.dateTime);
+        record.seller = addString(entry.seller);
+        record.buyer = addString(entry.buyer);
+        record.merchandise = addString(entry.merchandise);
+        record.categoryCode = entry.categoryCode;
+        record.reserved = 0;
+        records.append(record);
+    }
+
+    // The indexes are stored as bucket tables, so loading can take them over as they are
+    QVector<CategoryBucket> categoryBuckets;
+    QVector<quint32> categoryPositions;
+    categoryBuckets.reserve(static_cast<qsizetype>(categories.size()));
+    categoryPositions.reserve(static_cast<qsizetype>(entries.size()));
+    for (const CashflowTracking::CategoryBucket& category : categories) {
+        categoryBuckets.append(CategoryBucket{ addString(category.name), static_cast<quint32>(categoryPositions.size()),
+            static_cast<quint32>(category.positions.size()) });
+        for (std::size_t position : category.positions) {
+            categoryPositions.append(static_cast<quint32>(position));
+        }
+    }
+    QVector<DayBucket> dayBuckets;
+    QVector<quint32> dayPositions;
+    dayBuckets.reserve(static_cast<qsizetype>(days.size()));
+    dayPositions.reserve(static_cast<qsizetype>(entries.size()));
+    for (const auto& day : days) {
+        dayBuckets.append(DayBucket{ day.first, 0, static_cast<quint32>(dayPositions.size()),
+            static_cast<quint32>(day.second.size()) });
+        for (std::size_t position : day.second) {
+            dayPositions.append(static_cast<quint32>(position));
+        }
+    }
+
+    if (heapOverflow) {
+        qDebug() << "Error: Ledger too large for snapshot" << path;
+        return false;
+    }
+
+    // Lay the sections out one after another, each 8-byte aligned
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+    header.version = Version;
+    header.recordSize = sizeof(SnapshotRecord);
+    header.recordCount = static_cast<quint64>(records.size());
+    header.nextId = tracking.nextTransactionId();
+    header.recordsOffset = align8(sizeof(SnapshotHeader));
+    header.heapOffset = header.recordsOffset + header.recordCount * sizeof(SnapshotRecord);
+    header.heapSize = static_cast<quint64>(heap.size());
+    header.categoryBucketsOffset = align8(header.heapOffset + header.heapSize);
+    header.categoryBucketCount = static_cast<quint64>(categoryBuckets.size());
+    header.categoryPositionCount = static_cast<quint64>(categoryPositions.size());
+    header.dayBucketsOffset = align8(header.categoryBucketsOffset + header.categoryBucketCount * sizeof(CategoryBucket)
+        + header.categoryPositionCount * sizeof(quint32));
+    header.dayBucketCount = static_cast<quint64>(dayBuckets.size());
+    header.dayPositionCount = static_cast<quint64>(dayPositions.size());
+    header.fileSize = header.dayBucketsOffset + header.dayBucketCount * sizeof(DayBucket)
+        + header.dayPositionCount * sizeof(quint32);
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Error: Unable to write snapshot" << path << ":" << file.errorString();
+        return false;
+    }
+
+    // Writes raw bytes, then zero padding up to the next section
+    auto writeBytes = [&file](const void* data, quint64 size) {
+        return file.write(static_cast<const char*>(data), static_cast<qint64>(size)) == static_cast<qint64>(size);
+    };
+    auto padTo = [&file](quint64 offset) {
+        quint64 padding = offset - static_cast<quint64>(file.pos());
+        return padding == 0 || file.write(QByteArray(static_cast<qsizetype>(padding), '\0')) == static_cast<qint64>(padding);
+    };
+
+    bool written = writeBytes(&header, sizeof(header))
+        && padTo(header.recordsOffset)
+        && writeBytes(records.constData(), header.recordCount * sizeof(SnapshotRecord))
+        && writeBytes(heap.constData(), header.heapSize)
+        && padTo(header.categoryBucketsOffset)
+        && writeBytes(categoryBuckets.constData(), header.categoryBucketCount * sizeof(CategoryBucket))
+        && writeBytes(categoryPositions.constData(), header.categoryPositionCount * sizeof(quint32))
+        && padTo(header.dayBucketsOffset)
+        && writeBytes(dayBuckets.constData(), header.dayBucketCount * sizeof(DayBucket))
+        && writeBytes(dayPositions.constData(), header.dayPositionCount * sizeof(quint32));
+
+    if (!written || !file.commit()) {
+        qDebug() << "Error: Unable to write snapshot" << path << ":" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Loads a snapshot file into a ledger, replacing its contents.
+ *
+ * Version 1 files, whose index sections were never usable, are still read:
+ * their entries are added one by one, which builds the indexes, and the next
+ * compaction writes them back as the current version.
+ *
+ * @param path The snapshot file.
+ * @param tracking The ledger to fill.
+ * @return Whether the snapshot was loaded, missing or damaged.
+ */
+LedgerSnapshot::ReadResult LedgerSnapshot::read(const QString& path, CashflowTracking& tracking) {
+    QElapsedTimer timer; // Times the load so the debug log shows the load speed
+    timer.start();
+
+    QFile file(path);
+    if (!file.exists()) {
+        return ReadResult::Missing; // No snapshot yet
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Error: Unable to open snapshot" << path << ":" << file.errorString();
+        return ReadResult::Damaged;
+    }
+
+    const quint64 fileSize = static_cast<quint64>(file.size());
+    if (fileSize < sizeof(SnapshotHeader)) {
+        qDebug() << "Error: Snapshot" << path << "is truncated";
+        return ReadResult::Damaged;
+    }
+
+    // Map the whole file; records, heap and indexes are read straight from the mapping
+    QByteArray fallbackBuffer;
+    uchar* mapping = file.map(0, static_cast<qint64>(fileSize));
+    const char* base = reinterpret_cast<const char*>(mapping);
+    if (!mapping) {
+        fallbackBuffer = file.readAll(); // Some devices cannot be mapped
+        base = fallbackBuffer.constData();
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    // Reject anything that is not a complete snapshot of a known version
+    const bool current = header.version == Version;
+    bool valid = std::memcmp(header.magic, SnapshotMagic, sizeof(header.magic)) == 0
+        && (current || header.version == 1)
+        && header.recordSize == sizeof(SnapshotRecord)
+        && header.fileSize == fileSize
+        && header.recordsOffset % 8 == 0
+        && sectionFits(header.recordsOffset, header.recordCount, sizeof(SnapshotRecord), fileSize)
+        && sectionFits(header.heapOffset, header.heapSize, 1, fileSize);
+    if (valid && current) {
+        valid = header.categoryBucketsOffset % 8 == 0 && header.dayBucketsOffset % 8 == 0
+            && header.recordCount <= std::numeric_limits<quint32>::max()
+            && sectionFits(header.categoryBucketsOffset, header.categoryBucketCount, sizeof(CategoryBucket), fileSize)
+            && sectionFits(header.categoryBucketsOffset + header.categoryBucketCount * sizeof(CategoryBucket),
+                header.categoryPositionCount, sizeof(quint32), fileSize)
+            && sectionFits(header.dayBucketsOffset, header.dayBucketCount, sizeof(DayBucket), fileSize)
+            && sectionFits(header.dayBucketsOffset + header.dayBucketCount * sizeof(DayBucket),
+                header.dayPositionCount, sizeof(quint32), fileSize);
+    }
+    if (!valid) {
+        qDebug() << "Error: Snapshot" << path << "has an unknown version or is damaged";
+        if (mapping) {
+            file.unmap(mapping);
+        }
+        return ReadResult::Damaged;
+    }
+
+    const char* heap = base + header.heapOffset;
+    auto text = [&](const StringRef& ref, bool& ok) {
+        if (static_cast<quint64>(ref.offset) + ref.length > header.heapSize) {
+            ok = false;
+            return std::string();
+        }
+        return std::string(heap + ref.offset, ref.length);
+    };
+
+    bool ok = true;
+    if (!current) {
+        // No usable indexes in the file, so the ledger builds them entry by entry
+        const SnapshotRecordV1* records = reinterpret_cast<const SnapshotRecordV1*>(base + header.recordsOffset);
+        CashflowTracking loaded;
+        for (quint64 i = 0; i < header.recordCount && ok; ++i) {
+            const SnapshotRecordV1& record = records[i];
+            loaded.restoreData(DataEntry{ record.id, text(record.dateTime, ok), text(record.seller, ok), text(record.buyer, ok),
+                text(record.merchandise, ok), Money::fromCents(record.costCents), text(record.category, ok) });
+        }
+        if (mapping) {
+            file.unmap(mapping);
+        }
+        if (!ok) {
+            qDebug() << "Error: Snapshot" << path << "has string references out of range";
+            return ReadResult::Damaged;
+        }
+        tracking.assignData(std::vector<DataEntry>(loaded.getAllDataEntries()),
+            std::map<int, std::vector<std::size_t>>(loaded.dayIndex()),
+            std::vector<CashflowTracking::CategoryBucket>(loaded.categoryIndex()), static_cast<int>(header.nextId));
+        qDebug() << "Migrated" << header.recordCount << "transactions from a version 1 snapshot in" << timer.elapsed() << "ms";
+        return ReadResult::Loaded;
+    }
+
+    // The category names come from the index, each one is copied once instead of once per record
+    std::vector<CashflowTracking::CategoryBucket> categories(static_cast<std::size_t>(header.categoryBucketCount));
+    const CategoryBucket* categoryBuckets = reinterpret_cast<const CategoryBucket*>(base + header.categoryBucketsOffset);
+    const quint32* categoryPositions = reinterpret_cast<const quint32*>(categoryBuckets + header.categoryBucketCount);
+    for (quint64 i = 0; i < header.categoryBucketCount && ok; ++i) {
+        const CategoryBucket& bucket = categoryBuckets[i];
+        if (static_cast<quint64>(bucket.firstPosition) + bucket.positionCount > header.categoryPositionCount) {
+            ok = false;
+            break;
+        }
+        categories[i].name = text(bucket.name, ok);
+        categories[i].positions.assign(categoryPositions + bucket.firstPosition,
+            categoryPositions + bucket.firstPosition + bucket.positionCount);
+        ok = ok && std::is_sorted(categories[i].positions.begin(), categories[i].positions.end()); // updateData() searches them
+    }
+
+    // Days are stored in date order, so each one goes in at the end of the map
+    std::map<int, std::vector<std::size_t>> days;
+    const DayBucket* dayBuckets = reinterpret_cast<const DayBucket*>(base + header.dayBucketsOffset);
+    const quint32* dayPositions = reinterpret_cast<const quint32*>(dayBuckets + header.dayBucketCount);
+    for (quint64 i = 0; i < header.dayBucketCount && ok; ++i) {
+        const DayBucket& bucket = dayBuckets[i];
+        if (static_cast<quint64>(bucket.firstPosition) + bucket.positionCount > header.dayPositionCount
+            || (!days.empty() && bucket.day <= days.rbegin()->first)) {
+            ok = false;
+            break;
+        }
+        auto day = days.emplace_hint(days.end(), bucket.day,
+            std::vector<std::size_t>(dayPositions + bucket.firstPosition, dayPositions + bucket.firstPosition + bucket.positionCount));
+        ok = std::is_sorted(day->second.begin(), day->second.end()); // updateData() searches them
+    }
+
+    // Every position must name a record, or the ledger would index past its entries
+    for (quint64 i = 0; i < header.categoryPositionCount && ok; ++i) {
+        ok = categoryPositions[i] < header.recordCount;
+    }
+    for (quint64 i = 0; i < header.dayPositionCount && ok; ++i) {
+        ok = dayPositions[i] < header.recordCount;
+    }
+
+    // Records are fixed width, so each one is read in place without any tokenizing
+    const SnapshotRecord* records = reinterpret_cast<const SnapshotRecord*>(base + header.recordsOffset);
+    std::vector<DataEntry> entries;
+    entries.reserve(static_cast<std::size_t>(header.recordCount));
+    for (quint64 i = 0; i < header.recordCount && ok; ++i) {
+        const SnapshotRecord& record = records[i];
+        if (record.categoryCode < 0 || static_cast<quint64>(record.categoryCode) >= header.categoryBucketCount) {
+            ok = false;
+            break;
+        }
+        entries.push_back(DataEntry{ record.id, text(record.dateTime, ok), text(record.seller, ok), text(record.buyer, ok),
+            text(record.merchandise, ok), Money::fromCents(record.costCents),
+            categories[static_cast<std::size_t>(record.categoryCode)].name, record.day, record.categoryCode });
+    }
+
+    if (mapping) {
+        file.unmap(mapping);
+    }
+    if (!ok) {
+        qDebug() << "Error: Snapshot" << path << "has string or index references out of range";
+        return ReadResult::Damaged;
+    }
+
+    tracking.assignData(std::move(entries), std::move(days), std::move(categories), static_cast<int>(header.nextId));
+    qDebug() << "Loaded" << header.recordCount << "transactions from snapshot in" << timer.elapsed() << "ms";
+    return ReadResult::Loaded;
+}
@@ -0,0 +1,66 @@
+#ifndef LEDGERSNAPSHOT_H
+#define LEDGERSNAPSHOT_H
+
+#include <QString>
+#include "cashflowtracking.h"
+
+/**
+ * @class LedgerSnapshot
+ * @brief Versioned binary snapshot of a cashflow ledger, loaded by memory-mapping it.
+ *
+ * File layout (native byte order, every section 8-byte aligned):
+ * - Header: magic, version, section offsets and counts.
+ * - Records: one fixed 56-byte record per transaction with its ID, its cost in
+ *   cents, its day number, its category code and (offset, length) references
+ *   into the string heap for the text fields.
+ * - String heap: every distinct string once, back to back.
+ * - Category index: a fixed-width bucket per category code (name reference,
+ *   first position, position count) followed by one array of record positions.
+ * - Date index: a fixed-width bucket per day, in date order, followed by one
+ *   array of record positions.
+ *
+ * Loading maps the file and reads the records in place: there is no tokenizing,
+ * no JSON DOM, no re-derived IDs and no date parsing, and the category and date
+ * indexes are taken over instead of rebuilt. The text fields are still copied
+ * into the ledger's entries. A file with a wrong magic, version or section
+ * bounds, or with an index that points outside the records, is rejected as a whole.
+ */
+class LedgerSnapshot {
+public:
+    static constexpr quint32 Version = 2; ///< Format version written by write(); 1 had no usable indexes.
+
+    /**
+     * @brief Outcome of read().
+     */
+    enum class ReadResult {
+        Loaded,     ///< The snapshot was valid and is in the ledger now.
+        Missing,    ///< There is no snapshot file; the ledger is untouched.
+        Damaged     ///< The file exists but cannot be read or is not a valid snapshot; the ledger is untouched.
+    };
+
+    /**
+     * @brief Writes a ledger to a snapshot file.
+     *
+     * The file is written through QSaveFile, so an existing snapshot is only
+     * replaced once the new one is complete.
+     *
+     * @param path The snapshot file.
+     * @param tracking The ledger to write.
+     * @return True if the snapshot was written, false otherwise.
+     */
+    static bool write(const QString& path, const CashflowTracking& tracking);
+
+    /**
+     * @brief Loads a snapshot file into a ledger, replacing its contents.
+     *
+     * A missing file and a damaged one are told apart, since only a missing
+     * snapshot may be replaced by older files.
+     *
+     * @param path The snapshot file.
+     * @param tracking The ledger to fill.
+     * @return Whether the snapshot was loaded, missing or damaged.
+     */
+    static ReadResult read(const QString& path, CashflowTracking& tracking);
+};
+
+#endif // LEDGERSNAPSHOT_H
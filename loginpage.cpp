@@ -163,7 +163,7 @@ void LoginPage::handleLogin() {
     // First, check if the account is locked
     if (authSystem->isAccountLocked(id)) {
         std::cout << "[DEBUG] showLockDialog triggered!\n";
-        showLockDialog();
+        showLockDialog(id);
         return;
     }
 
@@ -174,11 +174,13 @@ void LoginPage::handleLogin() {
         return;
     }
 
-    bool success = authSystem->authenticateUser(id);
+    // A successful login starts a new session; its token is what the main window keeps
+    QString sessionToken = authSystem->loginUser(id);
 
-    if (success) {
+    if (!sessionToken.isEmpty()) {
         MainWindow* realMainWindow = qobject_cast<MainWindow*>(mainWindow);
         if (realMainWindow) {
+            realMainWindow->setSessionToken(sessionToken);
             realMainWindow->setCurrentUserId(id);
             realMainWindow->show();
             this->close();
@@ -189,6 +191,9 @@ void LoginPage::handleLogin() {
             statusLabel->setAlignment(Qt::AlignCenter);
         }
     }
+    else if (authSystem->isAccountLocked(id)) {
+        showLockDialog(id); // This attempt used up the last try
+    }
     else {
         statusLabel->setText("❌ Incorrect login. Try again.");
         statusLabel->setStyleSheet("color: red; font-size: 13px;");
@@ -236,39 +241,54 @@ void LoginPage::handleLogin() {
      }
 
      // If they don't exist, add them and show success
-     authSystem->addUser(id, "User");
+     if (!authSystem->addUser(id, "User")) {
+         statusLabel->setText("❌ Your account could not be saved. Please try again.");
+         statusLabel->setStyleSheet("color: red; font-size: 13px;");
+         statusLabel->setAlignment(Qt::AlignCenter);
+         return;
+     }
      statusLabel->setText("✅ Account created successfully! Please log in.");
      statusLabel->setStyleSheet("color: green; font-size: 13px;");
      statusLabel->setAlignment(Qt::AlignCenter);
  }
 
- void LoginPage::showLockDialog() {
+ /**
+  * @brief Shows a countdown until an account's lock ends.
+  *
+  * The dialog only observes the lock: every second it asks the authentication
+  * system how long the lock has left and closes once it is over.
+  *
+  * @param userID The locked ID.
+  */
+ void LoginPage::showLockDialog(const QString& userID) {
+     if (authSystem->lockRemainingMs(userID) <= 0) {
+         return; // Already over
+     }
+
      QDialog* lockDialog = new QDialog(this);
+     lockDialog->setAttribute(Qt::WA_DeleteOnClose);
      lockDialog->setWindowTitle("🔒 Account Locked");
      lockDialog->setModal(true);
      lockDialog->setWindowFlags(lockDialog->windowFlags() & ~Qt::WindowCloseButtonHint); // Disable close
 
      QVBoxLayout* dialogLayout = new QVBoxLayout(lockDialog);
-     QLabel* countdownLabel = new QLabel("🔒 Your account is temporarily locked.\n\nPlease wait 60 seconds before trying again.");
+     QLabel* countdownLabel = new QLabel(lockDialog);
      countdownLabel->setAlignment(Qt::AlignCenter);
      dialogLayout->addWidget(countdownLabel);
 
-     QTimer* countdownTimer = new QTimer(lockDialog);
-     int* remainingTime = new int(60); // heap allocated for lambda
-
-     QObject::connect(countdownTimer, &QTimer::timeout, lockDialog, [=]() mutable {
-         (*remainingTime)--;
-         countdownLabel->setText(QString("🚫 ACCOUNT LOCKED\n\nTime remaining: %1 seconds").arg(*remainingTime));
-
-         if (*remainingTime <= 0) {
-             countdownTimer->stop();
-             delete remainingTime;
+     auto updateCountdown = [this, userID, countdownLabel, lockDialog]() {
+         qint64 remainingMs = authSystem->lockRemainingMs(userID);
+         if (remainingMs <= 0) {
              lockDialog->accept(); // close dialog
+             return;
          }
-         });
+         countdownLabel->setText(QString("🚫 ACCOUNT LOCKED\n\nTime remaining: %1 seconds").arg((remainingMs + 999) / 1000));
+         };
+
+     QTimer* countdownTimer = new QTimer(lockDialog);
+     QObject::connect(countdownTimer, &QTimer::timeout, lockDialog, updateCountdown);
+     updateCountdown();
 
      countdownTimer->start(1000); // update every second
      lockDialog->exec();          // block interaction
-
-   
  }
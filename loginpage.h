@@ -70,7 +70,11 @@ private:
      */
     QMainWindow* mainWindow;
 
-    void showLockDialog();
+    /**
+     * @brief Shows a countdown until an account's lock ends.
+     * @param userID The locked ID.
+     */
+    void showLockDialog(const QString& userID);
 
 public:
     /**
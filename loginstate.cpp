@@ -0,0 +1,439 @@
+#include "loginstate.h"
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <algorithm>
+
+/**
+ * @class loginstate.cpp
+ * @brief Implements the sharded, memory-capped failed-attempt and lockout bookkeeping.
+ */
+
+static_assert((LoginState::ShardCount & (LoginState::ShardCount - 1)) == 0, "ShardCount must be a power of two");
+static_assert((LoginState::SketchWidth & (LoginState::SketchWidth - 1)) == 0, "SketchWidth must be a power of two");
+
+namespace {
+
+    const size_t SketchSeed = 0x5bd1e995; // Keeps sketch positions independent of the shard choice, which uses qHash unseeded.
+
+}
+
+/**
+ * @brief Creates an empty state.
+ * @param maxTrackedIds How many IDs' failures are remembered at most, spread evenly over the shards.
+ * @param maxLockedIds How many IDs are locked at most, spread evenly over the shards.
+ */
+LoginState::LoginState(qsizetype maxTrackedIds, qsizetype maxLockedIds)
+    : shardCapacity(qMax<qsizetype>(1, maxTrackedIds / ShardCount)),
+      shardLockCapacity(qMax<qsizetype>(1, maxLockedIds / ShardCount)) {
+    for (Shard& shard : shards) {
+        shard.currentFailures.assign(SketchDepth * SketchWidth, 0);
+        shard.previousFailures.assign(SketchDepth * SketchWidth, 0);
+    }
+}
+
+/**
+ * @brief Records a login attempt.
+ *
+ * Everything happens under the mutex of the ID's shard, with one lookup in its
+ * locks and one in its failures.
+ *
+ * @param userID The ID that tried to log in.
+ * @param credentialsValid Whether the credentials were accepted.
+ * @return What the attempt did.
+ */
+LoginState::Attempt LoginState::recordAttempt(const QString& userID, bool credentialsValid) {
+    const qint64 currentTime = now();
+    Shard& shard = shardFor(userID);
+    QMutexLocker locker(&shard.mutex);
+    expireLocks(shard, currentTime);
+
+    Attempt attempt;
+    const auto lockIt = shard.locks.constFind(userID);
+    if (lockIt != shard.locks.constEnd() && *lockIt > currentTime) {
+        attempt.wasLocked = true;
+        attempt.lockRemainingMs = *lockIt - currentTime;
+        return attempt;
+    }
+
+    auto it = shard.entries.find(userID);
+    if (credentialsValid) {
+        if (it != shard.entries.end()) {
+            eraseEntry(shard, it); // Nothing left to remember about this ID
+        }
+        attempt.succeeded = true;
+        return attempt;
+    }
+
+    if (it == shard.entries.end()) {
+        it = insertEntry(shard, userID, currentTime);
+    }
+    else {
+        shard.unlocked.splice(shard.unlocked.end(), shard.unlocked, it->lruPosition); // Most recently failed now
+    }
+
+    // Overwrite the oldest of the remembered failures
+    it->failures[it->nextFailure] = currentTime;
+    it->nextFailure = (it->nextFailure + 1) % MaxFailedAttempts;
+    it->failureCount = qMin(it->failureCount + 1, MaxFailedAttempts);
+
+    attempt.failedAttempts = failuresInWindow(*it, currentTime);
+    if (attempt.failedAttempts >= MaxFailedAttempts) {
+        if (lockId(shard, userID, currentTime + LockDurationMs)) {
+            attempt.lockedNow = true;
+            attempt.lockRemainingMs = LockDurationMs;
+        }
+        else {
+            attempt.rateLimited = true; // The locks in force stay; the failures are kept for the next attempt
+        }
+    }
+    return attempt;
+}
+
+/**
+ * @brief Gets the failures of an ID within the window.
+ * @param userID The ID.
+ * @return The failure count, 0 while the ID is locked.
+ */
+int LoginState::failedAttempts(const QString& userID) const {
+    const qint64 currentTime = now();
+    const Shard& shard = shardFor(userID);
+    QMutexLocker locker(&shard.mutex);
+    const auto lockIt = shard.locks.constFind(userID);
+    if (lockIt != shard.locks.constEnd() && *lockIt > currentTime) {
+        return 0; // Its failures were forgotten when it was locked
+    }
+    auto it = shard.entries.constFind(userID);
+    return it != shard.entries.constEnd() ? failuresInWindow(*it, currentTime) : sketchEstimate(shard, userID, currentTime);
+}
+
+/**
+ * @brief Checks whether an ID is locked.
+ * @param userID The ID.
+ * @return True if the ID is locked.
+ */
+bool LoginState::isLocked(const QString& userID) const {
+    return lockRemainingMs(userID) > 0;
+}
+
+/**
+ * @brief Gets how long an ID stays locked.
+ *
+ * An expired lock is simply a deadline in the past, so this is one lookup and
+ * one comparison; nothing has to be cleaned up first.
+ *
+ * @param userID The ID.
+ * @return Milliseconds until the lock ends, 0 if the ID is not locked.
+ */
+qint64 LoginState::lockRemainingMs(const QString& userID) const {
+    const qint64 currentTime = now();
+    const Shard& shard = shardFor(userID);
+    QMutexLocker locker(&shard.mutex);
+    const auto it = shard.locks.constFind(userID);
+    return it != shard.locks.constEnd() ? qMax<qint64>(0, *it - currentTime) : 0;
+}
+
+/**
+ * @brief Locks an ID and forgets its failures.
+ * @param userID The ID.
+ * @param durationMs How long the lock lasts.
+ * @return True if the ID is locked, false if its shard holds as many other locks as it may.
+ */
+bool LoginState::lock(const QString& userID, qint64 durationMs) {
+    const qint64 currentTime = now();
+    Shard& shard = shardFor(userID);
+    QMutexLocker locker(&shard.mutex);
+    expireLocks(shard, currentTime);
+    return lockId(shard, userID, currentTime + durationMs); // No other lock is given up for this one
+}
+
+/**
+ * @brief Unlocks an ID.
+ *
+ * A locked ID has no failures left, so unlocking simply forgets it; its deadline
+ * in the heap is skipped when it comes up.
+ *
+ * @param userID The ID.
+ */
+void LoginState::unlock(const QString& userID) {
+    Shard& shard = shardFor(userID);
+    QMutexLocker locker(&shard.mutex);
+    shard.locks.remove(userID);
+}
+
+/**
+ * @brief Gets the cap on IDs whose failures are remembered.
+ * @return The most IDs tracked at once.
+ */
+qsizetype LoginState::maxTrackedIds() const {
+    return shardCapacity * ShardCount;
+}
+
+/**
+ * @brief Gets the number of IDs whose failures are remembered right now.
+ * @return The tracked ID count.
+ */
+qsizetype LoginState::trackedCount() const {
+    qsizetype count = 0;
+    for (const Shard& shard : shards) {
+        QMutexLocker locker(&shard.mutex);
+        count += shard.entries.size();
+    }
+    return count;
+}
+
+/**
+ * @brief Gets the cap on locked IDs.
+ * @return The most IDs locked at once.
+ */
+qsizetype LoginState::maxLockedIds() const {
+    return shardLockCapacity * ShardCount;
+}
+
+/**
+ * @brief Gets the number of locks kept right now, including ended ones not dropped yet.
+ * @return The locked ID count.
+ */
+qsizetype LoginState::lockedCount() const {
+    qsizetype count = 0;
+    for (const Shard& shard : shards) {
+        QMutexLocker locker(&shard.mutex);
+        count += shard.locks.size();
+    }
+    return count;
+}
+
+/**
+ * @brief Gets the current monotonic time.
+ * @return Milliseconds on the monotonic clock.
+ */
+qint64 LoginState::now() {
+    return QDeadlineTimer::current().deadline();
+}
+
+/**
+ * @brief Counts the failures of an entry within the window.
+ * @param entry The entry.
+ * @param currentTime The current monotonic time.
+ * @return The failure count.
+ */
+int LoginState::failuresInWindow(const Entry& entry, qint64 currentTime) {
+    int count = 0;
+    for (int i = 0; i < entry.failureCount; ++i) {
+        if (entry.failures[i] > currentTime - FailureWindowMs) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Drops the locks that have ended. The caller holds the shard mutex.
+ *
+ * Pops every deadline that has passed. An ID that was locked again later, or
+ * unlocked early, no longer has that deadline and is left alone, so stale heap
+ * entries cost nothing but their pop. Each lock is pushed and popped once.
+ *
+ * @param shard The shard.
+ * @param currentTime The current monotonic time.
+ */
+void LoginState::expireLocks(Shard& shard, qint64 currentTime) {
+    while (!shard.deadlines.empty() && shard.deadlines.top().expires <= currentTime) {
+        const Deadline deadline = shard.deadlines.top();
+        shard.deadlines.pop();
+
+        auto it = shard.locks.find(deadline.userID);
+        if (it != shard.locks.end() && *it == deadline.expires) {
+            shard.locks.erase(it); // Failures were forgotten when it was locked
+        }
+    }
+}
+
+/**
+ * @brief Adds an entry, forgetting another ID first if the shard is full.
+ *
+ * The failures the sketch remembers for the ID are taken over. Their times are
+ * not known, so they count as failures made now and leave the window last.
+ * Locks live in a table of their own, so there is always an ID to forget.
+ *
+ * @param shard The shard.
+ * @param userID The new ID.
+ * @param currentTime The current monotonic time.
+ * @return The new entry.
+ */
+LoginState::Entries::iterator LoginState::insertEntry(Shard& shard, const QString& userID, qint64 currentTime) {
+    if (shard.entries.size() >= shardCapacity) {
+        evictOne(shard, currentTime);
+    }
+    Entry entry;
+    const int remembered = qMin(sketchEstimate(shard, userID, currentTime), MaxFailedAttempts - 1);
+    for (int i = 0; i < remembered; ++i) {
+        entry.failures[i] = currentTime;
+    }
+    entry.failureCount = remembered;
+    entry.nextFailure = remembered;
+    entry.lruPosition = shard.unlocked.insert(shard.unlocked.end(), userID);
+    return shard.entries.insert(userID, entry);
+}
+
+/**
+ * @brief Removes an entry.
+ * @param shard The shard.
+ * @param it The entry.
+ */
+void LoginState::eraseEntry(Shard& shard, Entries::iterator it) {
+    shard.unlocked.erase(it->lruPosition);
+    shard.entries.erase(it);
+}
+
+/**
+ * @brief Forgets the least recently failed ID, keeping its failures in the sketch.
+ *
+ * Locks are not entries, so a flood of made-up IDs can push out entries but
+ * cannot end a lock early, and through the sketch it cannot wipe the failures
+ * of a real ID either.
+ *
+ * @param shard The shard.
+ * @param currentTime The current monotonic time.
+ * @return False if no ID is tracked, so nothing was forgotten.
+ */
+bool LoginState::evictOne(Shard& shard, qint64 currentTime) {
+    if (shard.unlocked.empty()) {
+        return false;
+    }
+    auto it = shard.entries.find(shard.unlocked.front());
+    const int failures = failuresInWindow(*it, currentTime);
+    if (failures > 0) {
+        advanceSketch(shard, currentTime);
+        addToSketch(shard, it.key(), failures);
+    }
+    eraseEntry(shard, it);
+    return true;
+}
+
+/**
+ * @brief Moves the sketch on to the window period of a time, clearing what is too old.
+ *
+ * A period is FailureWindowMs long. The sketch of the previous period still
+ * holds failures that may be inside the window, anything older cannot be.
+ *
+ * @param shard The shard.
+ * @param currentTime The current monotonic time.
+ */
+void LoginState::advanceSketch(Shard& shard, qint64 currentTime) {
+    const qint64 period = currentTime / FailureWindowMs;
+    if (period == shard.sketchPeriod) {
+        return;
+    }
+    if (period == shard.sketchPeriod + 1) {
+        shard.previousFailures = shard.currentFailures;
+    }
+    else {
+        std::fill(shard.previousFailures.begin(), shard.previousFailures.end(), 0);
+    }
+    std::fill(shard.currentFailures.begin(), shard.currentFailures.end(), 0);
+    shard.sketchPeriod = period;
+}
+
+/**
+ * @brief Remembers the failure count of an ID in the sketch of the current period.
+ *
+ * Every counter of the ID is raised to the count, never lowered, so the
+ * smallest of them is at least the ID's count.
+ *
+ * @param shard The shard, its sketch advanced to the current period.
+ * @param userID The ID.
+ * @param failures The ID's failures within the window.
+ */
+void LoginState::addToSketch(Shard& shard, const QString& userID, int failures) {
+    const quint8 count = static_cast<quint8>(qMin(failures, 255));
+    for (qsizetype slot : sketchSlots(userID)) {
+        shard.currentFailures[slot] = qMax(shard.currentFailures[slot], count);
+    }
+}
+
+/**
+ * @brief Estimates the failures of an ID within the window from the sketch.
+ *
+ * Reads without advancing the sketch, so it also works on a const shard: a
+ * sketch one period behind only counts as the previous period.
+ *
+ * @param shard The shard.
+ * @param userID The ID.
+ * @param currentTime The current monotonic time.
+ * @return The estimate, never lower than the true count.
+ */
+int LoginState::sketchEstimate(const Shard& shard, const QString& userID, qint64 currentTime) {
+    const qint64 period = currentTime / FailureWindowMs;
+    if (period > shard.sketchPeriod + 1) {
+        return 0; // Everything in the sketch is older than the window
+    }
+    const bool current = period == shard.sketchPeriod;
+    int estimate = 255;
+    for (qsizetype slot : sketchSlots(userID)) {
+        const int count = current ? qMax(shard.currentFailures[slot], shard.previousFailures[slot])
+                                  : shard.currentFailures[slot];
+        estimate = qMin(estimate, count);
+    }
+    return estimate;
+}
+
+/**
+ * @brief Gets the counters of an ID, one per sketch row.
+ *
+ * Two seeded hashes combined as h1 + row * h2 give each row its own position.
+ *
+ * @param userID The ID.
+ * @return Positions of the counters in a sketch.
+ */
+std::array<qsizetype, LoginState::SketchDepth> LoginState::sketchSlots(const QString& userID) {
+    const quint32 first = static_cast<quint32>(qHash(userID, SketchSeed));
+    const quint32 second = static_cast<quint32>(qHash(userID, SketchSeed * 31 + 7)) | 1;
+    std::array<qsizetype, SketchDepth> positions;
+    for (int row = 0; row < SketchDepth; ++row) {
+        positions[row] = row * SketchWidth + ((first + static_cast<quint32>(row) * second) & (SketchWidth - 1));
+    }
+    return positions;
+}
+
+/**
+ * @brief Locks an ID until a deadline and forgets its failures. The caller holds the shard mutex.
+ *
+ * An ID that is locked already gets the new deadline; its old one is skipped
+ * when it comes up in the heap.
+ *
+ * @param shard The shard.
+ * @param userID The ID.
+ * @param lockedUntil Monotonic time in ms the lock ends.
+ * @return False if the ID is not locked yet and the shard holds as many locks as it may.
+ */
+bool LoginState::lockId(Shard& shard, const QString& userID, qint64 lockedUntil) {
+    if (shard.locks.size() >= shardLockCapacity && !shard.locks.contains(userID)) {
+        return false;
+    }
+    shard.locks.insert(userID, lockedUntil);
+    shard.deadlines.push(Deadline{ lockedUntil, userID });
+
+    auto it = shard.entries.find(userID);
+    if (it != shard.entries.end()) {
+        eraseEntry(shard, it); // A locked ID starts over with no failures
+    }
+    return true;
+}
+
+/**
+ * @brief Picks the shard an ID belongs to.
+ * @param userID The ID.
+ * @return The shard.
+ */
+LoginState::Shard& LoginState::shardFor(const QString& userID) {
+    return shards[qHash(userID) & (ShardCount - 1)];
+}
+
+/**
+ * @brief Picks the shard an ID belongs to.
+ * @param userID The ID.
+ * @return The shard.
+ */
+const LoginState::Shard& LoginState::shardFor(const QString& userID) const {
+    return shards[qHash(userID) & (ShardCount - 1)];
+}
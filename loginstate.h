@@ -0,0 +1,307 @@
+#ifndef LOGINSTATE_H
+#define LOGINSTATE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <functional>
+#include <list>
+#include <queue>
+#include <vector>
+
+/**
+ * @class LoginState
+ * @brief Thread-safe, memory-capped failed-attempt and lockout bookkeeping for user IDs.
+ *
+ * The IDs are spread over ShardCount shards by their hash, and each shard has its
+ * own mutex, so logins of different users rarely wait for each other. A login
+ * attempt is recorded with a single lookup in its shard that checks the lock,
+ * updates the failures and locks the ID once it reaches MaxFailedAttempts.
+ *
+ * Failures are counted in a sliding window: an ID is locked after
+ * MaxFailedAttempts failures within FailureWindowMs, and older failures no
+ * longer count. Only the times of the last MaxFailedAttempts failures are kept.
+ *
+ * A lock is nothing but a deadline on a monotonic clock: an ID is locked while
+ * its deadline lies in the future, so checking a lock is one lookup and one
+ * comparison, and a lock ends by itself without any timer. Locks are kept apart
+ * from the failures, in a table of their own that maps an ID to its deadline.
+ * Every shard also keeps its deadlines in a min-heap, which lets it drop expired
+ * locks cheaply whenever it is written to, even with millions of locked IDs.
+ *
+ * Both tables are capped, so a flood of attempts with made-up IDs cannot grow
+ * memory without bound. Once a shard's failure table is full, the ID whose last
+ * failure is the oldest is forgotten; locks never take room there, so locked IDs
+ * cannot stop new failures from being counted. A lock in force is never dropped
+ * to make room for another: an ID that reaches MaxFailedAttempts while its shard
+ * already holds its share of maxLockedIds() locks stays unlocked, and the attempt
+ * is reported as rate limited. That cap is four times the failure cap by default.
+ * A failure entry takes about 200 bytes plus its ID, a lock about 100 bytes plus
+ * its ID.
+ *
+ * A forgotten ID does not lose its failures. Its count goes into a count-min
+ * sketch of SketchDepth rows of SketchWidth 8-bit counters per shard, and an ID
+ * that is tracked again starts from the sketch's estimate, so cycling made-up
+ * IDs cannot reset the count of a real one. Each counter keeps the highest
+ * count of the IDs hashed to it. The estimate can be too high, never too low:
+ * during a flood that keeps pushing IDs out, the estimates climb until failed
+ * attempts of untracked IDs lock them at once or are refused, which is the rate
+ * limiting wanted then. Valid credentials never consult the sketch, so they
+ * keep working. The sketch has two halves, one per FailureWindowMs period,
+ * and the older one is cleared as the window moves on. All sketches together
+ * take ShardCount * 2 * SketchDepth * SketchWidth bytes, 512 KiB.
+ */
+class LoginState {
+public:
+    static constexpr int ShardCount = 16;                       ///< Number of independently locked shards, a power of two.
+    static constexpr int MaxFailedAttempts = 5;                 ///< Failures within the window that lock an ID.
+    static constexpr qint64 FailureWindowMs = 15 * 60 * 1000;   ///< Sliding window failures are counted in.
+    static constexpr qint64 LockDurationMs = 60 * 1000;         ///< How long a lock lasts.
+    static constexpr qsizetype DefaultMaxTrackedIds = 64 * 1024; ///< Default cap on the IDs whose failures are remembered at once.
+    static constexpr qsizetype DefaultMaxLockedIds = 256 * 1024; ///< Default cap on the IDs locked at once.
+    static constexpr int SketchDepth = 4;                       ///< Rows of each failure sketch.
+    static constexpr int SketchWidth = 4096;                    ///< Counters per sketch row, a power of two.
+
+    /**
+     * @brief Result of one recorded login attempt.
+     */
+    struct Attempt {
+        bool succeeded = false;     ///< The credentials were valid and the ID was not locked.
+        bool wasLocked = false;     ///< The ID was already locked; nothing was counted.
+        bool lockedNow = false;     ///< This attempt reached MaxFailedAttempts and locked the ID.
+        bool rateLimited = false;   ///< The ID reached MaxFailedAttempts, but its shard holds as many locks as it may; it stays unlocked.
+        int failedAttempts = 0;     ///< Failures of the ID within the window, after this one.
+        qint64 lockRemainingMs = 0; ///< Time left on the ID's lock, 0 if it is not locked.
+    };
+
+    /**
+     * @brief Creates an empty state.
+     * @param maxTrackedIds How many IDs' failures are remembered at most, spread evenly over the shards.
+     * @param maxLockedIds How many IDs are locked at most, spread evenly over the shards.
+     */
+    explicit LoginState(qsizetype maxTrackedIds = DefaultMaxTrackedIds, qsizetype maxLockedIds = DefaultMaxLockedIds);
+
+    /**
+     * @brief Records a login attempt.
+     *
+     * A locked ID stays locked and is not counted. Otherwise valid credentials
+     * forget the ID's failures, and invalid ones add a failure and lock the ID
+     * when the window holds MaxFailedAttempts of them (the failures start over
+     * for the next lock).
+     *
+     * @param userID The ID that tried to log in.
+     * @param credentialsValid Whether the credentials were accepted.
+     * @return What the attempt did.
+     */
+    Attempt recordAttempt(const QString& userID, bool credentialsValid);
+
+    /**
+     * @brief Gets the failures of an ID within the window.
+     *
+     * For an ID that is not tracked this is the sketch's estimate, which may be too high.
+     *
+     * @param userID The ID.
+     * @return The failure count.
+     */
+    int failedAttempts(const QString& userID) const;
+
+    /**
+     * @brief Checks whether an ID is locked.
+     * @param userID The ID.
+     * @return True if the ID is locked.
+     */
+    bool isLocked(const QString& userID) const;
+
+    /**
+     * @brief Gets how long an ID stays locked.
+     * @param userID The ID.
+     * @return Milliseconds until the lock ends, 0 if the ID is not locked.
+     */
+    qint64 lockRemainingMs(const QString& userID) const;
+
+    /**
+     * @brief Locks an ID and forgets its failures.
+     * @param userID The ID.
+     * @param durationMs How long the lock lasts.
+     * @return True if the ID is locked, false if its shard holds as many other locks as it may.
+     */
+    bool lock(const QString& userID, qint64 durationMs = LockDurationMs);
+
+    /**
+     * @brief Unlocks an ID.
+     * @param userID The ID.
+     */
+    void unlock(const QString& userID);
+
+    /**
+     * @brief Gets the cap on IDs whose failures are remembered.
+     * @return The most IDs tracked at once.
+     */
+    qsizetype maxTrackedIds() const;
+
+    /**
+     * @brief Gets the number of IDs whose failures are remembered right now.
+     * @return The tracked ID count.
+     */
+    qsizetype trackedCount() const;
+
+    /**
+     * @brief Gets the cap on locked IDs.
+     * @return The most IDs locked at once.
+     */
+    qsizetype maxLockedIds() const;
+
+    /**
+     * @brief Gets the number of locks kept right now, including ended ones not dropped yet.
+     * @return The locked ID count.
+     */
+    qsizetype lockedCount() const;
+
+private:
+    /**
+     * @brief Failures of one unlocked ID.
+     */
+    struct Entry {
+        std::array<qint64, MaxFailedAttempts> failures{}; // Times of the latest failures, used as a ring.
+        int failureCount = 0;                              // Used slots of failures.
+        int nextFailure = 0;                               // Slot the next failure is written to.
+        std::list<QString>::iterator lruPosition;          // Place in Shard::unlocked.
+    };
+
+    /**
+     * @brief When the lock of an ID ends.
+     */
+    struct Deadline {
+        qint64 expires;     // Monotonic time in ms.
+        QString userID;     // The locked ID.
+
+        bool operator>(const Deadline& other) const { return expires > other.expires; }
+    };
+
+    using Entries = QHash<QString, Entry>;
+    using Locks = QHash<QString, qint64>; // Monotonic time in ms each lock ends, by user ID.
+    using Sketch = std::vector<quint8>; // SketchDepth rows of SketchWidth counters, on the heap since it is large.
+
+    /**
+     * @brief One independently locked part of the state.
+     */
+    struct Shard {
+        mutable QMutex mutex;           // Guards everything below.
+        Entries entries;                // Failures of unlocked IDs, by user ID.
+        std::list<QString> unlocked;    // The IDs of entries, least recently failed first.
+        Locks locks;                    // Locked IDs; never in entries at the same time.
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines; // Lock ends, earliest first.
+        Sketch currentFailures;         // Failure counts of forgotten IDs in the current window period.
+        Sketch previousFailures;        // The same for the period before it.
+        qint64 sketchPeriod = 0;        // Window period currentFailures belongs to.
+    };
+
+    /**
+     * @brief Gets the current monotonic time.
+     * @return Milliseconds on the monotonic clock.
+     */
+    static qint64 now();
+
+    /**
+     * @brief Counts the failures of an entry within the window.
+     * @param entry The entry.
+     * @param currentTime The current monotonic time.
+     * @return The failure count.
+     */
+    static int failuresInWindow(const Entry& entry, qint64 currentTime);
+
+    /**
+     * @brief Drops the locks that have ended. The caller holds the shard mutex.
+     * @param shard The shard.
+     * @param currentTime The current monotonic time.
+     */
+    static void expireLocks(Shard& shard, qint64 currentTime);
+
+    /**
+     * @brief Adds an entry, forgetting another ID first if the shard is full.
+     *
+     * The entry starts with the failures the sketch remembers for the ID.
+     *
+     * @param shard The shard.
+     * @param userID The new ID.
+     * @param currentTime The current monotonic time.
+     * @return The new entry.
+     */
+    Entries::iterator insertEntry(Shard& shard, const QString& userID, qint64 currentTime);
+
+    /**
+     * @brief Removes an entry.
+     * @param shard The shard.
+     * @param it The entry.
+     */
+    static void eraseEntry(Shard& shard, Entries::iterator it);
+
+    /**
+     * @brief Forgets the least recently failed ID, keeping its failures in the sketch.
+     * @param shard The shard.
+     * @param currentTime The current monotonic time.
+     * @return False if no ID is tracked, so nothing was forgotten.
+     */
+    static bool evictOne(Shard& shard, qint64 currentTime);
+
+    /**
+     * @brief Moves the sketch on to the window period of a time, clearing what is too old.
+     * @param shard The shard.
+     * @param currentTime The current monotonic time.
+     */
+    static void advanceSketch(Shard& shard, qint64 currentTime);
+
+    /**
+     * @brief Remembers the failure count of an ID in the sketch of the current period.
+     * @param shard The shard, its sketch advanced to the current period.
+     * @param userID The ID.
+     * @param failures The ID's failures within the window.
+     */
+    static void addToSketch(Shard& shard, const QString& userID, int failures);
+
+    /**
+     * @brief Estimates the failures of an ID within the window from the sketch.
+     * @param shard The shard.
+     * @param userID The ID.
+     * @param currentTime The current monotonic time.
+     * @return The estimate, never lower than the true count.
+     */
+    static int sketchEstimate(const Shard& shard, const QString& userID, qint64 currentTime);
+
+    /**
+     * @brief Gets the counters of an ID, one per sketch row.
+     * @param userID The ID.
+     * @return Positions of the counters in a sketch.
+     */
+    static std::array<qsizetype, SketchDepth> sketchSlots(const QString& userID);
+
+    /**
+     * @brief Locks an ID until a deadline and forgets its failures. The caller holds the shard mutex.
+     * @param shard The shard.
+     * @param userID The ID.
+     * @param lockedUntil Monotonic time in ms the lock ends.
+     * @return False if the ID is not locked yet and the shard holds as many locks as it may.
+     */
+    bool lockId(Shard& shard, const QString& userID, qint64 lockedUntil);
+
+    /**
+     * @brief Picks the shard an ID belongs to.
+     * @param userID The ID.
+     * @return The shard.
+     */
+    Shard& shardFor(const QString& userID);
+
+    /**
+     * @brief Picks the shard an ID belongs to.
+     * @param userID The ID.
+     * @return The shard.
+     */
+    const Shard& shardFor(const QString& userID) const;
+
+    std::array<Shard, ShardCount> shards;   // The state, split by ID hash.
+    qsizetype shardCapacity;                // Most IDs one shard remembers the failures of.
+    qsizetype shardLockCapacity;            // Most IDs one shard keeps locked.
+};
+
+#endif // LOGINSTATE_H
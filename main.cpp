@@ -5,6 +5,7 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QTableWidget>
+#include <QTableView>
 #include <QLineEdit>
 #include <QMessageBox>
 #include <QHeaderView>
@@ -18,13 +19,18 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFile>
+#include <QFutureWatcher>
+#include <QProgressDialog>
 #include "loginpage.h"
 #include "authenticatesystem.h"
 #include "financialreport.h"
 #include "cashflowtracking.h"
+#include "cashflowtablemodel.h"
+#include "csvwriter.h"
 #include "budgetpage.h"
 #include "dashboard.h"
 #include "inventory.h"
+#include "reportjobs.h"
 #include "mainwindow.h"
 
 /**
@@ -64,6 +70,7 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     budgetPage->setCurrentUserId(currentUserId);
 
     dashboardPage->setInventoryTable(sharedInventoryTable); // Set the shared inventory table for the dashboard
+    dashboardPage->setLedger(&cashflowTracking); // The dashboard shows the ledger's running totals
 
 
     InventoryPage* inventoryPage = new InventoryPage(); // Create the inventory page widget
@@ -107,10 +114,16 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     QPushButton* profitLossButton = new QPushButton("Generate Profit & Loss Report", financialsPage);
     QPushButton* expenseBreakdownButton = new QPushButton("Generate Expense Breakdown", financialsPage);
     QPushButton* balanceSheetButton = new QPushButton("Generate Balance Sheet", financialsPage);
+    QPushButton* allReportsButton = new QPushButton("Generate All Reports", financialsPage);
+    QPushButton* columnarExportButton = new QPushButton("Export Columnar Data", financialsPage);
+    QPushButton* transactionSummaryButton = new QPushButton("Generate Transaction Summary", financialsPage);
 
     profitLossButton->setFixedWidth(220);
     expenseBreakdownButton->setFixedWidth(220);
     balanceSheetButton->setFixedWidth(220);
+    allReportsButton->setFixedWidth(220);
+    columnarExportButton->setFixedWidth(220);
+    transactionSummaryButton->setFixedWidth(220);
 
 
     QHBoxLayout* buttonRow = new QHBoxLayout();
@@ -123,6 +136,19 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     buttonRow->addStretch();
 
     financialsLayout->addLayout(buttonRow);
+    financialsLayout->addSpacing(15);
+
+    // Combined report button on its own row, under the individual reports
+    QHBoxLayout* allReportsRow = new QHBoxLayout();
+    allReportsRow->addStretch();
+    allReportsRow->addWidget(allReportsButton);
+    allReportsRow->addSpacing(20);
+    allReportsRow->addWidget(columnarExportButton);
+    allReportsRow->addSpacing(20);
+    allReportsRow->addWidget(transactionSummaryButton);
+    allReportsRow->addStretch();
+
+    financialsLayout->addLayout(allReportsRow);
 
     // Add spacer to push everything up
     financialsLayout->addStretch();
@@ -141,52 +167,32 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     connect(logoutButton, &QPushButton::clicked, this, &MainWindow::handleLogout);
 
 
-    // Connect the profit/loss button to generate and display a profit/loss report
-    connect(profitLossButton, &QPushButton::clicked, this, [this]() {
-        try {
-            if (reportGenerator.loadCSV("business_financials.csv")) {
-                reportGenerator.generateProfitLossStatement("profit_loss_statement.csv");
-                QMessageBox::information(this, "Success", "Profit & Loss statement generated");
-            }
-            else {
-                QMessageBox::warning(this, "Error", "Failed to load financial data");
-            }
-        }
-        catch (const std::exception& e) {
-            QMessageBox::critical(this, "Error", QString("An error occurred: %1").arg(e.what()));
-        }
+    // Every report button starts a background job; the window stays usable and other reports can run alongside
+    connect(profitLossButton, &QPushButton::clicked, this, [this, profitLossButton]() {
+        startReportJob(profitLossButton, ReportJobs::Report::ProfitLoss, "Profit & Loss statement generated");
         });
 
-    // Connect the expense breakdown button to generate and display a expense breakdown report
-    connect(expenseBreakdownButton, &QPushButton::clicked, this, [this]() {
-        try {
-            if (reportGenerator.loadCSV("business_financials.csv")) {
-                reportGenerator.generateExpenseBreakdownReport("expense_breakdown_report.csv");
-                QMessageBox::information(this, "Success", "Expense breakdown report generated");
-            }
-            else {
-                QMessageBox::warning(this, "Error", "Failed to load financial data");
-            }
-        }
-        catch (const std::exception& e) {
-            QMessageBox::critical(this, "Error", QString("An error occurred: %1").arg(e.what()));
-        }
+    connect(expenseBreakdownButton, &QPushButton::clicked, this, [this, expenseBreakdownButton]() {
+        startReportJob(expenseBreakdownButton, ReportJobs::Report::ExpenseBreakdown, "Expense breakdown report generated");
         });
 
-    // Connect the balance sheet button to generate and display a balance sheet report
-    connect(balanceSheetButton, &QPushButton::clicked, this, [this]() {
-        try {
-            if (reportGenerator.loadCSV("business_financials.csv")) {
-                reportGenerator.generateBalanceSheetReport("balance_sheet_report.csv");
-                QMessageBox::information(this, "Success", "Balance sheet report generated");
-            }
-            else {
-                QMessageBox::warning(this, "Error", "Failed to load financial data");
-            }
-        }
-        catch (const std::exception& e) {
-            QMessageBox::critical(this, "Error", QString("An error occurred: %1").arg(e.what()));
-        }
+    connect(balanceSheetButton, &QPushButton::clicked, this, [this, balanceSheetButton]() {
+        startReportJob(balanceSheetButton, ReportJobs::Report::BalanceSheet, "Balance sheet report generated");
+        });
+
+    // The all reports job loads the data once and generates every report from one pass
+    connect(allReportsButton, &QPushButton::clicked, this, [this, allReportsButton]() {
+        startReportJob(allReportsButton, ReportJobs::Report::All, "All financial reports generated");
+        });
+
+    // Columnar file of the raw transactions, for analytics tools
+    connect(columnarExportButton, &QPushButton::clicked, this, [this, columnarExportButton]() {
+        startReportJob(columnarExportButton, ReportJobs::Report::Columnar, "Transactions exported to financial_transactions.npcol");
+        });
+
+    // Totals by type, month and payment method, in a file of their own
+    connect(transactionSummaryButton, &QPushButton::clicked, this, [this, transactionSummaryButton]() {
+        startReportJob(transactionSummaryButton, ReportJobs::Report::TransactionSummary, "Transaction summary report generated");
         });
 
     // Connect tab changes to update the budget page when the Budget tab is selected
@@ -207,6 +213,7 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     //two buttons that run the addtransaction and searchtransaction functions and export button for exportinh
     QPushButton* addButton = new QPushButton("Add Transaction");
     QPushButton* searchButton = new QPushButton("Search Transaction");
+    QPushButton* removeButton = new QPushButton("Remove Transaction");
     QPushButton* exportButton = new QPushButton("Generate Report");
 
     QLabel* titleLabel = new QLabel("Cashflow Tracking", this);
@@ -215,10 +222,24 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     cashflowLayout->addSpacing(8);
     cashflowLayout->addWidget(titleLabel);
 
-    tableWidget = new QTableWidget(cashflowTrackingPage);
-    tableWidget->setColumnCount(7);
-    tableWidget->setHorizontalHeaderLabels({ "ID", "Date/Time", "Seller", "Buyer", "Merchandise", "Cost", "Category" });
-    tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // The view reads the ledger through the model and only formats the rows on screen
+    tableModel = new CashflowTableModel(cashflowTracking, this);
+    transactionJournal = new TransactionJournal(this);
+    tableView = new QTableView(cashflowTrackingPage);
+    tableView->setModel(tableModel);
+    tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // Fixed row heights, so the view never measures every row of a large ledger
+    tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    tableView->verticalHeader()->setDefaultSectionSize(tableView->fontMetrics().height() + 8);
+    tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    // Cells are edited in place; each change is journaled like an add
+    connect(tableModel, &CashflowTableModel::transactionUpdated, this, [this](int transID) {
+        if (!transactionJournal->appendUpdate(*cashflowTracking.searchDataEntries(transID))) {
+            QMessageBox::warning(this, "Save Error", "The transaction was changed but could not be saved, the change will be lost on logout!");
+        }
+        dashboardPage->showLedgerTotals();
+        });
 
     // transaction input fields
     dateTimeEdit = new QLineEdit();
@@ -234,17 +255,19 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     QHBoxLayout* buttonLayout = new QHBoxLayout();
     buttonLayout->addWidget(addButton);
     buttonLayout->addWidget(searchButton);
+    buttonLayout->addWidget(removeButton);
     buttonLayout->addWidget(exportButton);
 
     // Add the button layout to the main vertical layout
     cashflowLayout->addLayout(buttonLayout);
 
-    cashflowLayout->addWidget(tableWidget);
+    cashflowLayout->addWidget(tableView);
     cashflowTrackingPage->setLayout(cashflowLayout);
 
     //connect buttons
     connect(addButton, &QPushButton::clicked, this, &MainWindow::addTransaction);
     connect(searchButton, &QPushButton::clicked, this, &MainWindow::searchTransaction);
+    connect(removeButton, &QPushButton::clicked, this, &MainWindow::removeTransaction);
     connect(exportButton, &QPushButton::clicked, this, &MainWindow::generateReport);
 }
 
@@ -267,6 +290,10 @@ void MainWindow::handleLogout() {
     );
 
     if (confirm == QMessageBox::Yes) {
+        // End only this window's session; the user stays registered and can log in again
+        authSystem->logoutSession(sessionToken);
+        sessionToken.clear();
+
         this->hide();  // 👈 don't close MainWindow
 
         LoginPage* loginPage = new LoginPage(authSystem, this); // 👈 pass THIS main window back
@@ -307,7 +334,8 @@ void MainWindow::addTransaction() {
         QString seller = sellerEdit.text().trimmed();
         QString buyer = buyerEdit.text().trimmed();
         QString merchandise = merchandiseEdit.text().trimmed();
-        double cost = costEdit.text().toDouble();
+        bool isCostValid;
+        Money cost = Money::parse(costEdit.text().toStdString(), &isCostValid);
         QString category = categoryEdit.text().trimmed();
 
         //if any data is empty give error
@@ -316,54 +344,30 @@ void MainWindow::addTransaction() {
             return;
         }
 
-        //update table
-        cashflowTracking.addData(dateTime.toStdString(), seller.toStdString(), buyer.toStdString(), merchandise.toStdString(), cost, category.toStdString());
-        updateTransactionTable();
+        //cost is parsed straight into cents, so it has to be a plain amount like 12.50
+        if (!isCostValid) {
+            QMessageBox::warning(&dialog, "Input Error", "Cost must be an amount like 12.50!");
+            return;
+        }
+
+        //add through the model, so the table only inserts the new row
+        int transID = tableModel->addData(dateTime.toStdString(), seller.toStdString(), buyer.toStdString(), merchandise.toStdString(), cost, category.toStdString());
+        if (!transactionJournal->appendAdd(*cashflowTracking.searchDataEntries(transID))) { // One journal line, not a full rewrite
+            QMessageBox::warning(&dialog, "Save Error", "The transaction was added but could not be saved, it will be lost on logout!");
+        }
+        dashboardPage->showLedgerTotals(); // Reads the running totals, the ledger is not rescanned
         dialog.accept();
         });
 
-    saveTransactions();
-
     dialog.exec();
 }
-/**
- * @brief Updates the transaction table with the latest data.
- *
- * Retrieves all transactions from CashflowTracking and populates the table widget
- * with the transaction details.
- *
- * @author Abbygail Latimer
- */
-void MainWindow::updateTransactionTable() {
-    // Populate the transaction table with data from CashflowTracking
-    tableWidget->setRowCount(0); // Clear the table by setting the row count to 0
-
-    // Retrieve all data entries from the CashflowTracking object
-    std::vector<DataEntry> transactions = cashflowTracking.getAllDataEntries();
-
-    // Iterate through each transaction entry
-    for (const auto& entry : transactions) {
-        // Get the current row count and insert a new row at the end
-        int row = tableWidget->rowCount();
-        tableWidget->insertRow(row);
-
-        // Populate the table with data from the current entry
-        tableWidget->setItem(row, 0, new QTableWidgetItem(QString::number(entry.transid))); // Transaction ID
-        tableWidget->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(entry.dateTime))); // Date and Time
-        tableWidget->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(entry.seller))); // Seller
-        tableWidget->setItem(row, 3, new QTableWidgetItem(QString::fromStdString(entry.buyer))); // Buyer
-        tableWidget->setItem(row, 4, new QTableWidgetItem(QString::fromStdString(entry.merchandise))); // Merchandise
-        tableWidget->setItem(row, 5, new QTableWidgetItem(QString::number(entry.cost, 'f', 2))); // Cost (formatted to 2 decimal places)
-        tableWidget->setItem(row, 6, new QTableWidgetItem(QString::fromStdString(entry.category))); // Category
-    }
-    saveTransactions();
-
-}
 /**
  * @brief Searches for a transaction by ID.
  *
  * Opens a dialog where users can input a transaction ID to search for a specific transaction.
- * If found, the transaction details are displayed in a message box.
+ * If found, the transaction details are displayed in a message box. A category or a date
+ * (e.g. 2025-03-01) can be entered instead to list the matching transaction IDs.
+ * Every lookup goes through the hash indexes of CashflowTracking.
  *
  * @author Abbygail Latimer
  */
@@ -377,7 +381,7 @@ void MainWindow::searchTransaction() {
 
     // Create a QLineEdit widget for entering the transaction ID
     QLineEdit searchEdit;
-    form.addRow("Transaction ID:", &searchEdit); // Add the QLineEdit to the form with a label
+    form.addRow("Transaction ID, category or date:", &searchEdit); // Add the QLineEdit to the form with a label
 
     // Create a QPushButton for initiating the search
     QPushButton searchButton("Search", &dialog);
@@ -386,10 +390,39 @@ void MainWindow::searchTransaction() {
     // Connect the search button's clicked signal to a lambda function
     connect(&searchButton, &QPushButton::clicked, [&]() {
         // Retrieve the text from the QLineEdit and convert it to an integer (transaction ID)
-        int searchID = searchEdit.text().toInt();
+        bool isID;
+        int searchID = searchEdit.text().trimmed().toInt(&isID);
+
+        // Not a number: look the text up as a category, then as a date
+        if (!isID) {
+            std::string key = searchEdit.text().trimmed().toStdString();
+            std::vector<int> matches = cashflowTracking.searchByCategory(key);
+            Money total = cashflowTracking.categoryTotal(key).total; // Running total, no rescan
+            if (matches.empty()) {
+                matches = cashflowTracking.searchByDate(key);
+                total = Money();
+                for (int id : matches) {
+                    total += cashflowTracking.searchDataEntries(id)->cost;
+                }
+            }
+
+            if (matches.empty()) {
+                QMessageBox::warning(&dialog, "Search Error", "No transactions found!");
+            }
+            else {
+                QStringList ids;
+                for (int id : matches) {
+                    ids << QString::number(id);
+                }
+                QMessageBox::information(&dialog, "Transactions Found",
+                    QString("%1 transaction(s), total $%2: %3").arg(matches.size()).arg(total.toQString()).arg(ids.join(", ")));
+            }
+            dialog.accept();
+            return;
+        }
 
         // Search for the transaction in the CashflowTracking object using the entered ID
-        DataEntry* transaction = cashflowTracking.searchDataEntries(searchID);
+        const DataEntry* transaction = cashflowTracking.searchDataEntries(searchID);
 
         // Check if the transaction was found
         if (!transaction) {
@@ -404,7 +437,7 @@ void MainWindow::searchTransaction() {
                 .arg(QString::fromStdString(transaction->seller)) // Seller
                 .arg(QString::fromStdString(transaction->buyer)) // Buyer
                 .arg(QString::fromStdString(transaction->merchandise)) // Merchandise
-                .arg(transaction->cost, 0, 'f', 2) // Cost (formatted to 2 decimal places)
+                .arg(transaction->cost.toQString()) // Cost (formatted to 2 decimal places)
                 .arg(QString::fromStdString(transaction->category)); // Category
 
             // Show the transaction details in an information message box
@@ -415,12 +448,45 @@ void MainWindow::searchTransaction() {
         dialog.accept();
         });
 
-    saveTransactions();
-
     // Display the dialog and wait for user interaction
     dialog.exec();
 }
 
+/**
+ * @brief Removes a transaction by ID.
+ *
+ * Opens a dialog where users can input the ID of the transaction to remove.
+ * The row is dropped from the table and the removal is appended to the journal.
+ */
+void MainWindow::removeTransaction() {
+    QDialog dialog(this);
+    dialog.setWindowTitle("Remove Transaction");
+
+    QFormLayout form(&dialog);
+    QLineEdit removeEdit;
+    form.addRow("Transaction ID:", &removeEdit);
+
+    QPushButton removeButton("Remove", &dialog);
+    form.addRow(&removeButton);
+
+    connect(&removeButton, &QPushButton::clicked, [&]() {
+        bool isID;
+        int removeID = removeEdit.text().trimmed().toInt(&isID);
+        if (!isID || !tableModel->removeData(removeID)) {
+            QMessageBox::warning(&dialog, "Remove Error", "Transaction not found!");
+            return;
+        }
+
+        if (!transactionJournal->appendRemove(removeID)) { // One journal line, like an add
+            QMessageBox::warning(&dialog, "Save Error", "The transaction was removed but this could not be saved, it will be back after logout!");
+        }
+        dashboardPage->showLedgerTotals();
+        dialog.accept();
+        });
+
+    dialog.exec();
+}
+
 void MainWindow::setCurrentUserId(const QString& id) {
     currentUserId = id;
 
@@ -430,13 +496,22 @@ void MainWindow::setCurrentUserId(const QString& id) {
     loadTransactions(id);  // load transactions when user logs in
 }
 
+/**
+ * @brief Remembers the session the logged in user works in.
+ * @param token The token returned by AuthenticateSystem::loginUser().
+ */
+void MainWindow::setSessionToken(const QString& token) {
+    sessionToken = token;
+}
+
 
 /**
  * @brief Generates a financial report for cashflow tracking.
  *
  * Allows users to select a date range and category, then exports transactions within that range
  * to a CSV file. The exported file contains details such as ID, date/time, seller, buyer,
- * merchandise, cost, and category.
+ * merchandise, cost, and category. Rows are written in date order, and the range query of
+ * CashflowTracking only touches the transactions inside the range.
  *
  * @author Abbygail Latimer
  */
@@ -470,7 +545,7 @@ void MainWindow::generateReport() {
         // Retrieve and trim the input values
         QString startDate = startDateEdit.text().trimmed(); // Start date input
         QString endDate = endDateEdit.text().trimmed();     // End date input
-        QString categoryFilter = categoryEdit.text().trimmed().toLower(); // Category filter (optional)
+        QString categoryFilter = categoryEdit.text().trimmed(); // Category filter (optional, any case)
 
         // Validate that both date fields are filled
         if (startDate.isEmpty() || endDate.isEmpty()) {
@@ -492,47 +567,37 @@ void MainWindow::generateReport() {
         QString filePath = QFileDialog::getSaveFileName(this, "Save CSV", "", "CSV Files (*.csv)");
         if (filePath.isEmpty()) return; // Exit if the user cancels the file dialog
 
-        // Open the selected file for writing
-        QFile file(filePath);
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        // Open the selected file for writing; fields with commas or quotes are quoted
+        CsvWriter out;
+        if (!out.open(filePath)) {
             QMessageBox::warning(&dialog, "File Error", "Unable to open file for writing.");
             return; // Exit if the file cannot be opened
         }
-
-        // Create a QTextStream to write to the file
-        QTextStream out(&file);
-        out << "ID,Date/Time,Seller,Buyer,Merchandise,Cost,Category\n"; // Write the CSV header
-
-        // Retrieve all transactions from the CashflowTracking object
-        std::vector<DataEntry> transactions = cashflowTracking.getAllDataEntries();
-
-        // Iterate through each transaction
-        for (const auto& entry : transactions) {
-            // Extract the date from the transaction's dateTime string
-            QDate entryDate = QDate::fromString(QString::fromStdString(entry.dateTime).split(",")[0], "yyyy-MM-dd");
-            // Convert the transaction's category to lowercase for comparison
-            QString entryCategory = QString::fromStdString(entry.category).toLower();
-
-            // Check if the transaction falls within the specified date range
-            bool inDateRange = entryDate.isValid() && entryDate >= start && entryDate <= end;
-            // Check if the transaction matches the category filter (if provided)
-            bool categoryMatches = categoryFilter.isEmpty() || entryCategory == categoryFilter;
-
-            // If both conditions are met, write the transaction to the CSV file
-            if (inDateRange && categoryMatches) {
-                out << entry.transid << ","
-                    << QString::fromStdString(entry.dateTime) << ","
-                    << QString::fromStdString(entry.seller) << ","
-                    << QString::fromStdString(entry.buyer) << ","
-                    << QString::fromStdString(entry.merchandise) << ","
-                    << entry.cost << ","
-                    << QString::fromStdString(entry.category) << "\n";
-            }
+        out.writeLine("ID,Date/Time,Seller,Buyer,Merchandise,Cost,Category"); // Write the CSV header
+
+        // Only the days in the range are visited; dates and categories were parsed and folded when stored
+        cashflowTracking.forEachInDateRange(
+            CashflowTracking::dayNumber(start.year(), start.month(), start.day()),
+            CashflowTracking::dayNumber(end.year(), end.month(), end.day()),
+            categoryFilter.toStdString(),
+            [&](const DataEntry& entry) {
+                // In range and in the category, write the transaction to the CSV file
+                out.addField(entry.transid);
+                out.addField(entry.dateTime);
+                out.addField(entry.seller);
+                out.addField(entry.buyer);
+                out.addField(entry.merchandise);
+                out.addField(entry.cost);
+                out.addField(entry.category);
+                out.endRow();
+            });
+
+        // Write the rest and replace the file
+        if (!out.commit()) {
+            QMessageBox::warning(&dialog, "File Error", "Unable to write the file: " + out.errorString());
+            return;
         }
 
-        // Close the file after writing
-        file.close();
-
         // Show a success message
         QMessageBox::information(&dialog, "Success", "CSV file saved successfully!");
 
@@ -555,66 +620,89 @@ void MainWindow::resizeEvent(QResizeEvent* event) {
     logoutButton->setGeometry(width() - buttonWidth - margin, margin - 7, buttonWidth, buttonHeight);
 }
 
-void MainWindow::saveTransactions() {
-    if (currentUserId.isEmpty()) return;
-
-    QJsonArray transactionsArray;
-    std::vector<DataEntry> transactions = cashflowTracking.getAllDataEntries();
-    for (const auto& entry : transactions) {
-        QJsonObject obj;
-        obj["id"] = QString::number(entry.transid);
-        obj["datetime"] = QString::fromStdString(entry.dateTime);
-        obj["seller"] = QString::fromStdString(entry.seller);
-        obj["buyer"] = QString::fromStdString(entry.buyer);
-        obj["merchandise"] = QString::fromStdString(entry.merchandise);
-        obj["cost"] = QString::number(entry.cost, 'f', 2); // 👈 formatted
-        obj["category"] = QString::fromStdString(entry.category);
-        transactionsArray.append(obj);
+/**
+ * @brief Loads a user's ledger from the last snapshot plus the journal of later changes.
+ * @param userId The user to load.
+ */
+void MainWindow::loadTransactions(const QString& userId) {
+    // Replaces whatever ledger was shown before, with one reset for the whole ledger instead of one update per row
+    bool journalOpen = false;
+    tableModel->refresh([this, &userId, &journalOpen]() {
+        journalOpen = transactionJournal->load(userId, cashflowTracking);
+    });
+    dashboardPage->showLedgerTotals();
+
+    if (transactionJournal->snapshotDamaged()) {
+        // Nothing is loaded, and nothing may be saved over the damaged file
+        QMessageBox::critical(this, "Load Error",
+            "The saved transactions of this account are damaged and could not be loaded.\n"
+            "The file was left as it is so it can be recovered; changes made now will not be saved.");
+        return;
     }
 
-
-    QJsonObject root;
-    root["transactions"] = transactionsArray;
-
-    QFile file("data/" + currentUserId + "_transactions.json");
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(root).toJson());
-        file.close();
+    // The ledger is loaded, but changes can only be kept once the journal opens
+    if (!journalOpen) {
+        QMessageBox::warning(this, "Save Error",
+            "Your transactions were loaded, but the transaction journal could not be opened for writing.\n"
+            "New changes will be retried, and you will be told if they cannot be saved.");
     }
 }
 
-void MainWindow::loadTransactions(const QString& userId) {
-    QFile file("data/" + userId + "_transactions.json");
-    if (!file.open(QIODevice::ReadOnly)) return;
-
-    tableWidget->setRowCount(0);
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    file.close();
-
-    QJsonArray transactionsArray = doc["transactions"].toArray();
-    for (const QJsonValue& val : transactionsArray) {
-        QJsonObject obj = val.toObject();
-        int row = tableWidget->rowCount();
-        tableWidget->insertRow(row);
-        tableWidget->setItem(row, 0, new QTableWidgetItem(obj["id"].toString()));
-        tableWidget->setItem(row, 1, new QTableWidgetItem(obj["datetime"].toString()));
-        tableWidget->setItem(row, 2, new QTableWidgetItem(obj["seller"].toString()));
-        tableWidget->setItem(row, 3, new QTableWidgetItem(obj["buyer"].toString()));
-        tableWidget->setItem(row, 4, new QTableWidgetItem(obj["merchandise"].toString()));
-        tableWidget->setItem(row, 5, new QTableWidgetItem(obj["cost"].toString()));
-        tableWidget->setItem(row, 6, new QTableWidgetItem(obj["category"].toString()));
-
-        // 👇 This ensures persistence in memory
-        cashflowTracking.addData(
-            obj["datetime"].toString().toStdString(),
-            obj["seller"].toString().toStdString(),
-            obj["buyer"].toString().toStdString(),
-            obj["merchandise"].toString().toStdString(),
-            obj["cost"].toString().toDouble(),
-            obj["category"].toString().toStdString()
-        );
+/**
+ * @brief Generates a financial report in the background.
+ *
+ * The CSV file is located here on the GUI thread, since that may ask the user
+ * to pick it. Loading and writing then run as a ReportJobs job while a progress
+ * dialog with a cancel button follows it. The button stays disabled until its
+ * job is done, but the other report buttons keep working.
+ *
+ * @param button The button that started the report.
+ * @param report The report or reports to generate.
+ * @param successMessage Message shown once the report was generated.
+ */
+void MainWindow::startReportJob(QPushButton* button, ReportJobs::Report report, const QString& successMessage) {
+    QString csvPath = FinancialReportGenerator::resolveCSVPath("business_financials.csv");
+    if (csvPath.isEmpty()) {
+        QMessageBox::warning(this, "Error", "Failed to load financial data");
+        return;
     }
 
+    button->setEnabled(false);
+
+    // Non-modal, so the window stays usable; quick reports finish before it ever shows
+    QProgressDialog* progressDialog = new QProgressDialog(button->text() + "...", "Cancel", 0,
+        ReportJobs::ProgressRange, this);
+    progressDialog->setWindowModality(Qt::NonModal);
+    progressDialog->setMinimumDuration(500);
+    progressDialog->setValue(0);
+
+    QFutureWatcher<ReportJobs::Result>* watcher = new QFutureWatcher<ReportJobs::Result>(this);
+    connect(watcher, &QFutureWatcher<ReportJobs::Result>::progressValueChanged,
+        progressDialog, &QProgressDialog::setValue);
+    connect(progressDialog, &QProgressDialog::canceled, watcher, [watcher]() { watcher->future().cancel(); });
+    connect(watcher, &QFutureWatcher<ReportJobs::Result>::finished, this,
+        [this, watcher, progressDialog, button, successMessage]() {
+            progressDialog->deleteLater();
+            watcher->deleteLater();
+            button->setEnabled(true);
+
+            if (watcher->isCanceled() || watcher->future().resultCount() == 0) {
+                qDebug() << "Report generation cancelled";
+                return;
+            }
+
+            ReportJobs::Result result = watcher->result();
+            if (!result.error.isEmpty()) {
+                QMessageBox::critical(this, "Error", QString("An error occurred: %1").arg(result.error));
+            }
+            else if (result.succeeded) {
+                QMessageBox::information(this, "Success", successMessage);
+            }
+            else {
+                QMessageBox::warning(this, "Error", "Failed to load financial data");
+            }
+        });
+    watcher->setFuture(ReportJobs::start(csvPath, report));
 }
 
 
@@ -2,12 +2,14 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTableWidget>
+#include <QTableView>
 #include <QLineEdit>
 #include <QPushButton>
 #include "authenticatesystem.h"
 #include "financialreport.h"
 #include "cashflowtracking.h"
+#include "transactionjournal.h"
+#include "reportjobs.h"
 #include "dashboard.h"
 #include "loginpage.h"
 #include "inventory.h"
@@ -16,7 +18,8 @@
 class QPushButton;
 class QResizeEvent;
 class QLineEdit;
-class QTableWidget;
+class QTableView;
+class CashflowTableModel;
 class AuthenticateSystem;
 class LoginPage;
 class FinancialReportGenerator;
@@ -50,9 +53,10 @@ class Dashboard;
 class MainWindow : public QMainWindow {
     Q_OBJECT
 private:
-    FinancialReportGenerator reportGenerator; // Handles financial report generation (e.g., profit/loss, balance sheet)
     CashflowTracking cashflowTracking; // Manages cashflow transactions and data entries
-    QTableWidget* tableWidget; // Displays cashflow transactions in a table format
+    QTableView* tableView; // Displays cashflow transactions in a table format
+    CashflowTableModel* tableModel; // Serves the visible rows of cashflowTracking to tableView
+    TransactionJournal* transactionJournal; // Appends every ledger change to the user's journal
     QLineEdit* dateTimeEdit; // Input field for transaction date and time
     QLineEdit* sellerEdit; // Input field for the seller's name
     QLineEdit* buyerEdit; // Input field for the buyer's name
@@ -64,6 +68,7 @@ private:
     AuthenticateSystem* authSystem; // Pointer to the authentication system
     LoginPage* loginPage; // Pointer to the login page
     QString currentUserId;
+    QString sessionToken; // Session of the logged in user, ended on logout
     Dashboard* dashboardPage;
 
 
@@ -71,7 +76,7 @@ public:
     explicit MainWindow(AuthenticateSystem* authSystem, QWidget* parent = nullptr);
     ~MainWindow();
     void setCurrentUserId(const QString& id);
-    void saveTransactions();
+    void setSessionToken(const QString& token);
     void loadTransactions(const QString& userId);
 
 
@@ -80,14 +85,14 @@ private slots:
      * @brief Adds a new transaction entry.
      */
     void addTransaction();
-    /**
-     * @brief Updates the transaction table with current data.
-     */
-    void updateTransactionTable();
     /**
      * @brief Searches for a transaction by ID.
      */
     void searchTransaction();
+    /**
+     * @brief Removes a transaction by ID.
+     */
+    void removeTransaction();
     /**
      * @brief Exports transactions between two dates to a CSV file.
      */
@@ -95,6 +100,15 @@ private slots:
 
     void handleLogout();
 
+private:
+    /**
+     * @brief Generates a financial report in a background job with a cancellable progress dialog.
+     * @param button The button that started the report; disabled until the job ends.
+     * @param report The report or reports to generate.
+     * @param successMessage Message shown once the report was generated.
+     */
+    void startReportJob(QPushButton* button, ReportJobs::Report report, const QString& successMessage);
+
 protected:
     void resizeEvent(QResizeEvent* event) override;
 
@@ -0,0 +1,171 @@
+#include "money.h"
+#include <cmath>
+#include <limits>
+
+/**
+ * @class money.cpp
+ * @brief Implements parsing and formatting of the fixed-point Money type.
+ */
+
+/**
+ * @brief Creates an amount from a double, rounded to the nearest cent.
+ *
+ * std::llround() is undefined for NaN and for results outside 64 bits, so those
+ * never reach it: NaN becomes zero and the rest is clamped.
+ *
+ * @param amount The amount in dollars.
+ * @return The amount.
+ */
+Money Money::fromDouble(double amount) {
+    const double cents = amount * 100.0;
+    if (std::isnan(cents)) {
+        return Money();
+    }
+
+    // 2^63 is the first double past the 64-bit range; the clamp matches the largest amount parse() accepts
+    const double limit = std::ldexp(1.0, 63);
+    const std::int64_t maxCents = (std::numeric_limits<std::int64_t>::max() / 100 - 1) * 100 + 99;
+    if (cents >= limit) {
+        return fromCents(maxCents);
+    }
+    if (cents <= -limit) {
+        return fromCents(-maxCents);
+    }
+    return fromCents(std::llround(cents));
+}
+
+/**
+ * @brief Parses decimal text into cents using integer arithmetic only.
+ *
+ * @param text The text to parse.
+ * @param out Receives the amount when parsing succeeds.
+ * @return True if the text is a valid amount, false otherwise.
+ */
+bool Money::parse(std::string_view text, Money& out) {
+    std::size_t begin = 0;
+    std::size_t end = text.size();
+
+    // Ignore surrounding spaces
+    while (begin < end && (text[begin] == ' ' || text[begin] == '\t')) {
+        begin++;
+    }
+    while (end > begin && (text[end - 1] == ' ' || text[end - 1] == '\t' || text[end - 1] == '\r')) {
+        end--;
+    }
+
+    bool negative = false;
+    if (begin < end && (text[begin] == '-' || text[begin] == '+')) {
+        negative = text[begin] == '-';
+        begin++;
+    }
+    if (begin < end && text[begin] == '$') {
+        begin++; // Optional currency sign after the sign
+    }
+
+    const std::int64_t maxWhole = std::numeric_limits<std::int64_t>::max() / 100 - 1;
+    std::int64_t whole = 0;
+    int digitCount = 0;
+
+    // Whole dollars
+    while (begin < end && text[begin] >= '0' && text[begin] <= '9') {
+        whole = whole * 10 + (text[begin] - '0');
+        if (whole > maxWhole) {
+            return false; // Would overflow once scaled to cents
+        }
+        digitCount++;
+        begin++;
+    }
+
+    // Cents, rounding on the third decimal
+    std::int64_t cents = 0;
+    if (begin < end && text[begin] == '.') {
+        begin++;
+        int decimals = 0;
+        while (begin < end && text[begin] >= '0' && text[begin] <= '9') {
+            int digit = text[begin] - '0';
+            if (decimals < 2) {
+                cents = cents * 10 + digit;
+            }
+            else if (decimals == 2 && digit >= 5) {
+                cents++; // Round half away from zero
+            }
+            decimals++;
+            digitCount++;
+            begin++;
+        }
+        if (decimals == 1) {
+            cents *= 10; // "12.5" means 50 cents
+        }
+    }
+
+    if (digitCount == 0 || begin != end) {
+        return false; // No digits at all, or trailing garbage
+    }
+
+    std::int64_t total = whole * 100 + cents;
+    out = fromCents(negative ? -total : total);
+    return true;
+}
+
+/**
+ * @brief Parses decimal text into an amount.
+ * @param text The text to parse.
+ * @param ok If not null, set to whether parsing succeeded.
+ * @return The amount, or zero if the text is not a valid amount.
+ */
+Money Money::parse(std::string_view text, bool* ok) {
+    Money amount;
+    bool parsed = parse(text, amount);
+    if (ok) {
+        *ok = parsed;
+    }
+    return parsed ? amount : Money();
+}
+
+/**
+ * @brief Gets the amount as a double.
+ * @return The amount in dollars.
+ */
+double Money::toDouble() const {
+    return static_cast<double>(value) / 100.0;
+}
+
+/**
+ * @brief Formats the amount with two decimals.
+ * @return The formatted amount.
+ */
+std::string Money::toString() const {
+    char buffer[MaxFormattedLength];
+    return std::string(buffer, format(buffer));
+}
+
+/**
+ * @brief Formats the amount into a buffer, writing digits back to front.
+ * @param buffer Output buffer of at least MaxFormattedLength characters.
+ * @return Pointer one past the last character written.
+ */
+char* Money::format(char* buffer) const {
+    // Work on the magnitude as unsigned so the most negative value does not overflow
+    std::uint64_t magnitude = value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+
+    char digits[MaxFormattedLength];
+    int length = 0;
+    digits[length++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+    digits[length++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+    digits[length++] = '.';
+    do {
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    char* out = buffer;
+    if (value < 0) {
+        *out++ = '-';
+    }
+    while (length > 0) {
+        *out++ = digits[--length];
+    }
+    return out;
+}
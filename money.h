@@ -0,0 +1,146 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#ifdef QT_CORE_LIB
+#include <QJsonValue>
+#include <QString>
+#endif
+
+/**
+ * @class Money
+ * @brief Exact fixed-point money amount stored as a 64-bit number of cents.
+ *
+ * Adding up doubles drifts once totals run over millions of rows; adding up
+ * integer cents does not. Money wraps a signed 64-bit cent count, parses decimal
+ * text straight into cents without going through a double, and formats back to
+ * text with exactly two decimals.
+ *
+ * Doubles are only used at the edges (spin boxes, charts) through fromDouble()
+ * and toDouble().
+ */
+class Money {
+public:
+    /**
+     * @brief Creates a zero amount.
+     */
+    constexpr Money() = default;
+
+    /**
+     * @brief Creates an amount from a number of cents.
+     * @param cents The amount in cents.
+     * @return The amount.
+     */
+    static constexpr Money fromCents(std::int64_t cents) {
+        Money money;
+        money.value = cents;
+        return money;
+    }
+
+    /**
+     * @brief Creates an amount from a double, rounded to the nearest cent.
+     *
+     * NaN becomes zero, and amounts too large for the cents to fit, infinities
+     * included, are clamped to the largest amount parse() accepts.
+     *
+     * @param amount The amount in dollars.
+     * @return The amount.
+     */
+    static Money fromDouble(double amount);
+
+    /**
+     * @brief Parses decimal text such as "1234.5", "-0.99" or "$12.30" into cents.
+     *
+     * Leading and trailing spaces are ignored. Digits after the second decimal are
+     * rounded half away from zero. Exponents and thousands separators are rejected.
+     *
+     * @param text The text to parse.
+     * @param out Receives the amount when parsing succeeds.
+     * @return True if the text is a valid amount, false otherwise.
+     */
+    static bool parse(std::string_view text, Money& out);
+
+    /**
+     * @brief Parses decimal text into an amount.
+     * @param text The text to parse.
+     * @param ok If not null, set to whether parsing succeeded.
+     * @return The amount, or zero if the text is not a valid amount.
+     */
+    static Money parse(std::string_view text, bool* ok = nullptr);
+
+    /**
+     * @brief Gets the amount in cents.
+     * @return The cent count.
+     */
+    constexpr std::int64_t cents() const { return value; }
+
+    /**
+     * @brief Gets the amount as a double, for charts and spin boxes.
+     * @return The amount in dollars.
+     */
+    double toDouble() const;
+
+    /**
+     * @brief Formats the amount with two decimals, e.g. "-12.30".
+     * @return The formatted amount.
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Formats the amount into a caller-provided buffer without allocating.
+     * @param buffer Output buffer of at least MaxFormattedLength characters.
+     * @return Pointer one past the last character written (no terminator is added).
+     */
+    char* format(char* buffer) const;
+
+    static constexpr int MaxFormattedLength = 24; ///< Longest text format() can write.
+
+    constexpr Money operator+(Money other) const { return fromCents(value + other.value); }
+    constexpr Money operator-(Money other) const { return fromCents(value - other.value); }
+    constexpr Money operator-() const { return fromCents(-value); }
+    constexpr Money operator*(std::int64_t count) const { return fromCents(value * count); }
+    Money& operator+=(Money other) { value += other.value; return *this; }
+    Money& operator-=(Money other) { value -= other.value; return *this; }
+
+    constexpr bool operator==(Money other) const { return value == other.value; }
+    constexpr bool operator!=(Money other) const { return value != other.value; }
+    constexpr bool operator<(Money other) const { return value < other.value; }
+    constexpr bool operator<=(Money other) const { return value <= other.value; }
+    constexpr bool operator>(Money other) const { return value > other.value; }
+    constexpr bool operator>=(Money other) const { return value >= other.value; }
+
+#ifdef QT_CORE_LIB
+    /**
+     * @brief Formats the amount as a QString with two decimals.
+     * @return The formatted amount.
+     */
+    QString toQString() const {
+        char buffer[MaxFormattedLength];
+        return QString::fromLatin1(buffer, format(buffer) - buffer);
+    }
+
+    /**
+     * @brief Reads an amount from a JSON value.
+     *
+     * Amounts are written as exact decimal strings, but plain JSON numbers from
+     * older files are accepted as well.
+     *
+     * @param json The JSON value to read.
+     * @return The amount, or zero if the value is not an amount.
+     */
+    static Money fromJson(const QJsonValue& json) {
+        if (json.isString()) {
+            return parse(json.toString().toStdString());
+        }
+        return fromDouble(json.toDouble());
+    }
+#endif
+
+private:
+    std::int64_t value = 0; // The amount in cents.
+};
+
+#endif // MONEY_H
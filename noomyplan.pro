@@ -7,9 +7,24 @@ SOURCES += main.cpp \
     financialreport.cpp \
     loginpage.cpp \
     cashflowtracking.cpp \
+    cashflowtablemodel.cpp \
+    transactionjournal.cpp \
+    ledgersnapshot.cpp \
+    reportjobs.cpp \
+    datasetcache.cpp \
+    columnarexport.cpp \
+    storageengine.cpp \
+    loginstate.cpp \
+    sessionmanager.cpp \
+    usertable.cpp \
     authenticatesystem.cpp \
     dashboard.cpp \
-    user.cpp
+    user.cpp \
+    csvreader.cpp \
+    csvwriter.cpp \
+    transactionstore.cpp \
+    aggregationkernels.cpp \
+    money.cpp
 
     
 
@@ -17,12 +32,27 @@ HEADERS += financialreport.h \
     loginpage.h \
     user.h \
     cashflowtracking.h \
+    cashflowtablemodel.h \
+    transactionjournal.h \
+    ledgersnapshot.h \
+    reportjobs.h \
+    datasetcache.h \
+    columnarexport.h \
+    storageengine.h \
+    loginstate.h \
+    sessionmanager.h \
+    usertable.h \
     authenticatesystem.h \
     budgetpage.h \
     budgetpagebudget.h \
     budgetpageexpenses.h \
     dashboard.h \
-    inventory.h
+    inventory.h \
+    csvreader.h \
+    csvwriter.h \
+    transactionstore.h \
+    aggregationkernels.h \
+    money.h
 
 
 # Default rules for deployment.
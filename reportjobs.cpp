@@ -0,0 +1,84 @@
+#include "reportjobs.h"
+#include "financialreport.h"
+#include <QDebug>
+#include <QPromise>
+#include <exception>
+#include <memory>
+
+/**
+ * @class reportjobs.cpp
+ * @brief Implements the background report jobs.
+ */
+
+/**
+ * @brief Starts generating a report in the background.
+ *
+ * The job runs on the given pool and reports its progress through the returned
+ * future. Parsing the file takes the first LoadProgressShare of the progress
+ * range and writing the reports the rest. Exceptions are caught on the worker
+ * and handed back in Result::error.
+ *
+ * @param csvPath Resolved path of the financial data CSV file.
+ * @param report The report or reports to write.
+ * @param pool Pool the job runs on.
+ * @return The future of the job.
+ */
+QFuture<ReportJobs::Result> ReportJobs::start(const QString& csvPath, Report report, QThreadPool* pool) {
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+    promise->setProgressRange(0, ProgressRange);
+
+    pool->start([promise, csvPath, report]() {
+        Result result;
+        try {
+            // A generator per job, so jobs running side by side never share data
+            FinancialReportGenerator generator;
+            bool loaded = generator.loadResolvedCSV(csvPath, [&promise](qint64 bytesParsed, qint64 bytesTotal) {
+                if (bytesTotal > 0) {
+                    promise->setProgressValue(static_cast<int>(bytesParsed * LoadProgressShare / bytesTotal));
+                }
+                return !promise->isCanceled();
+            });
+
+            if (promise->isCanceled()) {
+                qDebug() << "Report job for" << csvPath << "was cancelled";
+                promise->finish(); // No result, the future stays cancelled
+                return;
+            }
+
+            if (loaded) {
+                switch (report) {
+                case Report::ProfitLoss:
+                    generator.generateProfitLossStatement("profit_loss_statement.csv");
+                    break;
+                case Report::ExpenseBreakdown:
+                    generator.generateExpenseBreakdownReport("expense_breakdown_report.csv");
+                    break;
+                case Report::BalanceSheet:
+                    generator.generateBalanceSheetReport("balance_sheet_report.csv");
+                    break;
+                case Report::TransactionSummary:
+                    generator.generateTransactionSummaryReport("transaction_summary_report.csv");
+                    break;
+                case Report::All:
+                    generator.generateAllReports("profit_loss_statement.csv",
+                        "expense_breakdown_report.csv", "balance_sheet_report.csv");
+                    break;
+                case Report::Columnar:
+                    loaded = generator.exportColumnar("financial_transactions.npcol");
+                    break;
+                }
+            }
+            result.succeeded = loaded;
+        }
+        catch (const std::exception& e) {
+            result.error = QString::fromUtf8(e.what());
+        }
+
+        promise->setProgressValue(ProgressRange);
+        promise->addResult(result);
+        promise->finish();
+    });
+    return future;
+}
@@ -0,0 +1,58 @@
+#ifndef REPORTJOBS_H
+#define REPORTJOBS_H
+
+#include <QFuture>
+#include <QString>
+#include <QThreadPool>
+
+/**
+ * @class ReportJobs
+ * @brief Runs financial report generation as background jobs on a thread pool.
+ *
+ * Every job loads the CSV file into its own FinancialReportGenerator and writes
+ * the requested reports, so several jobs can run at the same time without
+ * sharing any state. A job is followed through the QFuture it returns:
+ * - progress goes from 0 to ProgressRange, most of it while the file is parsed,
+ * - cancelling the future stops the parse at its next check and skips the reports,
+ * - the result tells whether the data could be loaded, or which error stopped the job.
+ *
+ * The file path must already be resolved, because finding the file may open a
+ * dialog; see FinancialReportGenerator::resolveCSVPath().
+ */
+class ReportJobs {
+public:
+    /**
+     * @brief Reports a job can generate.
+     */
+    enum class Report {
+        ProfitLoss,         ///< profit_loss_statement.csv
+        ExpenseBreakdown,   ///< expense_breakdown_report.csv
+        BalanceSheet,       ///< balance_sheet_report.csv
+        All,                ///< All three, from a single load.
+        TransactionSummary, ///< transaction_summary_report.csv
+        Columnar            ///< financial_transactions.npcol, see ColumnarExport.
+    };
+
+    /**
+     * @brief Outcome of a finished job.
+     */
+    struct Result {
+        bool succeeded = false; ///< The data was loaded and the reports were generated.
+        QString error;          ///< Message of an unexpected error, empty otherwise.
+    };
+
+    static constexpr int ProgressRange = 100;   ///< Progress value of a finished job.
+    static constexpr int LoadProgressShare = 90; ///< Part of the progress range spent on loading the file.
+
+    /**
+     * @brief Starts generating a report in the background.
+     * @param csvPath Resolved path of the financial data CSV file.
+     * @param report The report or reports to write.
+     * @param pool Pool the job runs on.
+     * @return The future of the job; it is cancelled if the job was cancelled.
+     */
+    static QFuture<Result> start(const QString& csvPath, Report report,
+        QThreadPool* pool = QThreadPool::globalInstance());
+};
+
+#endif // REPORTJOBS_H
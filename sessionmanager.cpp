@@ -0,0 +1,153 @@
+#include "sessionmanager.h"
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+
+/**
+ * @class sessionmanager.cpp
+ * @brief Implements the sharded store of login sessions.
+ */
+
+static_assert((SessionManager::ShardCount & (SessionManager::ShardCount - 1)) == 0, "ShardCount must be a power of two");
+
+/**
+ * @brief Starts a session for a user.
+ *
+ * The token is drawn from QRandomGenerator::system(), the operating system's
+ * cryptographically secure source.
+ *
+ * @param userID The user the session belongs to.
+ * @return The token of the new session.
+ */
+QString SessionManager::createSession(const QString& userID) {
+    std::array<quint32, TokenBytes / sizeof(quint32)> random;
+    QRandomGenerator::system()->fillRange(random.data(), static_cast<qsizetype>(random.size()));
+    const QByteArray token = QByteArray(reinterpret_cast<const char*>(random.data()), TokenBytes)
+        .toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+
+    const qint64 currentTime = now();
+    Shard& shard = shardFor(token);
+    QMutexLocker locker(&shard.mutex);
+    expireSessions(shard, currentTime);
+    shard.sessions.insert(token, Session{ userID, currentTime + IdleTimeoutMs });
+    shard.deadlines.push(Deadline{ currentTime + IdleTimeoutMs, token });
+    return QString::fromLatin1(token);
+}
+
+/**
+ * @brief Checks a token and keeps its session alive.
+ *
+ * Only the session's deadline is moved; its heap entry is left as it is and
+ * pushed again with the new deadline when it comes up.
+ *
+ * @param token The token to check.
+ * @param userID Receives the user of the session, if not null.
+ * @return True if the token names a session that has not expired.
+ */
+bool SessionManager::validate(const QString& token, QString* userID) {
+    const QByteArray key = token.toLatin1();
+    const qint64 currentTime = now();
+    Shard& shard = shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    auto it = shard.sessions.find(key);
+    if (it == shard.sessions.end() || it->expiresAt <= currentTime) {
+        return false; // Unknown, or expired and not dropped yet
+    }
+    it->expiresAt = currentTime + IdleTimeoutMs;
+    if (userID) {
+        *userID = it->userID;
+    }
+    return true;
+}
+
+/**
+ * @brief Ends one session.
+ * @param token The token of the session.
+ * @return True if the session existed.
+ */
+bool SessionManager::endSession(const QString& token) {
+    const QByteArray key = token.toLatin1();
+    Shard& shard = shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    return shard.sessions.remove(key) > 0; // Its deadline is skipped when it comes up
+}
+
+/**
+ * @brief Ends every session of a user.
+ * @param userID The user.
+ * @return The number of sessions ended.
+ */
+qsizetype SessionManager::endSessions(const QString& userID) {
+    qsizetype ended = 0;
+    for (Shard& shard : shards) {
+        QMutexLocker locker(&shard.mutex);
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end();) {
+            if (it->userID == userID) {
+                it = shard.sessions.erase(it);
+                ended++;
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+    return ended;
+}
+
+/**
+ * @brief Gets the number of sessions, including expired ones not dropped yet.
+ * @return The session count.
+ */
+qsizetype SessionManager::sessionCount() const {
+    qsizetype count = 0;
+    for (const Shard& shard : shards) {
+        QMutexLocker locker(&shard.mutex);
+        count += shard.sessions.size();
+    }
+    return count;
+}
+
+/**
+ * @brief Gets the current monotonic time.
+ * @return Milliseconds on the monotonic clock.
+ */
+qint64 SessionManager::now() {
+    return QDeadlineTimer::current().deadline();
+}
+
+/**
+ * @brief Drops the sessions that have expired. The caller holds the shard mutex.
+ *
+ * Pops every deadline that has passed. A session that was used since has a later
+ * deadline and is pushed again; an ended session is simply gone.
+ *
+ * @param shard The shard.
+ * @param currentTime The current monotonic time.
+ */
+void SessionManager::expireSessions(Shard& shard, qint64 currentTime) {
+    while (!shard.deadlines.empty() && shard.deadlines.top().expires <= currentTime) {
+        Deadline deadline = shard.deadlines.top();
+        shard.deadlines.pop();
+
+        auto it = shard.sessions.find(deadline.token);
+        if (it == shard.sessions.end()) {
+            continue;
+        }
+        if (it->expiresAt <= currentTime) {
+            shard.sessions.erase(it);
+        }
+        else {
+            deadline.expires = it->expiresAt; // Used since, wait for its new deadline
+            shard.deadlines.push(deadline);
+        }
+    }
+}
+
+/**
+ * @brief Picks the shard a token belongs to.
+ * @param token The token.
+ * @return The shard.
+ */
+SessionManager::Shard& SessionManager::shardFor(const QByteArray& token) {
+    return shards[qHash(token) & (ShardCount - 1)];
+}
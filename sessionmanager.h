@@ -0,0 +1,132 @@
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <functional>
+#include <queue>
+#include <vector>
+
+/**
+ * @class SessionManager
+ * @brief Thread-safe store of login sessions, each identified by an opaque token.
+ *
+ * A session is issued after a successful login and names the user it belongs to.
+ * Its token is 32 bytes from the system's cryptographic random generator, written
+ * as URL-safe base64, so it tells nothing about the user and cannot be guessed.
+ *
+ * Sessions are spread over ShardCount shards by the hash of their token, each
+ * with its own mutex, so validating a token is one hash lookup under a lock that
+ * is rarely contended. A user can hold any number of sessions at once, for
+ * example one per client; the User record itself is never changed.
+ *
+ * A session expires after IdleTimeoutMs without use, and every successful
+ * validation pushes that deadline back. Like LoginState, each shard keeps the
+ * deadlines in a min-heap and drops expired sessions whenever it is written to,
+ * so no timer is needed and forgotten sessions do not pile up.
+ */
+class SessionManager {
+public:
+    static constexpr int ShardCount = 16;                   ///< Number of independently locked shards, a power of two.
+    static constexpr int TokenBytes = 32;                   ///< Random bytes in a token.
+    static constexpr qint64 IdleTimeoutMs = 30 * 60 * 1000; ///< How long an unused session stays valid.
+
+    /**
+     * @brief Creates an empty session store.
+     */
+    SessionManager() = default;
+
+    /**
+     * @brief Starts a session for a user.
+     * @param userID The user the session belongs to.
+     * @return The token of the new session.
+     */
+    QString createSession(const QString& userID);
+
+    /**
+     * @brief Checks a token and keeps its session alive.
+     * @param token The token to check.
+     * @param userID Receives the user of the session, if not null.
+     * @return True if the token names a session that has not expired.
+     */
+    bool validate(const QString& token, QString* userID = nullptr);
+
+    /**
+     * @brief Ends one session.
+     * @param token The token of the session.
+     * @return True if the session existed.
+     */
+    bool endSession(const QString& token);
+
+    /**
+     * @brief Ends every session of a user.
+     *
+     * This visits every session, so it is meant for rare events such as removing
+     * a user, not for the normal logout of one client.
+     *
+     * @param userID The user.
+     * @return The number of sessions ended.
+     */
+    qsizetype endSessions(const QString& userID);
+
+    /**
+     * @brief Gets the number of sessions, including expired ones not dropped yet.
+     * @return The session count.
+     */
+    qsizetype sessionCount() const;
+
+private:
+    /**
+     * @brief One session.
+     */
+    struct Session {
+        QString userID;         // The user the session belongs to.
+        qint64 expiresAt = 0;   // Monotonic time in ms the session ends, unless used before.
+    };
+
+    /**
+     * @brief A point in time a session may have expired at.
+     */
+    struct Deadline {
+        qint64 expires;     // Monotonic time in ms.
+        QByteArray token;   // The session's token.
+
+        bool operator>(const Deadline& other) const { return expires > other.expires; }
+    };
+
+    /**
+     * @brief One independently locked part of the store.
+     */
+    struct Shard {
+        mutable QMutex mutex;                   // Guards everything below.
+        QHash<QByteArray, Session> sessions;    // Sessions by token.
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines; // Earliest first.
+    };
+
+    /**
+     * @brief Gets the current monotonic time.
+     * @return Milliseconds on the monotonic clock.
+     */
+    static qint64 now();
+
+    /**
+     * @brief Drops the sessions that have expired. The caller holds the shard mutex.
+     * @param shard The shard.
+     * @param currentTime The current monotonic time.
+     */
+    static void expireSessions(Shard& shard, qint64 currentTime);
+
+    /**
+     * @brief Picks the shard a token belongs to.
+     * @param token The token.
+     * @return The shard.
+     */
+    Shard& shardFor(const QByteArray& token);
+
+    std::array<Shard, ShardCount> shards;   // The sessions, split by token hash.
+};
+
+#endif // SESSIONMANAGER_H
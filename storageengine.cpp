@@ -0,0 +1,932 @@
+#include "storageengine.h"
+#include <QDebug>
+#include <QDir>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QtEndian>
+#include <array>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @class storageengine.cpp
+ * @brief Implements the log-structured single-file key-value store.
+ */
+
+namespace {
+
+    const char DatabaseMagic[8] = { 'N', 'P', 'K', 'V', 'D', 'B', '0', '1' };
+    const char CheckpointMagic[8] = { 'N', 'P', 'K', 'V', 'K', 'E', 'Y', '1' };
+    const char* const DefaultDatabasePath = "data/noomyplan.db";
+    constexpr qint64 FileHeaderSize = sizeof(DatabaseMagic) + sizeof(quint32);   // Magic and version.
+    constexpr qint64 FrameHeaderSize = 2 * sizeof(quint32);                     // Payload length and CRC-32.
+
+    enum OperationKind : quint8 {
+        PutOperation = 1,
+        RemoveOperation = 2
+    };
+
+    void appendLE16(QByteArray& out, quint16 value) {
+        const quint16 le = qToLittleEndian(value);
+        out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+    }
+
+    void appendLE32(QByteArray& out, quint32 value) {
+        const quint32 le = qToLittleEndian(value);
+        out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+    }
+
+    void appendLE64(QByteArray& out, quint64 value) {
+        const quint64 le = qToLittleEndian(value);
+        out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+    }
+
+    /**
+     * @brief Standard CRC-32 (IEEE 802.3), the checksum of every frame.
+     */
+    quint32 crc32(const QByteArray& data) {
+        static const std::array<quint32, 256> table = [] {
+            std::array<quint32, 256> values{};
+            for (quint32 i = 0; i < 256; ++i) {
+                quint32 crc = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                }
+                values[i] = crc;
+            }
+            return values;
+        }();
+
+        quint32 crc = 0xFFFFFFFFu;
+        for (const char c : data) {
+            crc = table[(crc ^ static_cast<quint8>(c)) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    /**
+     * @brief Appends one put or remove to a frame payload.
+     */
+    void encodeOperation(QByteArray& out, const QByteArray& table, const QByteArray& key, const QByteArray* value) {
+        out.append(static_cast<char>(value != nullptr ? PutOperation : RemoveOperation));
+        appendLE16(out, static_cast<quint16>(table.size()));
+        out.append(table);
+        appendLE32(out, static_cast<quint32>(key.size()));
+        out.append(key);
+        if (value != nullptr) {
+            appendLE32(out, static_cast<quint32>(value->size()));
+            out.append(*value);
+        }
+    }
+
+    /**
+     * @brief Wraps encoded operations into a frame: length, checksum, operation count and operations.
+     */
+    QByteArray encodeFrame(quint32 operationCount, const QByteArray& operations) {
+        QByteArray payload;
+        payload.reserve(sizeof(quint32) + operations.size());
+        appendLE32(payload, operationCount);
+        payload.append(operations);
+
+        QByteArray frame;
+        frame.reserve(FrameHeaderSize + payload.size());
+        appendLE32(frame, static_cast<quint32>(payload.size()));
+        appendLE32(frame, crc32(payload));
+        frame.append(payload);
+        return frame;
+    }
+
+    /**
+     * @brief Bounds-checked reader for a frame payload.
+     */
+    struct PayloadReader {
+        const QByteArray& data;
+        qsizetype position = 0;
+        bool ok = true;
+
+        bool has(qsizetype bytes) {
+            ok = ok && bytes <= data.size() - position;
+            return ok;
+        }
+
+        quint8 u8() {
+            return has(1) ? static_cast<quint8>(data[position++]) : 0;
+        }
+
+        quint16 u16() {
+            if (!has(sizeof(quint16))) {
+                return 0;
+            }
+            const quint16 value = qFromLittleEndian<quint16>(data.constData() + position);
+            position += sizeof(quint16);
+            return value;
+        }
+
+        quint32 u32() {
+            if (!has(sizeof(quint32))) {
+                return 0;
+            }
+            const quint32 value = qFromLittleEndian<quint32>(data.constData() + position);
+            position += sizeof(quint32);
+            return value;
+        }
+
+        quint64 u64() {
+            if (!has(sizeof(quint64))) {
+                return 0;
+            }
+            const quint64 value = qFromLittleEndian<quint64>(data.constData() + position);
+            position += sizeof(quint64);
+            return value;
+        }
+
+        bool skip(quint32 size) {
+            if (!has(static_cast<qsizetype>(size))) {
+                return false;
+            }
+            position += size;
+            return true;
+        }
+
+        QByteArray bytes(quint32 size) {
+            if (!has(static_cast<qsizetype>(size))) {
+                return QByteArray();
+            }
+            const QByteArray value = data.mid(position, size);
+            position += size;
+            return value;
+        }
+    };
+
+    /**
+     * @brief Checks that a payload decodes into whole operations, without keeping them.
+     */
+    bool payloadWellFormed(const QByteArray& payload) {
+        PayloadReader reader{ payload };
+        const quint32 operationCount = reader.u32();
+        for (quint32 i = 0; i < operationCount && reader.ok; ++i) {
+            const quint8 kind = reader.u8();
+            if (kind != PutOperation && kind != RemoveOperation) {
+                return false;
+            }
+            reader.skip(reader.u16()); // Table
+            reader.skip(reader.u32()); // Key
+            if (kind == PutOperation) {
+                reader.skip(reader.u32()); // Value
+            }
+        }
+        return operationCount > 0 && reader.ok && reader.position == payload.size();
+    }
+
+    /**
+     * @brief Checks whether a valid frame starts anywhere in some bytes of the log.
+     *
+     * Used on what follows a damaged frame: a torn last write is followed by
+     * nothing valid, a damaged frame in the middle of the log by later commits.
+     * Only offsets whose payload decodes have their checksum computed.
+     */
+    bool containsFrame(const QByteArray& data) {
+        for (qsizetype start = 0; start + FrameHeaderSize < data.size(); ++start) {
+            const quint32 payloadLength = qFromLittleEndian<quint32>(data.constData() + start);
+            if (payloadLength <= sizeof(quint32) || payloadLength > data.size() - start - FrameHeaderSize) {
+                continue;
+            }
+            const QByteArray payload = QByteArray::fromRawData(data.constData() + start + FrameHeaderSize, payloadLength);
+            if (payloadWellFormed(payload) && crc32(payload) == qFromLittleEndian<quint32>(data.constData() + start + sizeof(quint32))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Flushes a file and asks the OS to write it through to the disk.
+     */
+    bool syncToDisk(QFile& file) {
+        if (!file.flush()) {
+            return false;
+        }
+#ifdef Q_OS_WIN
+        return _commit(file.handle()) == 0;
+#else
+        return ::fsync(file.handle()) == 0;
+#endif
+    }
+
+}
+
+/**
+ * @brief Stores a value, replacing the current one.
+ * @param table The table.
+ * @param key The row key.
+ * @param value The value.
+ */
+void StorageEngine::Transaction::put(const QString& table, const QByteArray& key, const QByteArray& value) {
+    operations.append(Operation{ false, false, table, key, value });
+}
+
+/**
+ * @brief Stores a value only if the row does not exist yet when the transaction is committed.
+ * @param table The table.
+ * @param key The row key.
+ * @param value The value.
+ */
+void StorageEngine::Transaction::insert(const QString& table, const QByteArray& key, const QByteArray& value) {
+    operations.append(Operation{ false, true, table, key, value });
+}
+
+/**
+ * @brief Removes a row.
+ * @param table The table.
+ * @param key The row key.
+ */
+void StorageEngine::Transaction::remove(const QString& table, const QByteArray& key) {
+    operations.append(Operation{ true, false, table, key, QByteArray() });
+}
+
+/**
+ * @brief Gets the number of operations queued.
+ * @return The operation count.
+ */
+qsizetype StorageEngine::Transaction::size() const {
+    return operations.size();
+}
+
+/**
+ * @brief Checks whether the transaction has no operations.
+ * @return True if nothing is queued.
+ */
+bool StorageEngine::Transaction::isEmpty() const {
+    return operations.isEmpty();
+}
+
+/**
+ * @brief Gets the engine the application stores its data in, opened on first use.
+ * @return The engine for data/noomyplan.db.
+ */
+StorageEngine& StorageEngine::instance() {
+    static StorageEngine engine;
+    static const bool opened = [] {
+        QDir().mkpath("data");
+        return engine.open(DefaultDatabasePath);
+    }();
+    Q_UNUSED(opened)
+    return engine;
+}
+
+/**
+ * @brief Creates an engine that is not attached to a file yet.
+ */
+StorageEngine::StorageEngine() {
+    valueCache.setMaxCost(CacheBytes);
+}
+
+/**
+ * @brief Closes the file.
+ */
+StorageEngine::~StorageEngine() {
+    close();
+}
+
+/**
+ * @brief Opens a database file, creating it if needed, and replays its log.
+ * @param path The database file.
+ * @return True if the file could be opened and is a database of this version.
+ */
+bool StorageEngine::open(const QString& path) {
+    QMutexLocker locker(&mutex);
+    QWriteLocker indexLocker(&indexLock);
+    closeLocked();
+    return openLocked(path);
+}
+
+/**
+ * @brief Writes a key checkpoint if the log grew since the last one, closes the file and forgets its rows.
+ */
+void StorageEngine::close() {
+    QMutexLocker locker(&mutex);
+    QWriteLocker indexLocker(&indexLock);
+    closeLocked();
+}
+
+/**
+ * @brief Checks whether a database file is open.
+ * @return True if open() succeeded and close() was not called since.
+ */
+bool StorageEngine::isOpen() const {
+    QMutexLocker locker(&mutex);
+    return file.isOpen();
+}
+
+/**
+ * @brief Opens a file and replays it. The caller holds the mutex and the index write lock.
+ *
+ * The key checkpoint, if it matches the file, stands in for the frames it
+ * covers. The frames after it are read one after another. The first one that is
+ * incomplete, fails its checksum or cannot be decoded marks the end of the log
+ * if nothing valid follows it: it is the last write before a crash, so it is
+ * cut off and the file is usable again. If valid frames follow it, the file is
+ * damaged in the middle; it is left untouched and the open fails, since cutting
+ * it would delete every commit after the damage.
+ *
+ * @param path The database file.
+ * @return True on success.
+ */
+bool StorageEngine::openLocked(const QString& path) {
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        qDebug() << "Error: Unable to open database" << path << ":" << file.errorString();
+        return false;
+    }
+
+    if (file.size() == 0) {
+        // New database, only the header; a checkpoint left from an older file does not describe it
+        QFile::remove(checkpointPathOf(path));
+        QByteArray header(DatabaseMagic, sizeof(DatabaseMagic));
+        appendLE32(header, Version);
+        if (file.write(header) != header.size() || !syncToDisk(file)) {
+            qDebug() << "Error: Unable to initialise database" << path << ":" << file.errorString();
+            file.close();
+            return false;
+        }
+    }
+    else {
+        const QByteArray header = file.read(FileHeaderSize);
+        if (header.size() != FileHeaderSize || std::memcmp(header.constData(), DatabaseMagic, sizeof(DatabaseMagic)) != 0
+            || qFromLittleEndian<quint32>(header.constData() + sizeof(DatabaseMagic)) != Version) {
+            qDebug() << "Error:" << path << "is not a database of version" << Version;
+            file.close();
+            return false;
+        }
+    }
+
+    const qint64 fileSize = file.size();
+    qint64 position = FileHeaderSize;
+    const bool checkpointed = loadCheckpointLocked(path, fileSize, position);
+    int frames = 0;
+    while (position + FrameHeaderSize <= fileSize) {
+        file.seek(position);
+        const QByteArray frameHeader = file.read(FrameHeaderSize);
+        if (frameHeader.size() != FrameHeaderSize) {
+            break;
+        }
+        const quint32 payloadLength = qFromLittleEndian<quint32>(frameHeader.constData());
+        const quint32 checksum = qFromLittleEndian<quint32>(frameHeader.constData() + sizeof(quint32));
+        if (position + FrameHeaderSize + payloadLength > fileSize) {
+            break; // Cut off half way
+        }
+        const QByteArray payload = file.read(payloadLength);
+        if (payload.size() != static_cast<qsizetype>(payloadLength) || crc32(payload) != checksum
+            || !applyFrame(payload, position + FrameHeaderSize, false)) {
+            break; // Torn or damaged write
+        }
+        lastFrameOffset = position;
+        position += FrameHeaderSize + payloadLength;
+        frames++;
+    }
+
+    if (position != fileSize) {
+        file.seek(position + 1);
+        if (containsFrame(file.read(fileSize - position - 1))) {
+            qDebug() << "Error: Database" << path << "is damaged at offset" << position
+                << "with valid transactions after it; leaving the file untouched";
+            closeLocked();
+            return false;
+        }
+        qDebug() << "Dropping" << fileSize - position << "bytes of an incomplete transaction at the end of" << path;
+        if (!file.resize(position)) {
+            qDebug() << "Error: Unable to truncate database" << path << ":" << file.errorString();
+            closeLocked();
+            return false;
+        }
+    }
+
+    filePath = path;
+    framesSinceCheckpoint = frames;
+    if (frames >= CheckpointAfterFrames) {
+        writeCheckpointLocked(); // The next open need not replay these again
+    }
+    qDebug() << "Opened database" << path << "with" << tables.size() << "tables, replayed" << frames
+        << "transactions" << (checkpointed ? "after the key checkpoint" : "without a key checkpoint");
+    return true;
+}
+
+/**
+ * @brief Writes a key checkpoint if needed, closes the file and forgets its rows. The caller holds the mutex and the index write lock.
+ */
+void StorageEngine::closeLocked() {
+    if (file.isOpen()) {
+        if (framesSinceCheckpoint > 0) {
+            writeCheckpointLocked();
+        }
+        file.close();
+    }
+    tables.clear();
+    valueCache.clear();
+    deadBytes = 0;
+    lastFrameOffset = 0;
+    framesSinceCheckpoint = 0;
+    filePath.clear();
+}
+
+/**
+ * @brief Gets the key checkpoint file of a database file.
+ * @param path The database file.
+ * @return The checkpoint file.
+ */
+QString StorageEngine::checkpointPathOf(const QString& path) {
+    return path + ".keys";
+}
+
+/**
+ * @brief Loads the key checkpoint of the file being opened. The caller holds the mutex and the index write lock.
+ *
+ * The checkpoint holds a CRC-32 of its contents, the file offset it covers and
+ * the header of the last frame before that offset. It is only used if that
+ * frame header is still in the file at the same place, so a checkpoint of
+ * another or a compacted file is never applied. Only keys and value locations
+ * are read; the values stay in the database file.
+ *
+ * @param path The database file.
+ * @param fileSize Size of the database file.
+ * @param position Receives the file offset the checkpoint covers, where replaying continues.
+ * @return True if a checkpoint matching the file was loaded, false otherwise (nothing is loaded).
+ */
+bool StorageEngine::loadCheckpointLocked(const QString& path, qint64 fileSize, qint64& position) {
+    QFile checkpoint(checkpointPathOf(path));
+    if (!checkpoint.open(QIODevice::ReadOnly)) {
+        return false; // None written yet
+    }
+    const QByteArray contents = checkpoint.readAll();
+    checkpoint.close();
+
+    const qint64 headerSize = sizeof(CheckpointMagic) + sizeof(quint32);
+    if (contents.size() < headerSize || std::memcmp(contents.constData(), CheckpointMagic, sizeof(CheckpointMagic)) != 0) {
+        return false;
+    }
+    const QByteArray payload = contents.mid(headerSize);
+    if (qFromLittleEndian<quint32>(contents.constData() + sizeof(CheckpointMagic)) != crc32(payload)) {
+        qDebug() << "Ignoring damaged key checkpoint of" << path;
+        return false;
+    }
+
+    PayloadReader reader{ payload };
+    const qint64 covered = static_cast<qint64>(reader.u64());
+    const qint64 frameOffset = static_cast<qint64>(reader.u64());
+    const QByteArray frameHeader = reader.bytes(FrameHeaderSize);
+    const qint64 dead = static_cast<qint64>(reader.u64());
+    if (!reader.ok || covered < FileHeaderSize || covered > fileSize) {
+        return false;
+    }
+
+    // The covered part of the file must still end with the frame the checkpoint saw last
+    if (frameOffset != 0) {
+        if (frameOffset < FileHeaderSize || frameOffset + FrameHeaderSize > covered || !file.seek(frameOffset)
+            || file.read(FrameHeaderSize) != frameHeader
+            || frameOffset + FrameHeaderSize + qFromLittleEndian<quint32>(frameHeader.constData()) != covered) {
+            qDebug() << "Ignoring key checkpoint of" << path << ", it belongs to another version of the file";
+            return false;
+        }
+    }
+    else if (covered != FileHeaderSize) {
+        return false;
+    }
+
+    QHash<QString, Table> loaded;
+    const quint32 tableCount = reader.u32();
+    for (quint32 t = 0; t < tableCount && reader.ok; ++t) {
+        Table& table = loaded[QString::fromUtf8(reader.bytes(reader.u16()))];
+        const quint32 rowCount = reader.u32();
+        table.rows.reserve(qMin<qsizetype>(rowCount, payload.size()));
+        for (quint32 r = 0; r < rowCount && reader.ok; ++r) {
+            const QByteArray key = reader.bytes(reader.u32());
+            Location location;
+            location.offset = static_cast<qint64>(reader.u64());
+            location.size = reader.u32();
+            location.recordSize = reader.u32();
+            if (location.offset < FileHeaderSize || location.offset + location.size > covered) {
+                reader.ok = false; // Would read outside the part of the file it describes
+            }
+            table.rows.insert(key, location);
+        }
+    }
+    if (!reader.ok || reader.position != payload.size()) {
+        qDebug() << "Ignoring malformed key checkpoint of" << path;
+        return false;
+    }
+
+    tables = std::move(loaded);
+    deadBytes = dead;
+    lastFrameOffset = frameOffset;
+    position = covered;
+    return true;
+}
+
+/**
+ * @brief Writes the key checkpoint of the open file. The caller holds the mutex.
+ *
+ * Written through QSaveFile, so a crash leaves the old checkpoint or the new
+ * one. It needs no sync: a checkpoint that is lost or torn fails its checks and
+ * the next open replays the whole log instead.
+ *
+ * @return True if the checkpoint was written.
+ */
+bool StorageEngine::writeCheckpointLocked() {
+    if (!file.isOpen()) {
+        return false;
+    }
+
+    QByteArray frameHeader(FrameHeaderSize, '\0');
+    if (lastFrameOffset != 0 && (!file.seek(lastFrameOffset) || (frameHeader = file.read(FrameHeaderSize)).size() != FrameHeaderSize)) {
+        return false;
+    }
+
+    QByteArray payload;
+    appendLE64(payload, static_cast<quint64>(file.size()));
+    appendLE64(payload, static_cast<quint64>(lastFrameOffset));
+    payload.append(frameHeader);
+    appendLE64(payload, static_cast<quint64>(deadBytes));
+    appendLE32(payload, static_cast<quint32>(tables.size()));
+    for (auto table = tables.constBegin(); table != tables.constEnd(); ++table) {
+        const QByteArray tableName = table.key().toUtf8();
+        appendLE16(payload, static_cast<quint16>(tableName.size()));
+        payload.append(tableName);
+        appendLE32(payload, static_cast<quint32>(table->rows.size()));
+        for (auto row = table->rows.constBegin(); row != table->rows.constEnd(); ++row) {
+            appendLE32(payload, static_cast<quint32>(row.key().size()));
+            payload.append(row.key());
+            appendLE64(payload, static_cast<quint64>(row->offset));
+            appendLE32(payload, row->size);
+            appendLE32(payload, row->recordSize);
+        }
+    }
+
+    QByteArray header(CheckpointMagic, sizeof(CheckpointMagic));
+    appendLE32(header, crc32(payload));
+    QSaveFile checkpoint(checkpointPathOf(filePath));
+    if (!checkpoint.open(QIODevice::WriteOnly) || checkpoint.write(header) != header.size()
+        || checkpoint.write(payload) != payload.size() || !checkpoint.commit()) {
+        qDebug() << "Error: Unable to write the key checkpoint of" << filePath << ":" << checkpoint.errorString();
+        return false;
+    }
+    framesSinceCheckpoint = 0;
+    return true;
+}
+
+/**
+ * @brief Writes a transaction to the log and applies it.
+ *
+ * The whole transaction goes into one frame that is appended and synced before
+ * anything changes in memory. If the write fails, the partial frame is cut off again.
+ *
+ * The frame is encoded before the mutex is taken. Inserts are checked under the
+ * mutex, since every writer holds it; only if one of them has to be left out is
+ * the frame encoded again without it.
+ *
+ * @param transaction The operations to commit together.
+ * @param skipped Receives the positions of the inserts left out, in queue order, if not null.
+ * @return True if the transaction reached the disk, false otherwise (nothing is applied).
+ */
+bool StorageEngine::commit(const Transaction& transaction, QVector<qsizetype>* skipped) {
+    if (skipped) {
+        skipped->clear();
+    }
+    if (transaction.isEmpty()) {
+        return true;
+    }
+
+    // Encodes the operations whose position is not in the sorted list of left out ones
+    auto encode = [&transaction](const QVector<qsizetype>& leftOut) {
+        QByteArray operations;
+        quint32 operationCount = 0;
+        auto next = leftOut.constBegin();
+        for (qsizetype i = 0; i < transaction.operations.size(); ++i) {
+            if (next != leftOut.constEnd() && *next == i) {
+                ++next;
+                continue;
+            }
+            const Transaction::Operation& operation = transaction.operations[i];
+            encodeOperation(operations, operation.table.toUtf8(), operation.key,
+                operation.remove ? nullptr : &operation.value);
+            operationCount++;
+        }
+        return operationCount > 0 ? encodeFrame(operationCount, operations) : QByteArray();
+    };
+    QByteArray frame = encode(QVector<qsizetype>());
+
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        qDebug() << "Error: No database open";
+        return false;
+    }
+
+    QVector<qsizetype> existing;
+    for (qsizetype i = 0; i < transaction.operations.size(); ++i) {
+        const Transaction::Operation& operation = transaction.operations[i];
+        if (operation.onlyIfAbsent) {
+            const auto tableIt = tables.constFind(operation.table);
+            if (tableIt != tables.constEnd() && tableIt->rows.contains(operation.key)) {
+                existing.append(i);
+            }
+        }
+    }
+    if (skipped) {
+        *skipped = existing;
+    }
+    if (!existing.isEmpty()) {
+        frame = encode(existing);
+        if (frame.isEmpty()) {
+            return true; // Every operation was an insert of an existing row
+        }
+    }
+
+    const qint64 frameOffset = file.size();
+    if (!file.seek(frameOffset) || file.write(frame) != frame.size() || !syncToDisk(file)) {
+        qDebug() << "Error: Unable to write to database" << filePath << ":" << file.errorString();
+        file.resize(frameOffset); // A half-written frame would be dropped at the next open anyway
+        return false;
+    }
+
+    {
+        // Readers of the index only wait for the in-memory update, not for the sync above
+        QWriteLocker indexLocker(&indexLock);
+        applyFrame(frame.mid(FrameHeaderSize), frameOffset + FrameHeaderSize, true);
+    }
+    lastFrameOffset = frameOffset;
+    framesSinceCheckpoint++;
+
+    // Rewrite the file once more than half of it is rows nobody can read any more
+    if (deadBytes >= CompactMinBytes && deadBytes * 2 > file.size()) {
+        compactLocked();
+    }
+    return true;
+}
+
+/**
+ * @brief Stores one value in its own transaction.
+ * @param table The table.
+ * @param key The row key.
+ * @param value The value.
+ * @return True if the value reached the disk, false otherwise.
+ */
+bool StorageEngine::put(const QString& table, const QByteArray& key, const QByteArray& value) {
+    Transaction transaction;
+    transaction.put(table, key, value);
+    return commit(transaction);
+}
+
+/**
+ * @brief Removes one row in its own transaction.
+ * @param table The table.
+ * @param key The row key.
+ * @return True if the removal reached the disk, false otherwise.
+ */
+bool StorageEngine::remove(const QString& table, const QByteArray& key) {
+    Transaction transaction;
+    transaction.remove(table, key);
+    return commit(transaction);
+}
+
+/**
+ * @brief Reads a value.
+ * @param table The table.
+ * @param key The row key.
+ * @param value Receives the value.
+ * @return True if the row exists and could be read, false otherwise.
+ */
+bool StorageEngine::get(const QString& table, const QByteArray& key, QByteArray& value) {
+    // A key that does not exist is answered from the index alone, without waiting for the mutex
+    if (!contains(table, key)) {
+        return false;
+    }
+
+    // Look it up again under the mutex: a commit or compaction may have changed it in between
+    QMutexLocker locker(&mutex);
+    const auto tableIt = tables.constFind(table);
+    if (tableIt == tables.constEnd()) {
+        return false;
+    }
+    const auto rowIt = tableIt->rows.constFind(key);
+    return rowIt != tableIt->rows.constEnd() && readValue(*rowIt, value);
+}
+
+/**
+ * @brief Checks whether a row exists, without reading its value.
+ * @param table The table.
+ * @param key The row key.
+ * @return True if the row exists.
+ */
+bool StorageEngine::contains(const QString& table, const QByteArray& key) const {
+    QReadLocker indexLocker(&indexLock);
+    const auto tableIt = tables.constFind(table);
+    return tableIt != tables.constEnd() && tableIt->rows.contains(key);
+}
+
+/**
+ * @brief Gets the keys of every row of a table.
+ * @param table The table.
+ * @return The keys, in no particular order.
+ */
+QList<QByteArray> StorageEngine::keys(const QString& table) const {
+    QReadLocker indexLocker(&indexLock);
+    const auto tableIt = tables.constFind(table);
+    return tableIt != tables.constEnd() ? tableIt->rows.keys() : QList<QByteArray>();
+}
+
+/**
+ * @brief Gets the number of rows of a table.
+ * @param table The table.
+ * @return The row count.
+ */
+qsizetype StorageEngine::count(const QString& table) const {
+    QReadLocker indexLocker(&indexLock);
+    const auto tableIt = tables.constFind(table);
+    return tableIt != tables.constEnd() ? tableIt->rows.size() : 0;
+}
+
+/**
+ * @brief Rewrites the file with only the live rows.
+ * @return True if the file was compacted, false otherwise (the old file stays in use).
+ */
+bool StorageEngine::compact() {
+    QMutexLocker locker(&mutex);
+    return compactLocked();
+}
+
+/**
+ * @brief Applies one decoded frame to the in-memory index. The caller holds the mutex and the index write lock.
+ *
+ * Only value locations are kept; the values themselves stay in the file.
+ *
+ * @param payload The frame payload.
+ * @param payloadOffset File offset of the payload.
+ * @param live Whether the frame was just committed: its values are cached.
+ * @return False if the payload is malformed.
+ */
+bool StorageEngine::applyFrame(const QByteArray& payload, qint64 payloadOffset, bool live) {
+    PayloadReader reader{ payload };
+    const quint32 operationCount = reader.u32();
+
+    // Decode everything first, so a malformed frame changes nothing
+    struct Decoded {
+        quint8 kind;
+        QString table;
+        QByteArray key;
+        Location location;
+    };
+    QVector<Decoded> decoded;
+    decoded.reserve(qMin<quint32>(operationCount, static_cast<quint32>(payload.size())));
+    for (quint32 i = 0; i < operationCount && reader.ok; ++i) {
+        const qsizetype recordStart = reader.position;
+        Decoded operation;
+        operation.kind = reader.u8();
+        const QByteArray table = reader.bytes(reader.u16());
+        operation.table = QString::fromUtf8(table);
+        operation.key = reader.bytes(reader.u32());
+        if (operation.kind == PutOperation) {
+            operation.location.size = reader.u32();
+            operation.location.offset = payloadOffset + reader.position;
+            reader.has(operation.location.size);
+            reader.position += operation.location.size;
+        }
+        else if (operation.kind != RemoveOperation) {
+            reader.ok = false;
+        }
+        operation.location.recordSize = static_cast<quint32>(reader.position - recordStart);
+        decoded.append(operation);
+    }
+    if (!reader.ok || reader.position != payload.size()) {
+        return false;
+    }
+
+    for (const Decoded& operation : decoded) {
+        Table& table = tables[operation.table];
+        const auto existing = table.rows.constFind(operation.key);
+        if (existing != table.rows.constEnd()) {
+            deadBytes += existing->recordSize; // The old value can no longer be read
+            valueCache.remove(existing->offset);
+        }
+
+        if (operation.kind == RemoveOperation) {
+            table.rows.remove(operation.key);
+            deadBytes += operation.location.recordSize; // The remove record itself is only needed until a compaction
+            continue;
+        }
+
+        table.rows.insert(operation.key, operation.location);
+        if (live) {
+            const QByteArray value = payload.mid(operation.location.offset - payloadOffset, operation.location.size);
+            valueCache.insert(operation.location.offset, new QByteArray(value), qMax<qsizetype>(1, value.size()));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a value. The caller holds the mutex.
+ *
+ * Served from the cache when possible; otherwise read from the file and cached.
+ *
+ * @param location Where the value is stored.
+ * @param value Receives the value.
+ * @return True if the value could be read.
+ */
+bool StorageEngine::readValue(const Location& location, QByteArray& value) {
+    if (const QByteArray* cached = valueCache.object(location.offset)) {
+        value = *cached;
+        return true;
+    }
+    if (!file.seek(location.offset)) {
+        return false;
+    }
+    value = file.read(location.size);
+    if (value.size() != static_cast<qsizetype>(location.size)) {
+        qDebug() << "Error: Unable to read from database" << filePath << ":" << file.errorString();
+        return false;
+    }
+    valueCache.insert(location.offset, new QByteArray(value), qMax<qsizetype>(1, value.size()));
+    return true;
+}
+
+/**
+ * @brief Rewrites the file with only the live rows. The caller holds the mutex.
+ *
+ * The live rows are written to a new file through QSaveFile, in frames of about
+ * CompactFrameBytes, and the new file then replaces the old one and is opened in
+ * its place. If anything fails, the old file stays as it was.
+ *
+ * @return True if the file was compacted.
+ */
+bool StorageEngine::compactLocked() {
+    if (!file.isOpen()) {
+        return false;
+    }
+    const QString path = filePath;
+    const qint64 oldSize = file.size();
+
+    QSaveFile newFile(path);
+    if (!newFile.open(QIODevice::WriteOnly)) {
+        qDebug() << "Error: Unable to compact database" << path << ":" << newFile.errorString();
+        return false;
+    }
+    QByteArray header(DatabaseMagic, sizeof(DatabaseMagic));
+    appendLE32(header, Version);
+    bool written = newFile.write(header) == header.size();
+
+    QByteArray operations;
+    quint32 operationCount = 0;
+    auto writeFrame = [&]() {
+        if (operationCount > 0) {
+            const QByteArray frame = encodeFrame(operationCount, operations);
+            written = written && newFile.write(frame) == frame.size();
+            operations.resize(0);
+            operationCount = 0;
+        }
+    };
+
+    for (auto table = tables.constBegin(); table != tables.constEnd() && written; ++table) {
+        const QByteArray tableName = table.key().toUtf8();
+        for (auto row = table->rows.constBegin(); row != table->rows.constEnd() && written; ++row) {
+            QByteArray value;
+            written = readValue(row.value(), value);
+            encodeOperation(operations, tableName, row.key(), &value);
+            operationCount++;
+            if (operations.size() >= CompactFrameBytes) {
+                writeFrame();
+            }
+        }
+    }
+    writeFrame();
+
+    if (!written) {
+        qDebug() << "Error: Unable to compact database" << path << ":" << newFile.errorString();
+        newFile.cancelWriting();
+        return false;
+    }
+
+    // The old file must be closed before it can be replaced on every platform. Its checkpoint goes
+    // first: the new file has other offsets, and reopening the old one if the replace fails replays it all
+    QFile::remove(checkpointPathOf(path));
+    framesSinceCheckpoint = 0;
+    QWriteLocker indexLocker(&indexLock); // Readers wait for the reopened index rather than see an empty one
+    closeLocked();
+    const bool committed = newFile.commit();
+    if (!committed) {
+        qDebug() << "Error: Unable to replace database" << path << ":" << newFile.errorString();
+    }
+    if (!openLocked(path)) {
+        return false;
+    }
+    if (framesSinceCheckpoint > 0) {
+        writeCheckpointLocked(); // The next open of the compacted file replays nothing
+    }
+    if (committed) {
+        qDebug() << "Compacted database" << path << "from" << oldSize << "to" << file.size() << "bytes";
+    }
+    return committed;
+}
@@ -0,0 +1,311 @@
+#ifndef STORAGEENGINE_H
+#define STORAGEENGINE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class StorageEngine
+ * @brief Embedded, crash-safe key-value store kept in a single file.
+ *
+ * Data is organised in tables of (key, value) byte strings. The file is a
+ * write-ahead log and the database at the same time:
+ * - An 8-byte magic "NPKVDB01" and a little-endian quint32 format version.
+ * - One frame per committed transaction: its payload length and CRC-32, then the
+ *   payload with the operation count and every put or remove of the transaction.
+ *
+ * A commit appends one frame and syncs it to disk, so a write costs the size of
+ * the change instead of a rewrite of the whole data set. When the file is opened
+ * the frames are replayed into an in-memory index of where each live value is
+ * stored; a frame cut off by a crash fails its length or checksum test and is
+ * dropped as a whole, so a transaction is either fully there or not at all. A
+ * damaged frame that valid frames still follow was not the last write, so the
+ * file is not opened and left as it is rather than lose the later commits.
+ *
+ * Next to the file, <file>.keys holds a checkpoint of that index: every live
+ * key with the location of its value, up to a point in the log. Opening the file
+ * loads the checkpoint and replays only the frames written after it, so startup
+ * reads the keys but none of the values they cover. Without a usable checkpoint
+ * every frame is read once to check its checksum. A checkpoint is written when
+ * the file is closed, after a compaction, and after an open had to replay many
+ * frames; losing it only makes the next open slower.
+ *
+ * Values are read only when asked for, and kept in a size-bounded LRU cache. Once
+ * enough of the file is taken by overwritten or removed rows, it is compacted
+ * into a new file that only holds the live rows.
+ *
+ * Rows are only found by table and key; there are no secondary indexes, since
+ * nothing looks a row up by its value.
+ *
+ * All methods are safe to call from several threads. The key index has a
+ * read-write lock of its own: contains(), keys(), count() and a get() of a key
+ * that does not exist only take it for reading, so they run side by side and
+ * never wait for a commit's disk sync or for reads of other values.
+ */
+class StorageEngine {
+public:
+    static constexpr quint32 Version = 1;                     ///< Format version written to new files.
+    static constexpr qint64 CacheBytes = 8 * 1024 * 1024;     ///< Value bytes kept in the read cache.
+    static constexpr qint64 CompactMinBytes = 1024 * 1024;   ///< Dead bytes needed before a compaction is considered.
+    static constexpr qint64 CompactFrameBytes = 1024 * 1024; ///< Payload size of the frames a compaction writes.
+    static constexpr int CheckpointAfterFrames = 1024;       ///< Frames replayed at open before a new checkpoint is written.
+
+    /**
+     * @class StorageEngine::Transaction
+     * @brief Puts and removes that are committed together.
+     */
+    class Transaction {
+    public:
+        /**
+         * @brief Stores a value, replacing the current one.
+         * @param table The table.
+         * @param key The row key.
+         * @param value The value.
+         */
+        void put(const QString& table, const QByteArray& key, const QByteArray& value);
+
+        /**
+         * @brief Stores a value only if the row does not exist yet when the transaction is committed.
+         *
+         * The check happens under the engine's mutex together with the write, so
+         * two callers cannot both insert the same row.
+         *
+         * @param table The table.
+         * @param key The row key.
+         * @param value The value.
+         */
+        void insert(const QString& table, const QByteArray& key, const QByteArray& value);
+
+        /**
+         * @brief Removes a row.
+         * @param table The table.
+         * @param key The row key.
+         */
+        void remove(const QString& table, const QByteArray& key);
+
+        /**
+         * @brief Gets the number of operations queued.
+         * @return The operation count.
+         */
+        qsizetype size() const;
+
+        /**
+         * @brief Checks whether the transaction has no operations.
+         * @return True if nothing is queued.
+         */
+        bool isEmpty() const;
+
+    private:
+        friend class StorageEngine;
+
+        /**
+         * @brief One queued put or remove.
+         */
+        struct Operation {
+            bool remove = false;  // Remove instead of put.
+            bool onlyIfAbsent = false; // Put only if the row does not exist at commit time.
+            QString table;        // Table of the row.
+            QByteArray key;       // Row key.
+            QByteArray value;     // New value, empty for removes.
+        };
+
+        QVector<Operation> operations; // In the order they were queued.
+    };
+
+    /**
+     * @brief Gets the engine the application stores its data in, opened on first use.
+     * @return The engine for data/noomyplan.db.
+     */
+    static StorageEngine& instance();
+
+    /**
+     * @brief Creates an engine that is not attached to a file yet.
+     */
+    StorageEngine();
+
+    /**
+     * @brief Closes the file.
+     */
+    ~StorageEngine();
+
+    /**
+     * @brief Opens a database file, creating it if needed, and replays its log.
+     *
+     * Only the frames after the key checkpoint are replayed. A damaged frame at
+     * the end of the file is cut off; one that valid frames follow fails the open.
+     *
+     * @param path The database file.
+     * @return True if the file could be opened, is a database of this version and is not damaged before its end.
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief Writes a key checkpoint if the log grew since the last one, closes the file and forgets its rows.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether a database file is open.
+     * @return True if open() succeeded and close() was not called since.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Writes a transaction to the log and applies it.
+     *
+     * Inserts whose row exists at that moment are left out; the rest of the
+     * transaction is still committed.
+     *
+     * @param transaction The operations to commit together.
+     * @param skipped Receives the positions of the inserts left out, in queue order, if not null.
+     * @return True if the transaction reached the disk, false otherwise (nothing is applied).
+     */
+    bool commit(const Transaction& transaction, QVector<qsizetype>* skipped = nullptr);
+
+    /**
+     * @brief Stores one value in its own transaction.
+     * @param table The table.
+     * @param key The row key.
+     * @param value The value.
+     * @return True if the value reached the disk, false otherwise.
+     */
+    bool put(const QString& table, const QByteArray& key, const QByteArray& value);
+
+    /**
+     * @brief Removes one row in its own transaction.
+     * @param table The table.
+     * @param key The row key.
+     * @return True if the removal reached the disk, false otherwise.
+     */
+    bool remove(const QString& table, const QByteArray& key);
+
+    /**
+     * @brief Reads a value.
+     * @param table The table.
+     * @param key The row key.
+     * @param value Receives the value.
+     * @return True if the row exists and could be read, false otherwise.
+     */
+    bool get(const QString& table, const QByteArray& key, QByteArray& value);
+
+    /**
+     * @brief Checks whether a row exists, without reading its value.
+     * @param table The table.
+     * @param key The row key.
+     * @return True if the row exists.
+     */
+    bool contains(const QString& table, const QByteArray& key) const;
+
+    /**
+     * @brief Gets the keys of every row of a table.
+     * @param table The table.
+     * @return The keys, in no particular order.
+     */
+    QList<QByteArray> keys(const QString& table) const;
+
+    /**
+     * @brief Gets the number of rows of a table.
+     * @param table The table.
+     * @return The row count.
+     */
+    qsizetype count(const QString& table) const;
+
+    /**
+     * @brief Rewrites the file with only the live rows.
+     * @return True if the file was compacted, false otherwise (the old file stays in use).
+     */
+    bool compact();
+
+private:
+    /**
+     * @brief Where a live value is stored.
+     */
+    struct Location {
+        qint64 offset = 0;      // File offset of the value bytes.
+        quint32 size = 0;       // Value size in bytes.
+        quint32 recordSize = 0; // Size of the whole put record, counted as dead once replaced.
+    };
+
+    /**
+     * @brief The live rows of one table.
+     */
+    struct Table {
+        QHash<QByteArray, Location> rows;   // Row key -> stored value.
+    };
+
+    /**
+     * @brief Opens a file and replays it. The caller holds the mutex and the index write lock.
+     * @param path The database file.
+     * @return True on success.
+     */
+    bool openLocked(const QString& path);
+
+    /**
+     * @brief Writes a key checkpoint if needed, closes the file and forgets its rows. The caller holds the mutex and the index write lock.
+     */
+    void closeLocked();
+
+    /**
+     * @brief Gets the key checkpoint file of a database file.
+     * @param path The database file.
+     * @return The checkpoint file.
+     */
+    static QString checkpointPathOf(const QString& path);
+
+    /**
+     * @brief Loads the key checkpoint of the file being opened. The caller holds the mutex and the index write lock.
+     * @param path The database file.
+     * @param fileSize Size of the database file.
+     * @param position Receives the file offset the checkpoint covers, where replaying continues.
+     * @return True if a checkpoint matching the file was loaded, false otherwise (nothing is loaded).
+     */
+    bool loadCheckpointLocked(const QString& path, qint64 fileSize, qint64& position);
+
+    /**
+     * @brief Writes the key checkpoint of the open file. The caller holds the mutex.
+     * @return True if the checkpoint was written.
+     */
+    bool writeCheckpointLocked();
+
+    /**
+     * @brief Applies one decoded frame to the in-memory index. The caller holds the mutex and the index write lock.
+     * @param payload The frame payload.
+     * @param payloadOffset File offset of the payload.
+     * @param live Whether the frame was just committed: its values are cached.
+     * @return False if the payload is malformed.
+     */
+    bool applyFrame(const QByteArray& payload, qint64 payloadOffset, bool live);
+
+    /**
+     * @brief Reads a value. The caller holds the mutex.
+     * @param location Where the value is stored.
+     * @param value Receives the value.
+     * @return True if the value could be read.
+     */
+    bool readValue(const Location& location, QByteArray& value);
+
+    /**
+     * @brief Rewrites the file with only the live rows. The caller holds the mutex.
+     * @return True if the file was compacted.
+     */
+    bool compactLocked();
+
+    mutable QMutex mutex;                                       // Guards everything below; held by everything that changes tables.
+    mutable QReadWriteLock indexLock;                           // Guards tables for readers that do not hold the mutex.
+    QString filePath;                                           // The open database file.
+    QFile file;                                                 // Database file, open for reading and appending.
+    QHash<QString, Table> tables;                               // Live rows by table; changed only with the mutex and indexLock held.
+    QCache<qint64, QByteArray> valueCache;                      // Recently read values by file offset.
+    qint64 deadBytes = 0;                                       // Bytes of replaced or removed rows in the file.
+    qint64 lastFrameOffset = 0;                                 // File offset of the last frame, 0 if there is none.
+    int framesSinceCheckpoint = 0;                              // Frames the key checkpoint does not cover.
+};
+
+#endif // STORAGEENGINE_H
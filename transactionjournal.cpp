@@ -0,0 +1,407 @@
+#include "transactionjournal.h"
+#include "ledgersnapshot.h"
+#include <QDebug>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPromise>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <memory>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @class transactionjournal.cpp
+ * @brief Implements the append-only journal and background compaction of a user's ledger.
+ */
+
+/**
+ * @brief Creates a journal that is not attached to a user yet.
+ * @param parent Parent QObject.
+ */
+TransactionJournal::TransactionJournal(QObject* parent) : QObject(parent) {
+    // One timer per batch: the first append arms it, the timeout writes and syncs everything queued since
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(FlushDelayMs);
+    connect(&flushTimer, &QTimer::timeout, this, [this]() { flush(); });
+    connect(&compactionWatcher, &QFutureWatcher<qint64>::finished, this, &TransactionJournal::onCompactionFinished);
+}
+
+/**
+ * @brief Flushes pending records and waits for a running compaction.
+ */
+TransactionJournal::~TransactionJournal() {
+    close();
+}
+
+/**
+ * @brief Loads a user's ledger: the snapshot first, then the journal replayed on top.
+ *
+ * A damaged snapshot leaves the ledger empty and the user detached: the journal
+ * only holds the changes made after that snapshot, so neither appending to it
+ * nor compacting it over the damaged file would be safe.
+ *
+ * @param userId The user whose files are loaded.
+ * @param ledger The ledger to fill.
+ * @return True if the ledger was loaded and the journal could be opened for appending, false otherwise.
+ */
+bool TransactionJournal::load(const QString& userId, CashflowTracking& ledger) {
+    close(); // Finish with the previous user first
+    tracking = &ledger;
+    damagedSnapshot = false;
+
+    QDir().mkpath("data");
+    snapshotPath = "data/" + userId + "_transactions.snapshot";
+    legacySnapshotPath = "data/" + userId + "_transactions.json";
+    journalPath = "data/" + userId + "_transactions.journal";
+
+    bool endsWithNewline = true;
+    journalRecords = replay(snapshotPath, legacySnapshotPath, journalPath, -1, *tracking, &endsWithNewline);
+    if (journalRecords < 0) {
+        qDebug() << "Error: Snapshot" << snapshotPath << "is damaged; the ledger is not loaded and the file is left as it is";
+        journalRecords = 0;
+        damagedSnapshot = true;
+        tracking = nullptr; // No appends and no compaction until the snapshot is repaired
+        return false;
+    }
+    compactionThreshold = CompactAfterRecords;
+
+    journalFile.setFileName(journalPath);
+    if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Error: Unable to open journal" << journalPath << ":" << journalFile.errorString();
+        return false;
+    }
+    if (!endsWithNewline) {
+        pending.append('\n'); // Keep the next record off the damaged line
+    }
+
+    qDebug() << "Loaded" << tracking->entryCount() << "transactions, replayed" << journalRecords
+        << "journal records";
+    return true;
+}
+
+/**
+ * @brief Flushes pending records and detaches from the current user.
+ */
+void TransactionJournal::close() {
+    if (compactionRunning) {
+        // Let the snapshot finish and cut the journal before the files change hands
+        compactionWatcher.waitForFinished();
+        onCompactionFinished();
+    }
+    flush();
+    if (journalFile.isOpen()) {
+        journalFile.close();
+    }
+    pending.clear();
+    tracking = nullptr;
+}
+
+/**
+ * @brief Tells whether the last load() stopped at a damaged snapshot.
+ * @return True if the snapshot exists but could not be read.
+ */
+bool TransactionJournal::snapshotDamaged() const {
+    return damagedSnapshot;
+}
+
+/**
+ * @brief Records an added transaction.
+ * @param entry The transaction as stored in the ledger, with its ID.
+ * @return True if the record was queued, false otherwise.
+ */
+bool TransactionJournal::appendAdd(const DataEntry& entry) {
+    QJsonObject record = toJson(entry);
+    record["op"] = "add";
+    return appendRecord(record);
+}
+
+/**
+ * @brief Records a removed transaction.
+ * @param transID The ID of the removed transaction.
+ * @return True if the record was queued, false otherwise.
+ */
+bool TransactionJournal::appendRemove(int transID) {
+    QJsonObject record;
+    record["op"] = "remove";
+    record["id"] = transID;
+    return appendRecord(record);
+}
+
+/**
+ * @brief Records a changed transaction.
+ * @param entry The transaction after the change, with its ID.
+ * @return True if the record was queued, false otherwise.
+ */
+bool TransactionJournal::appendUpdate(const DataEntry& entry) {
+    QJsonObject record = toJson(entry); // The whole entry, so replaying it twice gives the same result
+    record["op"] = "update";
+    return appendRecord(record);
+}
+
+/**
+ * @brief Queues one record and arms the batch timer.
+ *
+ * Costs the same no matter how many transactions the ledger holds.
+ *
+ * @param record The record to append.
+ * @return True if the record was queued, false otherwise.
+ */
+bool TransactionJournal::appendRecord(const QJsonObject& record) {
+    if (tracking == nullptr) {
+        return false; // No user loaded
+    }
+    if (!journalFile.isOpen() && !journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        // Opening failed on load or after a compaction; try again now rather than drop the change silently
+        qDebug() << "Error: Unable to open journal" << journalPath << ":" << journalFile.errorString();
+        return false;
+    }
+
+    pending.append(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    pending.append('\n');
+    journalRecords++;
+
+    if (!flushTimer.isActive()) {
+        flushTimer.start(); // Later appends ride along with this batch
+    }
+    if (journalRecords >= compactionThreshold) {
+        compact();
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the pending records and syncs them to disk now.
+ * @return True if everything reached the disk, false otherwise.
+ */
+bool TransactionJournal::flush() {
+    flushTimer.stop();
+    if (pending.isEmpty() || !journalFile.isOpen()) {
+        return true;
+    }
+
+    bool written = journalFile.write(pending) == pending.size();
+    bool synced = written && syncToDisk(journalFile);
+    if (!synced) {
+        qDebug() << "Error: Unable to write journal" << journalPath << ":" << journalFile.errorString();
+        return false; // Keep the records queued and try again with the next batch
+    }
+    pending.clear();
+    return true;
+}
+
+/**
+ * @brief Starts writing a fresh snapshot in the background.
+ *
+ * The ledger in memory is neither copied nor read: the worker rebuilds it from
+ * the files, which hold the same state up to journalOffset once the pending
+ * records are flushed. It writes a binary LedgerSnapshot through QSaveFile,
+ * which only replaces the old snapshot once the new one is complete.
+ */
+void TransactionJournal::compact() {
+    if (tracking == nullptr || compactionRunning) {
+        return;
+    }
+
+    if (!flush()) {
+        compactionThreshold = journalRecords + CompactAfterRecords; // The disk is failing, do not retry on every append
+        return;
+    }
+    const qint64 journalOffset = journalFile.size(); // Everything before this is on disk now
+    const QString snapshot = snapshotPath;
+    const QString legacySnapshot = legacySnapshotPath;
+    const QString journal = journalPath;
+
+    auto promise = std::make_shared<QPromise<qint64>>();
+    compactionWatcher.setFuture(promise->future());
+    compactionRunning = true;
+    promise->start();
+
+    QThreadPool::globalInstance()->start([promise, snapshot, legacySnapshot, journal, journalOffset]() {
+        CashflowTracking ledger;
+        // A snapshot damaged since the load is not overwritten with what the journal alone holds
+        bool saved = replay(snapshot, legacySnapshot, journal, journalOffset, ledger) >= 0
+            && LedgerSnapshot::write(snapshot, ledger);
+        promise->addResult(saved ? journalOffset : -1);
+        promise->finish();
+    });
+}
+
+/**
+ * @brief Handles the end of a background snapshot, once.
+ */
+void TransactionJournal::onCompactionFinished() {
+    if (!compactionRunning) {
+        return; // Already handled by close()
+    }
+    compactionRunning = false;
+
+    qint64 journalOffset = compactionWatcher.result();
+    if (journalOffset < 0) {
+        // Try again only after another full batch of records, not on the very next append
+        compactionThreshold = journalRecords + CompactAfterRecords;
+        qDebug() << "Error: Unable to write snapshot" << snapshotPath << ", keeping the full journal";
+        return;
+    }
+    compactionThreshold = CompactAfterRecords;
+    finishCompaction(journalOffset);
+}
+
+/**
+ * @brief Cuts the journal down once a snapshot has been written.
+ *
+ * Records appended while the snapshot was written are past journalOffset and
+ * are kept; everything before it is in the snapshot now.
+ *
+ * @param journalOffset Journal size when the snapshot copy was taken.
+ */
+void TransactionJournal::finishCompaction(qint64 journalOffset) {
+    flush();
+    journalFile.close();
+
+    QByteArray tail;
+    QFile oldJournal(journalPath);
+    if (oldJournal.open(QIODevice::ReadOnly)) {
+        oldJournal.seek(journalOffset);
+        tail = oldJournal.readAll();
+        oldJournal.close();
+    }
+
+    QSaveFile newJournal(journalPath);
+    if (!newJournal.open(QIODevice::WriteOnly) || newJournal.write(tail) != tail.size() || !newJournal.commit()) {
+        qDebug() << "Error: Unable to shorten journal" << journalPath; // Replaying the longer journal is still correct
+    }
+    else {
+        journalRecords = static_cast<int>(tail.count('\n'));
+    }
+
+    if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Error: Unable to reopen journal" << journalPath << ":" << journalFile.errorString();
+    }
+}
+
+/**
+ * @brief Fills a ledger from a snapshot and the journal records written after it.
+ * @param snapshotPath The binary snapshot.
+ * @param legacySnapshotPath The JSON snapshot, read when there is no binary one.
+ * @param journalPath The journal.
+ * @param journalEnd Journal offset to stop at, or -1 to read all of it.
+ * @param ledger The ledger to fill.
+ * @param endsWithNewline Receives whether the last journal record was complete, if not null.
+ * @return The number of journal records replayed, or -1 if the binary snapshot is damaged.
+ */
+int TransactionJournal::replay(const QString& snapshotPath, const QString& legacySnapshotPath, const QString& journalPath,
+    qint64 journalEnd, CashflowTracking& ledger, bool* endsWithNewline) {
+    ledger.clear();
+
+    // The binary snapshot maps in without parsing; users who never got one still have the old JSON file
+    const LedgerSnapshot::ReadResult snapshotRead = LedgerSnapshot::read(snapshotPath, ledger);
+    if (snapshotRead == LedgerSnapshot::ReadResult::Damaged) {
+        // The journal was cut when this snapshot was written, so the JSON file and the journal miss transactions
+        return -1;
+    }
+    QFile snapshot(legacySnapshotPath);
+    if (snapshotRead == LedgerSnapshot::ReadResult::Missing && snapshot.open(QIODevice::ReadOnly)) {
+        QJsonArray transactionsArray = QJsonDocument::fromJson(snapshot.readAll())["transactions"].toArray();
+        for (const QJsonValue& value : transactionsArray) {
+            ledger.restoreData(fromJson(value.toObject()));
+        }
+        snapshot.close();
+    }
+
+    // Replay every change made since the snapshot, in the order it happened
+    int records = 0;
+    bool complete = true;
+    QFile journal(journalPath);
+    if (journal.open(QIODevice::ReadOnly)) {
+        while (!journal.atEnd() && (journalEnd < 0 || journal.pos() < journalEnd)) {
+            QByteArray line = journal.readLine();
+            complete = line.endsWith('\n');
+            line = line.trimmed();
+            if (line.isEmpty()) {
+                continue;
+            }
+
+            QJsonParseError error;
+            QJsonObject record = QJsonDocument::fromJson(line, &error).object();
+            if (error.error != QJsonParseError::NoError) {
+                // Most likely the last write before a crash, cut off half way
+                qDebug() << "Skipping damaged journal record in" << journalPath << ":" << error.errorString();
+                continue;
+            }
+
+            records++;
+            QString operation = record["op"].toString();
+            if (operation == "add") {
+                ledger.restoreData(fromJson(record));
+            }
+            else if (operation == "update") {
+                ledger.updateData(fromJson(record));
+            }
+            else if (operation == "remove") {
+                ledger.removeData(record["id"].toInt());
+            }
+        }
+        journal.close();
+    }
+
+    if (endsWithNewline) {
+        *endsWithNewline = complete;
+    }
+    return records;
+}
+
+/**
+ * @brief Converts a transaction into its JSON form, as used by journal records.
+ * @param entry The transaction.
+ * @return The JSON object.
+ */
+QJsonObject TransactionJournal::toJson(const DataEntry& entry) {
+    QJsonObject obj;
+    obj["id"] = QString::number(entry.transid);
+    obj["datetime"] = QString::fromStdString(entry.dateTime);
+    obj["seller"] = QString::fromStdString(entry.seller);
+    obj["buyer"] = QString::fromStdString(entry.buyer);
+    obj["merchandise"] = QString::fromStdString(entry.merchandise);
+    obj["cost"] = entry.cost.toQString(); // Exact cents, formatted
+    obj["category"] = QString::fromStdString(entry.category);
+    return obj;
+}
+
+/**
+ * @brief Reads a transaction from a journal record or a legacy JSON snapshot.
+ * @param json The JSON object.
+ * @return The transaction.
+ */
+DataEntry TransactionJournal::fromJson(const QJsonObject& json) {
+    DataEntry entry;
+    entry.transid = json["id"].isString() ? json["id"].toString().toInt() : json["id"].toInt();
+    entry.dateTime = json["datetime"].toString().toStdString();
+    entry.seller = json["seller"].toString().toStdString();
+    entry.buyer = json["buyer"].toString().toStdString();
+    entry.merchandise = json["merchandise"].toString().toStdString();
+    entry.cost = Money::fromJson(json["cost"]);
+    entry.category = json["category"].toString().toStdString();
+    return entry;
+}
+
+/**
+ * @brief Flushes a file and asks the OS to write it through to the disk.
+ * @param file The open file.
+ * @return True on success, false otherwise.
+ */
+bool TransactionJournal::syncToDisk(QFile& file) {
+    if (!file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
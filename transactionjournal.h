@@ -0,0 +1,188 @@
+#ifndef TRANSACTIONJOURNAL_H
+#define TRANSACTIONJOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QJsonObject>
+#include <QString>
+#include <QTimer>
+#include "cashflowtracking.h"
+
+/**
+ * @class TransactionJournal
+ * @brief Append-only persistence for a user's cashflow ledger.
+ *
+ * The ledger lives in two files under data/:
+ * - <user>_transactions.snapshot, a full binary LedgerSnapshot that loads by mapping it,
+ * - <user>_transactions.journal, one compact JSON record per line for every add,
+ *   update or remove made since the snapshot was written.
+ * The <user>_transactions.json file older versions wrote is still read when a user
+ * has no binary snapshot yet.
+ *
+ * Saving a change therefore appends one short line instead of rewriting the whole
+ * ledger. Appends are batched: they are written and synced to disk together a few
+ * milliseconds after the first one, or right away by flush().
+ *
+ * Once the journal holds enough records it is compacted. A worker thread loads
+ * the current snapshot, replays the journal up to its present end and writes
+ * the result as a new snapshot; afterwards the journal is cut down to the
+ * records appended in the meantime. The GUI thread copies nothing, it only
+ * notes where the journal ends. Replaying is idempotent, so a crash between
+ * those two steps loses nothing. If the snapshot cannot be written, the next
+ * attempt waits for another CompactAfterRecords records.
+ *
+ * A snapshot that exists but is damaged is never replaced: load() fails and
+ * leaves the file where it is, and nothing is appended or compacted for that user.
+ */
+class TransactionJournal : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int FlushDelayMs = 50;             ///< How long appends are batched before they are synced.
+    static constexpr int CompactAfterRecords = 10000;   ///< Journal length that triggers a compaction.
+
+    /**
+     * @brief Creates a journal that is not attached to a user yet.
+     * @param parent Parent QObject.
+     */
+    explicit TransactionJournal(QObject* parent = nullptr);
+
+    /**
+     * @brief Flushes pending records and waits for a running compaction.
+     */
+    ~TransactionJournal();
+
+    /**
+     * @brief Loads a user's ledger: the snapshot first, then the journal replayed on top.
+     *
+     * The tracking object is cleared first and remembered for later compactions.
+     * The journal is then kept open for appending. If the snapshot is damaged,
+     * the ledger stays empty and no user is attached.
+     *
+     * @param userId The user whose files are loaded.
+     * @param ledger The ledger to fill.
+     * @return True if the ledger was loaded and the journal could be opened for appending, false otherwise.
+     */
+    bool load(const QString& userId, CashflowTracking& ledger);
+
+    /**
+     * @brief Flushes pending records and detaches from the current user.
+     */
+    void close();
+
+    /**
+     * @brief Tells whether the last load() stopped at a damaged snapshot.
+     * @return True if the snapshot exists but could not be read.
+     */
+    bool snapshotDamaged() const;
+
+    /**
+     * @brief Records an added transaction.
+     * @param entry The transaction as stored in the ledger, with its ID.
+     * @return True if the record was queued, false if it could not be journaled.
+     */
+    bool appendAdd(const DataEntry& entry);
+
+    /**
+     * @brief Records a removed transaction.
+     * @param transID The ID of the removed transaction.
+     * @return True if the record was queued, false if it could not be journaled.
+     */
+    bool appendRemove(int transID);
+
+    /**
+     * @brief Records a changed transaction.
+     * @param entry The transaction as stored in the ledger after the change.
+     * @return True if the record was queued, false if it could not be journaled.
+     */
+    bool appendUpdate(const DataEntry& entry);
+
+    /**
+     * @brief Writes the pending records and syncs them to disk now.
+     * @return True if everything reached the disk, false otherwise.
+     */
+    bool flush();
+
+    /**
+     * @brief Starts writing a fresh snapshot in the background.
+     *
+     * Does nothing if a compaction is already running.
+     */
+    void compact();
+
+private:
+    /**
+     * @brief Queues one record and arms the batch timer.
+     *
+     * If the journal is not open, e.g. because reopening it after a compaction
+     * failed, it is opened again first.
+     *
+     * @param record The record to append.
+     * @return True if the record was queued, false if no user is loaded or the journal cannot be opened.
+     */
+    bool appendRecord(const QJsonObject& record);
+
+    /**
+     * @brief Handles the end of a background snapshot, once.
+     */
+    void onCompactionFinished();
+
+    /**
+     * @brief Cuts the journal down once a snapshot has been written.
+     * @param journalOffset Journal size when the snapshot copy was taken.
+     */
+    void finishCompaction(qint64 journalOffset);
+
+    /**
+     * @brief Fills a ledger from a snapshot and the journal records written after it.
+     *
+     * Only reads files, so a worker thread can use it while the journal is appended to.
+     *
+     * @param snapshotPath The binary snapshot.
+     * @param legacySnapshotPath The JSON snapshot, read when there is no binary one.
+     * @param journalPath The journal.
+     * @param journalEnd Journal offset to stop at, or -1 to read all of it.
+     * @param ledger The ledger to fill; it is cleared first.
+     * @param endsWithNewline Receives whether the last journal record was complete, if not null.
+     * @return The number of journal records replayed, or -1 if the binary snapshot is damaged (nothing else is read then).
+     */
+    static int replay(const QString& snapshotPath, const QString& legacySnapshotPath, const QString& journalPath,
+        qint64 journalEnd, CashflowTracking& ledger, bool* endsWithNewline = nullptr);
+
+    /**
+     * @brief Converts a transaction into its JSON form, as used by journal records.
+     * @param entry The transaction.
+     * @return The JSON object.
+     */
+    static QJsonObject toJson(const DataEntry& entry);
+
+    /**
+     * @brief Reads a transaction from a journal record or a legacy JSON snapshot.
+     * @param json The JSON object.
+     * @return The transaction; its ID is 0 if the object has none.
+     */
+    static DataEntry fromJson(const QJsonObject& json);
+
+    /**
+     * @brief Flushes a file and asks the OS to write it through to the disk.
+     * @param file The open file.
+     * @return True on success, false otherwise.
+     */
+    static bool syncToDisk(QFile& file);
+
+    QString snapshotPath;                    // Full binary snapshot of the ledger.
+    QString legacySnapshotPath;              // JSON snapshot written by older versions.
+    QString journalPath;                     // Records appended since the snapshot.
+    QFile journalFile;                       // Journal, open for appending.
+    QByteArray pending;                      // Records not written yet.
+    QTimer flushTimer;                       // Fires once per batch of appends.
+    int journalRecords = 0;                  // Records in the journal since the snapshot.
+    int compactionThreshold = CompactAfterRecords; // Journal length that starts the next compaction.
+    bool compactionRunning = false;          // A snapshot is being written in the background.
+    bool damagedSnapshot = false;            // The last load() found a damaged snapshot.
+    CashflowTracking* tracking = nullptr;    // Ledger being persisted.
+    QFutureWatcher<qint64> compactionWatcher; // Reports the end of a background snapshot.
+};
+
+#endif // TRANSACTIONJOURNAL_H
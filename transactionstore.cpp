@@ -0,0 +1,270 @@
+#include "transactionstore.h"
+#include <QDate>
+
+/**
+ * @class transactionstore.cpp
+ * @brief Implements the dictionary-encoded, columnar transaction store.
+ */
+
+/**
+ * @brief Gets the code of a value, adding it to the dictionary if needed.
+ *
+ * The lookup wraps the view in a raw-data QByteArray, so no copy is made
+ * unless the value is new.
+ *
+ * @param value The raw UTF-8 bytes of the value.
+ * @return The code of the value.
+ */
+quint32 StringDictionary::intern(QByteArrayView value) {
+    const QByteArray key = QByteArray::fromRawData(value.data(), value.size());
+    auto it = codes.constFind(key);
+    if (it != codes.constEnd()) {
+        return it.value(); // Already interned
+    }
+
+    // New value: store an owning copy of the key and its decoded text
+    quint32 code = static_cast<quint32>(values.size());
+    codes.insert(QByteArray(value.data(), value.size()), code);
+    values.append(QString::fromUtf8(value));
+    return code;
+}
+
+/**
+ * @brief Gets the code of a value without adding it.
+ * @param value The raw UTF-8 bytes of the value.
+ * @return The code of the value, or NotFound if it was never interned.
+ */
+quint32 StringDictionary::find(QByteArrayView value) const {
+    return codes.value(QByteArray::fromRawData(value.data(), value.size()), NotFound);
+}
+
+/**
+ * @brief Gets the value stored for a code.
+ * @param code A code returned by intern().
+ * @return The decoded value.
+ */
+QString StringDictionary::value(quint32 code) const {
+    return values.value(code);
+}
+
+/**
+ * @brief Gets the number of distinct values.
+ * @return The dictionary size.
+ */
+int StringDictionary::size() const {
+    return values.size();
+}
+
+/**
+ * @brief Removes every value from the dictionary.
+ */
+void StringDictionary::clear() {
+    codes.clear();
+    values.clear();
+}
+
+/**
+ * @brief Appends one transaction to the store.
+ *
+ * Encodes the date and the low-cardinality fields, and copies the ID and
+ * description into the shared string heap.
+ */
+void TransactionStore::append(QByteArrayView date, QByteArrayView transactionID, QByteArrayView type,
+    QByteArrayView description, Money amount, QByteArrayView paymentMethod, QByteArrayView category) {
+    const qint32 day = parseDate(date);
+    if (day == InvalidDate && !date.isEmpty()) {
+        unparsedDates.insert(size(), date.toByteArray()); // Rare, so kept apart from the packed column
+    }
+    dates.append(day);
+    typeCodes.append(typeDictionary.intern(type));
+    categoryCodes.append(categoryDictionary.intern(category));
+    paymentCodes.append(paymentDictionary.intern(paymentMethod));
+    amounts.append(amount.cents());
+
+    // ID and description are stored back to back; the next row's start ends the description
+    textOffsets.append(textHeap.size());
+    textHeap.append(transactionID.data(), transactionID.size());
+    textOffsets.append(textHeap.size());
+    textHeap.append(description.data(), description.size());
+}
+
+/**
+ * @brief Appends every transaction of another store, keeping their order.
+ * @param other The store to copy the transactions from.
+ */
+void TransactionStore::append(const TransactionStore& other) {
+    // Translation tables from the other store's codes to this store's codes
+    auto remapTable = [](StringDictionary& into, const StringDictionary& from) {
+        QVector<quint32> table(from.size());
+        for (int code = 0; code < from.size(); ++code) {
+            table[code] = into.intern(from.value(code).toUtf8());
+        }
+        return table;
+    };
+    const QVector<quint32> typeMap = remapTable(typeDictionary, other.typeDictionary);
+    const QVector<quint32> categoryMap = remapTable(categoryDictionary, other.categoryDictionary);
+    const QVector<quint32> paymentMap = remapTable(paymentDictionary, other.paymentDictionary);
+
+    // Unparsed dates move with their rows, which come after ours
+    const qsizetype rowShift = size();
+    for (auto it = other.unparsedDates.constBegin(); it != other.unparsedDates.constEnd(); ++it) {
+        unparsedDates.insert(it.key() + rowShift, it.value());
+    }
+
+    reserve(size() + other.size());
+    dates.append(other.dates);
+    amounts.append(other.amounts);
+    for (qsizetype row = 0; row < other.size(); ++row) {
+        typeCodes.append(typeMap[other.typeCodes[row]]);
+        categoryCodes.append(categoryMap[other.categoryCodes[row]]);
+        paymentCodes.append(paymentMap[other.paymentCodes[row]]);
+    }
+
+    // The other heap is copied as one block, so its offsets just shift by our heap size
+    const qint64 heapShift = textHeap.size();
+    textHeap.append(other.textHeap);
+    for (qint64 offset : other.textOffsets) {
+        textOffsets.append(offset + heapShift);
+    }
+}
+
+/**
+ * @brief Reserves room for a number of transactions in every column.
+ * @param rows The expected number of transactions.
+ */
+void TransactionStore::reserve(qsizetype rows) {
+    dates.reserve(rows);
+    typeCodes.reserve(rows);
+    categoryCodes.reserve(rows);
+    paymentCodes.reserve(rows);
+    amounts.reserve(rows);
+    textOffsets.reserve(rows * 2);
+}
+
+/**
+ * @brief Removes all transactions and dictionary values.
+ */
+void TransactionStore::clear() {
+    dates.clear();
+    typeCodes.clear();
+    categoryCodes.clear();
+    paymentCodes.clear();
+    amounts.clear();
+    textHeap.clear();
+    textOffsets.clear();
+    unparsedDates.clear();
+    typeDictionary.clear();
+    categoryDictionary.clear();
+    paymentDictionary.clear();
+}
+
+qsizetype TransactionStore::size() const {
+    return amounts.size();
+}
+
+bool TransactionStore::isEmpty() const {
+    return amounts.isEmpty();
+}
+
+const QVector<qint32>& TransactionStore::dateColumn() const {
+    return dates;
+}
+
+const QVector<quint32>& TransactionStore::typeColumn() const {
+    return typeCodes;
+}
+
+const QVector<quint32>& TransactionStore::categoryColumn() const {
+    return categoryCodes;
+}
+
+const QVector<quint32>& TransactionStore::paymentMethodColumn() const {
+    return paymentCodes;
+}
+
+const QVector<std::int64_t>& TransactionStore::amountColumn() const {
+    return amounts;
+}
+
+const StringDictionary& TransactionStore::types() const {
+    return typeDictionary;
+}
+
+const StringDictionary& TransactionStore::categories() const {
+    return categoryDictionary;
+}
+
+const StringDictionary& TransactionStore::paymentMethods() const {
+    return paymentDictionary;
+}
+
+/**
+ * @brief Gets the transaction ID of a row.
+ * @param row The row index.
+ * @return A view into the string heap.
+ */
+QByteArrayView TransactionStore::transactionID(qsizetype row) const {
+    qint64 start = textOffsets[row * 2];
+    qint64 end = textOffsets[row * 2 + 1];
+    return QByteArrayView(textHeap.constData() + start, end - start);
+}
+
+/**
+ * @brief Gets the description of a row.
+ * @param row The row index.
+ * @return A view into the string heap.
+ */
+QByteArrayView TransactionStore::description(qsizetype row) const {
+    qint64 start = textOffsets[row * 2 + 1];
+    qint64 end = (row + 1 < size()) ? textOffsets[(row + 1) * 2] : textHeap.size();
+    return QByteArrayView(textHeap.constData() + start, end - start);
+}
+
+/**
+ * @brief Gets the original text of a date that could not be parsed.
+ * @param row The row index.
+ * @return The date as it was appended, empty if the row has a valid or empty date.
+ */
+QByteArray TransactionStore::unparsedDate(qsizetype row) const {
+    return unparsedDates.value(row);
+}
+
+/**
+ * @brief Gets the number of rows whose date could not be parsed.
+ * @return The count of rows with a non-empty date stored as InvalidDate.
+ */
+qsizetype TransactionStore::unparsedDateCount() const {
+    return unparsedDates.size();
+}
+
+/**
+ * @brief Parses a yyyy-MM-dd date into a Julian day number without allocating.
+ * @param date The date text.
+ * @return The day number, or InvalidDate if the text is not a valid date.
+ */
+qint32 TransactionStore::parseDate(QByteArrayView date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') {
+        return InvalidDate;
+    }
+
+    // Reads a run of ASCII digits into an int, -1 if any character is not a digit
+    auto digits = [&date](int from, int count) {
+        int value = 0;
+        for (int i = from; i < from + count; ++i) {
+            if (date[i] < '0' || date[i] > '9') {
+                return -1;
+            }
+            value = value * 10 + (date[i] - '0');
+        }
+        return value;
+    };
+
+    int year = digits(0, 4);
+    int month = digits(5, 2);
+    int day = digits(8, 2);
+    QDate parsed(year, month, day); // Invalid if any part was rejected or out of range
+    if (year < 0 || !parsed.isValid()) {
+        return InvalidDate;
+    }
+    return static_cast<qint32>(parsed.toJulianDay());
+}
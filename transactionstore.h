@@ -0,0 +1,191 @@
+#ifndef TRANSACTIONSTORE_H
+#define TRANSACTIONSTORE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <limits>
+#include "money.h"
+
+/**
+ * @class StringDictionary
+ * @brief Interns repeated strings and hands out small integer codes for them.
+ *
+ * Every distinct value gets the next free code (0, 1, 2, ...), so the codes can be
+ * used directly as indexes into per-value arrays. Looking up a value that is
+ * already interned does not allocate.
+ */
+class StringDictionary {
+public:
+    static constexpr quint32 NotFound = std::numeric_limits<quint32>::max(); // Returned by find() for unknown values.
+
+    /**
+     * @brief Gets the code of a value, adding it to the dictionary if needed.
+     * @param value The raw UTF-8 bytes of the value.
+     * @return The code of the value.
+     */
+    quint32 intern(QByteArrayView value);
+
+    /**
+     * @brief Gets the code of a value without adding it.
+     * @param value The raw UTF-8 bytes of the value.
+     * @return The code of the value, or NotFound if it was never interned.
+     */
+    quint32 find(QByteArrayView value) const;
+
+    /**
+     * @brief Gets the value stored for a code.
+     * @param code A code returned by intern().
+     * @return The decoded value.
+     */
+    QString value(quint32 code) const;
+
+    /**
+     * @brief Gets the number of distinct values.
+     * @return The dictionary size; valid codes are 0 to size() - 1.
+     */
+    int size() const;
+
+    /**
+     * @brief Removes every value from the dictionary.
+     */
+    void clear();
+
+private:
+    QHash<QByteArray, quint32> codes; // Raw value -> code.
+    QVector<QString> values;          // Code -> decoded value.
+};
+
+/**
+ * @class TransactionStore
+ * @brief Columnar (struct-of-arrays) storage for financial transactions.
+ *
+ * Instead of one object with seven strings per transaction, each field lives in
+ * its own contiguous column:
+ * - dates are packed into Julian day numbers,
+ * - type, category and payment method are dictionary-encoded integer codes,
+ * - amounts sit in a plain array of 64-bit cents,
+ * - transaction IDs and descriptions share a single byte heap.
+ *
+ * Dates that are not yyyy-MM-dd are stored as InvalidDate, and their original
+ * text is kept on the side, so such rows still show the date they were given.
+ *
+ * Aggregations can then walk the integer columns directly, without
+ * touching any strings.
+ */
+class TransactionStore {
+public:
+    static constexpr qint32 InvalidDate = std::numeric_limits<qint32>::min(); // Day number stored for unparsable dates.
+
+    /**
+     * @brief Appends one transaction to the store.
+     *
+     * The views are copied into the columns, they do not need to outlive the call.
+     *
+     * @param date The date of the transaction (yyyy-MM-dd).
+     * @param transactionID The unique ID of the transaction.
+     * @param type The type of the transaction (e.g. "Income" or "Expense").
+     * @param description A description of the transaction.
+     * @param amount The amount of the transaction.
+     * @param paymentMethod The payment method used for the transaction.
+     * @param category The category of the transaction.
+     */
+    void append(QByteArrayView date, QByteArrayView transactionID, QByteArrayView type,
+        QByteArrayView description, Money amount, QByteArrayView paymentMethod, QByteArrayView category);
+
+    /**
+     * @brief Appends every transaction of another store, keeping their order.
+     *
+     * The other store has its own dictionaries, so its codes are translated into
+     * this store's codes once per distinct value rather than once per row.
+     *
+     * @param other The store to copy the transactions from.
+     */
+    void append(const TransactionStore& other);
+
+    /**
+     * @brief Reserves room for a number of transactions in every column.
+     * @param rows The expected number of transactions.
+     */
+    void reserve(qsizetype rows);
+
+    /**
+     * @brief Removes all transactions and dictionary values.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of stored transactions.
+     * @return The row count.
+     */
+    qsizetype size() const;
+
+    /**
+     * @brief Checks whether the store holds no transactions.
+     * @return True if empty, false otherwise.
+     */
+    bool isEmpty() const;
+
+    // Column accessors, one entry per row
+    const QVector<qint32>& dateColumn() const;           ///< Julian day numbers, InvalidDate if unparsable.
+    const QVector<quint32>& typeColumn() const;          ///< Codes into types().
+    const QVector<quint32>& categoryColumn() const;      ///< Codes into categories().
+    const QVector<quint32>& paymentMethodColumn() const; ///< Codes into paymentMethods().
+    const QVector<std::int64_t>& amountColumn() const;   ///< Transaction amounts in cents.
+
+    // Dictionaries for the encoded columns
+    const StringDictionary& types() const;          ///< Transaction type values.
+    const StringDictionary& categories() const;     ///< Category values.
+    const StringDictionary& paymentMethods() const; ///< Payment method values.
+
+    /**
+     * @brief Gets the transaction ID of a row.
+     * @param row The row index.
+     * @return A view into the string heap, valid until the store is modified.
+     */
+    QByteArrayView transactionID(qsizetype row) const;
+
+    /**
+     * @brief Gets the description of a row.
+     * @param row The row index.
+     * @return A view into the string heap, valid until the store is modified.
+     */
+    QByteArrayView description(qsizetype row) const;
+
+    /**
+     * @brief Gets the original text of a date that could not be parsed.
+     * @param row The row index.
+     * @return The date as it was appended, empty if the row has a valid or empty date.
+     */
+    QByteArray unparsedDate(qsizetype row) const;
+
+    /**
+     * @brief Gets the number of rows whose date could not be parsed.
+     * @return The count of rows with a non-empty date stored as InvalidDate.
+     */
+    qsizetype unparsedDateCount() const;
+
+    /**
+     * @brief Parses a yyyy-MM-dd date into a Julian day number without allocating.
+     * @param date The date text.
+     * @return The day number, or InvalidDate if the text is not a valid date.
+     */
+    static qint32 parseDate(QByteArrayView date);
+
+private:
+    QVector<qint32> dates;           // Packed day numbers.
+    QVector<quint32> typeCodes;      // Dictionary codes of the transaction types.
+    QVector<quint32> categoryCodes;  // Dictionary codes of the categories.
+    QVector<quint32> paymentCodes;   // Dictionary codes of the payment methods.
+    QVector<std::int64_t> amounts;   // Transaction amounts in cents.
+    QByteArray textHeap;             // Transaction IDs and descriptions, back to back.
+    QVector<qint64> textOffsets;     // Per row: start of the ID, start of the description.
+    QHash<qsizetype, QByteArray> unparsedDates; // Row -> original text, only for dates that did not parse.
+    StringDictionary typeDictionary;
+    StringDictionary categoryDictionary;
+    StringDictionary paymentDictionary;
+};
+
+#endif // TRANSACTIONSTORE_H
@@ -51,16 +51,4 @@ QString User::getRole() {
  */
 bool User::login() {
     return !userID.isEmpty(); // return true if there is valid user id and false otherwise
-}
-
-/**
- * @brief Logs out the current user.
- *
- * This method clears the user ID to indicate that no user is logged in.
- * After calling this method, the user will have an empty ID and subsequent
- * calls to login() will return false.
- *
- */
-void User::logout() {
-    userID = ""; // set empty user id
 }
\ No newline at end of file
@@ -7,8 +7,9 @@
  * @brief The User class represents a system user with authentication capabilities.
  *
  * This class encapsulates user information including user ID and role.
- * It provides basic functionality for user authentication such as login and logout
- * operations, as well as accessor methods for retrieving user properties.
+ * It provides a basic login check, as well as accessor methods for retrieving user
+ * properties. Logged in clients are tracked as sessions by the SessionManager, so
+ * a User is never changed by logging in or out.
  *
  * @author Simran Kullar
  */
@@ -62,14 +63,6 @@ public:
      *
      */
     bool login();
-
-    /**
-     * @brief Logs out the current user.
-     *
-     * Clears the user ID to indicate that no user is logged in.
-     *
-     */
-    void logout();
 };
 
 #endif // USER_H
\ No newline at end of file
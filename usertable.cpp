@@ -0,0 +1,214 @@
+#include "usertable.h"
+#include <QAnyStringView>
+#include <QDebug>
+#include <QStringEncoder>
+#include <QUtf8StringView>
+#include <QVarLengthArray>
+#include <cstring>
+
+/**
+ * @class usertable.cpp
+ * @brief Implements the open-addressed table of user accounts.
+ */
+
+namespace {
+
+    const qsizetype InitialCapacity = 64;   // Slots of a new table, a power of two.
+    const size_t HashSeed = 0x2545f491;     // AuthenticateSystem picks shards by the unseeded qHash of the ID; a
+                                            // different seed keeps the slots of one shard's table spread out.
+
+}
+
+/**
+ * @brief Creates an empty table.
+ */
+UserTable::UserTable() : buckets(InitialCapacity) {
+}
+
+/**
+ * @brief Adds a user.
+ *
+ * The table grows to twice its size before it is three quarters full, which
+ * keeps probe sequences short.
+ *
+ * @param userID The ID of the user.
+ * @param role The role of the user.
+ * @return True if the user was added, false if the ID was already there or there are too many roles.
+ */
+bool UserTable::insert(const QString& userID, const QString& role) {
+    const quint32 hash = hashOf(userID);
+    if (buckets[probe(userID, hash)].role != EmptySlot) {
+        return false; // Already registered
+    }
+
+    // Intern the role, most accounts share one of a handful of names
+    auto roleIt = roleIds.constFind(role);
+    if (roleIt == roleIds.constEnd()) {
+        if (roleNames.size() >= MaxRoles) {
+            qDebug() << "Error: Too many distinct roles, cannot add user" << userID;
+            return false;
+        }
+        roleIt = roleIds.insert(role, static_cast<quint16>(roleNames.size()));
+        roleNames.append(role);
+    }
+
+    if ((used + 1) * 4 > buckets.size() * 3) {
+        rehash(buckets.size() * 2);
+    }
+
+    // Encode on the stack; only IDs longer than the buffer, which go to longIds anyway, need the heap
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    QVarLengthArray<char, 64> id(encoder.requiredSpace(userID.size()));
+    id.resize(encoder.appendToBuffer(id.data(), userID) - id.data());
+
+    Slot& slot = buckets[probe(userID, hash)];
+    slot.hash = hash;
+    slot.role = roleIt.value();
+    if (id.size() <= InlineIdBytes) {
+        slot.idLength = static_cast<quint8>(id.size());
+        std::memcpy(slot.inlineId, id.constData(), id.size());
+    }
+    else {
+        slot.idLength = LongId;
+        slot.longId.offset = static_cast<quint32>(longIds.size());
+        slot.longId.length = static_cast<quint32>(id.size());
+        longIds.append(id.constData(), id.size());
+    }
+    used++;
+    return true;
+}
+
+/**
+ * @brief Checks whether a user is in the table.
+ * @param userID The ID of the user.
+ * @return True if the user is there.
+ */
+bool UserTable::contains(const QString& userID) const {
+    return find(userID);
+}
+
+/**
+ * @brief Looks a user up.
+ * @param userID The ID of the user.
+ * @param role Receives the role of the user, if not null.
+ * @return True if the user is there.
+ */
+bool UserTable::find(const QString& userID, QString* role) const {
+    const Slot& slot = buckets[probe(userID, hashOf(userID))];
+    if (slot.role == EmptySlot) {
+        return false;
+    }
+    if (role) {
+        *role = roleNames[slot.role]; // Implicitly shared, no copy of the characters
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the number of users.
+ * @return The user count.
+ */
+qsizetype UserTable::size() const {
+    return used;
+}
+
+/**
+ * @brief Makes room for a number of users, so adding them does not grow the table again.
+ * @param count The expected user count.
+ */
+void UserTable::reserve(qsizetype count) {
+    qsizetype capacity = buckets.size();
+    while (count * 4 > capacity * 3) {
+        capacity *= 2;
+    }
+    if (capacity != buckets.size()) {
+        rehash(capacity);
+    }
+}
+
+/**
+ * @brief Visits every user, in no particular order.
+ * @param visit Called with the ID and the role of each user.
+ */
+void UserTable::forEach(const std::function<void(const QString& userID, const QString& role)>& visit) const {
+    for (const Slot& slot : buckets) {
+        if (slot.role != EmptySlot) {
+            const QByteArrayView id = idOf(slot);
+            visit(QString::fromUtf8(id.data(), id.size()), roleNames[slot.role]);
+        }
+    }
+}
+
+/**
+ * @brief Hashes an ID.
+ * @param id The ID.
+ * @return The hash kept in its slot.
+ */
+quint32 UserTable::hashOf(QStringView id) {
+    const size_t hash = qHash(id, HashSeed);
+    return static_cast<quint32>(hash ^ (static_cast<quint64>(hash) >> 32));
+}
+
+/**
+ * @brief Gets the ID stored in a slot.
+ * @param slot A used slot.
+ * @return The UTF-8 ID.
+ */
+QByteArrayView UserTable::idOf(const Slot& slot) const {
+    if (slot.idLength != LongId) {
+        return QByteArrayView(slot.inlineId, slot.idLength);
+    }
+    return QByteArrayView(longIds.constData() + slot.longId.offset, slot.longId.length);
+}
+
+/**
+ * @brief Finds the slot of an ID, or the unused slot where it would go.
+ *
+ * Linear probing from the ID's home slot; the table always has unused slots,
+ * so the search ends. The stored UTF-8 is compared with the UTF-16 ID as it
+ * is, without converting either.
+ *
+ * @param id The ID.
+ * @param hash Its hash.
+ * @return The slot index.
+ */
+qsizetype UserTable::probe(QStringView id, quint32 hash) const {
+    const qsizetype mask = buckets.size() - 1;
+    qsizetype index = static_cast<qsizetype>(hash) & mask;
+    while (true) {
+        const Slot& slot = buckets[index];
+        if (slot.role == EmptySlot) {
+            return index;
+        }
+        if (slot.hash == hash) {
+            const QByteArrayView stored = idOf(slot);
+            if (QAnyStringView::equal(QUtf8StringView(stored.data(), stored.size()), id)) {
+                return index;
+            }
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+/**
+ * @brief Moves every used slot into a table of a new size.
+ *
+ * Only the slots move; long IDs stay where they are in longIds.
+ *
+ * @param capacity The new number of slots, a power of two.
+ */
+void UserTable::rehash(qsizetype capacity) {
+    QVector<Slot> old(capacity);
+    old.swap(buckets);
+    const qsizetype mask = capacity - 1;
+    for (const Slot& slot : old) {
+        if (slot.role == EmptySlot) {
+            continue;
+        }
+        qsizetype index = static_cast<qsizetype>(slot.hash) & mask;
+        while (buckets[index].role != EmptySlot) {
+            index = (index + 1) & mask; // Every ID is distinct, only an unused slot is needed
+        }
+        buckets[index] = slot;
+    }
+}
@@ -0,0 +1,143 @@
+#ifndef USERTABLE_H
+#define USERTABLE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <functional>
+
+/**
+ * @class UserTable
+ * @brief Compact in-memory table of user accounts: ID -> role.
+ *
+ * All accounts live in one contiguous array of 32-byte slots, an open-addressed
+ * hash table with linear probing, so finding a user touches one or two adjacent
+ * cache lines instead of following pointers to separately allocated nodes and
+ * strings.
+ *
+ * - IDs are kept as UTF-8. One of up to InlineIdBytes bytes, which is almost
+ *   every ID, is stored inside its slot; longer ones are appended to a single
+ *   shared buffer and the slot keeps their offset and length.
+ * - Roles are interned: every distinct role name is stored once and a slot only
+ *   holds its 16-bit number.
+ * - Each slot keeps the 32-bit hash of its ID, so a probe compares IDs only when
+ *   their hashes match. The hash is taken of the UTF-16 ID, and a lookup compares
+ *   it with the stored UTF-8 directly, so finding a user converts and allocates
+ *   nothing. Only insert() encodes the ID, into a buffer on the stack.
+ *
+ * Accounts are never removed, so the table needs no tombstones. It is not
+ * thread-safe; AuthenticateSystem keeps one table per shard, each guarded by
+ * the mutex of its shard.
+ */
+class UserTable {
+public:
+    static constexpr int InlineIdBytes = 24;        ///< Longest UTF-8 ID stored inside its slot.
+    static constexpr int MaxRoles = 0xFFFE;         ///< Most distinct role names.
+
+    /**
+     * @brief Creates an empty table.
+     */
+    UserTable();
+
+    /**
+     * @brief Adds a user.
+     * @param userID The ID of the user.
+     * @param role The role of the user.
+     * @return True if the user was added, false if the ID was already there or there are too many roles.
+     */
+    bool insert(const QString& userID, const QString& role);
+
+    /**
+     * @brief Checks whether a user is in the table.
+     * @param userID The ID of the user.
+     * @return True if the user is there.
+     */
+    bool contains(const QString& userID) const;
+
+    /**
+     * @brief Looks a user up.
+     * @param userID The ID of the user.
+     * @param role Receives the role of the user, if not null.
+     * @return True if the user is there.
+     */
+    bool find(const QString& userID, QString* role = nullptr) const;
+
+    /**
+     * @brief Gets the number of users.
+     * @return The user count.
+     */
+    qsizetype size() const;
+
+    /**
+     * @brief Makes room for a number of users, so adding them does not grow the table again.
+     * @param count The expected user count.
+     */
+    void reserve(qsizetype count);
+
+    /**
+     * @brief Visits every user, in no particular order.
+     * @param visit Called with the ID and the role of each user.
+     */
+    void forEach(const std::function<void(const QString& userID, const QString& role)>& visit) const;
+
+private:
+    static constexpr quint16 EmptySlot = 0xFFFF;    // Role number of an unused slot.
+    static constexpr quint8 LongId = 0xFF;          // idLength of an ID kept in longIds.
+
+    /**
+     * @brief One account, or an unused slot.
+     */
+    struct Slot {
+        quint32 hash = 0;               // Hash of the ID.
+        quint16 role = EmptySlot;       // Interned role number, EmptySlot if unused.
+        quint8 idLength = 0;            // Length of an inline ID, LongId otherwise.
+        quint8 reserved = 0;            // Padding, keeps the slot at 32 bytes.
+        union {
+            char inlineId[InlineIdBytes];   // The ID when it fits.
+            struct {
+                quint32 offset;             // Start of the ID in longIds.
+                quint32 length;             // Length of the ID.
+            } longId;
+        };
+    };
+    static_assert(sizeof(Slot) == 32, "A slot should take half a cache line");
+
+    /**
+     * @brief Hashes an ID.
+     * @param id The ID.
+     * @return The hash kept in its slot.
+     */
+    static quint32 hashOf(QStringView id);
+
+    /**
+     * @brief Gets the ID stored in a slot.
+     * @param slot A used slot.
+     * @return The UTF-8 ID.
+     */
+    QByteArrayView idOf(const Slot& slot) const;
+
+    /**
+     * @brief Finds the slot of an ID, or the unused slot where it would go.
+     * @param id The ID.
+     * @param hash Its hash.
+     * @return The slot index.
+     */
+    qsizetype probe(QStringView id, quint32 hash) const;
+
+    /**
+     * @brief Moves every used slot into a table of a new size.
+     * @param capacity The new number of slots, a power of two.
+     */
+    void rehash(qsizetype capacity);
+
+    QVector<Slot> buckets;              // The table, its size a power of two.
+    qsizetype used = 0;                 // Used slots.
+    QByteArray longIds;                 // IDs too long to fit in their slot, back to back.
+    QVector<QString> roleNames;         // Role number -> name.
+    QHash<QString, quint16> roleIds;    // Role name -> number.
+};
+
+#endif // USERTABLE_H